@@ -0,0 +1,201 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_ADAPTIVE_MUTEX_
+#define MINLIB_ESP32_ADAPTIVE_MUTEX_
+
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "lock.hpp"
+#include "error.hpp"
+#include "atomic.hpp"
+#include "excp/lock_exptions.hpp"
+#include "lock_profiler.hpp"
+
+namespace mofw {
+  /**
+   *  A mutex that spins before it blocks.
+   *
+   *  The state is one atomic word: unlocked, locked or locked with waiters. An uncontended
+   *  lock and unlock is a single compare exchange or exchange, no FreeRTOS call. A
+   *  contended lock spins with exponential backoff (only on multi core targets, a spinning
+   *  task can not see a release on a single core) and then blocks on a binary semaphore,
+   *  unlock gives the semaphore only when a task waits.
+   *
+   *  The spin limit adapts to the lock: it follows the average spin time of the last locks,
+   *  with MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN_MAX as the upper bound. A lock that is held
+   *  long drops to blocking soon, a lock with short critical sections is nearly always
+   *  taken in the spin phase.
+   *
+   *  These objects are not recursively acquirable and have no priority inheritance,
+   *  use basic_mutex for locks between tasks of different priority with long hold times.
+   *
+   * @ingroup mutex
+   * @ingroup lock
+   */
+  class basic_adaptive_mutex : public ILockObject {
+    enum : uint32_t {
+      state_unlocked = 0,   /*!< Not locked */
+      state_locked = 1,     /*!< Locked, no task is blocked */
+      state_contended = 2   /*!< Locked, maybe tasks are blocked on the semaphore */
+    };
+  public:
+    /**
+     * Create the mutex
+     *
+     * @note When enabled the config item MN_THREAD_CONFIG_USE_LOCK_CREATE then throw on error
+     * the lockcreate_exception exceptions.
+     */
+    basic_adaptive_mutex();
+    /**
+     * Destrutor - destroy the mutex
+     */
+    virtual ~basic_adaptive_mutex();
+
+    basic_adaptive_mutex(const basic_adaptive_mutex&) = delete;
+    basic_adaptive_mutex& operator=(const basic_adaptive_mutex&) = delete;
+
+    /**
+     *  Lock the Mutex.
+     *
+     *  @param timeout How long to wait to get the Lock until giving up, in ticks.
+     *  0 tries only once and does not spin.
+     *  @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+     */
+    virtual int lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      BaseType_t _ret = m_lockProbe.take(this, timeout, [this](TickType_t ticks) {
+        return (lock_impl(ticks) == ERR_MUTEX_OK) ? pdTRUE : pdFALSE; });
+
+      return (_ret == pdTRUE) ? ERR_MUTEX_OK : ERR_MUTEX_LOCK;
+    #else
+      return lock_impl(timeout);
+    #endif
+    }
+
+    /**
+     *  Lock the Mutex.
+     *
+     *  @param timeout The absolute time, how long to wait to get the Lock until giving up.
+     *  @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+     */
+    virtual int time_lock(const struct timespec *timeout);
+
+    /**
+     *  Unlock the Mutex.
+     *
+     *  @return ERR_MUTEX_OK if the Lock was released, ERR_MUTEX_UNLOCK if it was not locked.
+     */
+    virtual int unlock() {
+      uint32_t _state = m_uiState.exchange(state_unlocked, memory_order::Release);
+
+      if(_state == state_contended) wake();
+
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      if(_state != state_unlocked) m_lockProbe.released();
+    #endif
+
+      return (_state == state_unlocked) ? ERR_MUTEX_UNLOCK : ERR_MUTEX_OK;
+    }
+
+    /**
+     * Try to lock the mutex, without spinning
+     *
+     * @return true if the Lock was acquired, false when not
+     */
+    virtual bool try_lock() { return lock(0) == ERR_MUTEX_OK; }
+
+    virtual bool is_initialized() const { return m_pSemaphore != NULL; }
+
+    /**
+     * Get the error code on creating
+     * @return The error code, ERR_MUTEX_OK when no error
+     */
+    int   get_error()                       { return m_iCreateErrorCode; }
+
+    /**
+     * @brief Is locked?
+     * @return True if locked and false when not.
+     */
+    virtual bool is_locked() const { return m_uiState.load(memory_order::Relaxed) != state_unlocked; }
+
+    /**
+     * Get the current spin limit, in cpu_relax calls
+     */
+    uint32_t get_spin_limit() const;
+
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      /**
+       * Set the name of this lock in the basic_lock_profiler
+       */
+      void set_profile_name(const char* name) { m_lockProbe.set_name(this, name); }
+    #endif
+  protected:
+    /** Set the error codes @param error The error code */
+    void  set_error(int error)              { m_iCreateErrorCode = error; }
+  private:
+    int lock_impl(unsigned int timeout) {
+      uint32_t _expected = state_unlocked;
+
+      if(m_uiState.compare_exchange_strong(_expected, state_locked, memory_order::Acquire))
+        return ERR_MUTEX_OK;
+
+      return (timeout == 0) ? ERR_MUTEX_LOCK : lock_slow(timeout);
+    }
+
+    /**
+     * The contended path: spin and then block
+     */
+    int lock_slow(unsigned int timeout);
+    /**
+     * Wake up one blocked task
+     */
+    void wake();
+  private:
+    atomic_uint32_t m_uiState;
+    /**
+     * The average spin time of the last locks (an estimate, updated without lock)
+     */
+    volatile uint32_t m_uiSpinAverage;
+    /**
+     * The FreeRTOS binary semaphore, the blocked tasks wait on it
+     */
+    void* m_pSemaphore;
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+      StaticSemaphore_t m_SemaphoreBasicBuffer;
+    #endif
+
+    /**
+     * A saved / cached copy of error code on creating
+     */
+    int m_iCreateErrorCode;
+
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      basic_lock_probe m_lockProbe;
+    #endif
+  };
+
+  using adaptive_mutex_t = basic_adaptive_mutex;
+  using adaptive_mutex = basic_adaptive_mutex;
+}
+
+#endif
@@ -95,7 +95,7 @@ namespace mofw {
 			 * @param alignment
 			 * @return Pointer to new memory, or NULL if allocation fails.
 			 */
-			pointer allocate(size_t count, size_t size, size_t alignment = 0) {
+			pointer allocate(size_t count, size_t size, size_t alignment) {
 				return allocate(count * size, (alignment == 0) ? mofw::alignment_for(size) : alignment);
 			}
 
@@ -174,6 +174,14 @@ namespace mofw {
 				return TAllocator::get_max_alocator_size();
 			}
 
+			/**
+			 * @brief Get the filter of this allocator, to read the counters of the filter.
+			 * @return The filter of this allocator.
+			 */
+			const filter_type& get_filter() const noexcept {
+				return m_fFilter;
+			}
+
 		private:
 			filter_type m_fFilter;
 		};
@@ -0,0 +1,337 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_BASIC_ALLOCATOR_SLAB_H__
+#define __MINILIB_BASIC_ALLOCATOR_SLAB_H__
+
+#include "../config.hpp"
+
+#include <stdlib.h>
+
+#include "basic_allocator.hpp"
+#include "allocator_typetraits.hpp"
+
+#include "../utils/nlz.hpp"
+
+namespace mofw {
+	namespace memory {
+		namespace internal {
+			/**
+			 * @brief The start offsets of the slab class regions, offset[TCLASSES] is the arena size.
+			 * The region of class n holds TBLOCKS blocks of (TMINSIZE << n) bytes and is rounded
+			 * up to a 64 byte boundary.
+			 */
+			template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+			struct slab_offset_table {
+				size_t offset[TCLASSES + 1];
+
+				constexpr slab_offset_table() noexcept : offset() {
+					for(size_t i = 0; i < TCLASSES; i++)
+						offset[i + 1] = offset[i] + (((TBLOCKS * (TMINSIZE << i)) + 63) & ~size_t(63));
+				}
+			};
+		}
+
+		/**
+		 * @brief A size-class slab allocator impl.
+		 *
+		 * The slab owns a static arena that is split into TCLASSES size classes. The block size
+		 * of the class n is (TMINSIZE << n), each class holds TBLOCKS blocks and a singly linked
+		 * free list threaded through the free blocks. The region of a class is only as big as
+		 * his TBLOCKS blocks, the region start offsets are precomputed in a constexpr table.
+		 * Allocate is O(1): the class is computed from the size and the head of the free list
+		 * is popped, deallocate finds the class with a short scan of the offset table.
+		 * Requests larger than the biggest class, with a alignment over 64, or when the class
+		 * is exhausted, are forwarded to malloc() (posix_memalign() for over-aligned requests)
+		 * and counted as fallback.
+		 *
+		 * @tparam TBLOCKS  The number of blocks per size class.
+		 * @tparam TMINSIZE The block size of the smallest class, must be a power of two and >= sizeof(void*).
+		 * @tparam TCLASSES The number of size classes.
+		 *
+		 * @note This impl is not thread safe, use basic_threadsafed_allocator to share it
+		 * between tasks.
+		 */
+		template <size_t TBLOCKS = 32, size_t TMINSIZE = 8, size_t TCLASSES = 6>
+		class basic_allocator_slab_impl {
+			static_assert(TMINSIZE >= sizeof(void*), "TMINSIZE must hold a free list pointer");
+			static_assert((TMINSIZE & (TMINSIZE - 1)) == 0, "TMINSIZE must be a power of two");
+			static_assert(TCLASSES > 0, "TCLASSES must be greater then zero");
+
+			struct free_block {
+				free_block* next;
+			};
+		public:
+			using allocator_category = std_allocator_tag();
+			using is_thread_safe = mofw::false_type  ;
+			using self_type = basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>;
+			using offset_table = internal::slab_offset_table<TBLOCKS, TMINSIZE, TCLASSES>;
+
+			/// The number of size classes
+			static constexpr size_t class_count = TCLASSES;
+			/// The number of blocks in each size class
+			static constexpr size_t blocks_per_class = TBLOCKS;
+			/// The block size of the biggest class
+			static constexpr size_t max_block_size = TMINSIZE << (TCLASSES - 1);
+			/// The region start offsets, every region start at a 64 byte boundary so the blocks are self aligned
+			static constexpr offset_table class_offsets = offset_table();
+			/// The bytes of the arena, the sum of all class regions
+			static constexpr size_t arena_bytes = class_offsets.offset[TCLASSES];
+
+			/**
+			 * @brief Build the free lists, only the first call do anything.
+			 */
+			static void first() noexcept {
+				if(m_bInit) return;
+
+				for(size_t _class = 0; _class < TCLASSES; _class++) {
+					unsigned char* _base = get_class_base(_class);
+					size_t _bsize = block_size(_class);
+
+					m_pFree[_class] = nullptr;
+					m_uiUsed[_class] = 0;
+					m_uiPeak[_class] = 0;
+
+					for(size_t i = TBLOCKS; i > 0; i--) {
+						free_block* _block = reinterpret_cast<free_block*>(_base + (i - 1) * _bsize);
+						_block->next = m_pFree[_class];
+						m_pFree[_class] = _block;
+					}
+				}
+				m_uiFallback = 0;
+				m_bInit = true;
+			}
+
+			/**
+			 * @brief Allocate a block from the matching size class.
+			 * @param size		Size of desired buffer.
+			 * @param alignment	The wanted alignment, a block of size n is aligned to min(n, 64).
+			 * @return Pointer to new memory, or NULL if allocation fails.
+			 */
+			static void* allocate(size_t size, size_t alignment) noexcept {
+				size_t _class = class_index(size < alignment ? alignment : size);
+				void* _mem = nullptr;
+
+				if(alignment > 64) _class = TCLASSES;
+
+				if(_class < TCLASSES && m_pFree[_class] != nullptr) {
+					free_block* _block = m_pFree[_class];
+					m_pFree[_class] = _block->next;
+
+					if(++m_uiUsed[_class] > m_uiPeak[_class])
+						m_uiPeak[_class] = m_uiUsed[_class];
+
+					_mem = _block;
+					m_bLastArena = true;
+				} else {
+					m_uiFallback++;
+					m_bLastArena = false;
+
+					if(alignment > sizeof(void*)) {
+						if(posix_memalign(&_mem, alignment, size) != 0)
+							_mem = nullptr;
+					} else {
+						_mem = malloc(size);
+					}
+				}
+				return _mem;
+			}
+
+			/**
+			 * @brief Give a block back to his size class, memory not from the arena is free()'d.
+			 * @param ptr The address to free.
+			 * @param size The size of the allocation.
+			 * @param alignment The alignment of the allocation.
+			 */
+			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+
+				m_bLastArena = (ptr != nullptr) && is_owner(ptr);
+
+				if(ptr == nullptr) return;
+
+				if(!m_bLastArena) {
+					free(ptr);
+				} else {
+					size_t _offset = static_cast<unsigned char*>(ptr) - &m_aArena[0];
+					size_t _class = 0;
+
+					while(_offset >= class_offsets.offset[_class + 1]) _class++;
+
+					free_block* _block = static_cast<free_block*>(ptr);
+					_block->next = m_pFree[_class];
+					m_pFree[_class] = _block;
+
+					m_uiUsed[_class]--;
+				}
+			}
+
+			/**
+			 * @brief Get the size class for a given size.
+			 * @return The index of the class, or TCLASSES if the size is to big for the slab.
+			 */
+			static size_t class_index(size_t size) noexcept {
+				size_t _class = 0;
+
+				if(size > TMINSIZE) {
+					_class = mofw::nlz_base(size - 1) - mofw::nlz_base(TMINSIZE - 1);
+				}
+				return (_class < TCLASSES) ? _class : TCLASSES;
+			}
+
+			/**
+			 * @brief Get the block size of the given class.
+			 */
+			static constexpr size_t block_size(size_t _class) noexcept {
+				return TMINSIZE << _class;
+			}
+
+			/**
+			 * @brief Is the given address a part of the slab arena.
+			 */
+			static bool is_owner(const void* ptr) noexcept {
+				const unsigned char* _ptr = static_cast<const unsigned char*>(ptr);
+				return (_ptr >= &m_aArena[0]) && (_ptr < &m_aArena[0] + sizeof(m_aArena));
+			}
+
+			/// Get the number of used blocks in the given class.
+			static size_t get_used(size_t _class) noexcept 	{ return m_uiUsed[_class]; }
+			/// Get the high-water mark of used blocks in the given class.
+			static size_t get_peak(size_t _class) noexcept 	{ return m_uiPeak[_class]; }
+			/// Get the number of free blocks in the given class.
+			static size_t get_free(size_t _class) noexcept 	{ return TBLOCKS - m_uiUsed[_class]; }
+			/// Get the number of allocations that are forwarded to malloc.
+			static size_t get_fallback() noexcept 			{ return m_uiFallback; }
+			/// Was the last allocate or deallocate served by the arena, false when by the heap.
+			static bool last_from_arena() noexcept 			{ return m_bLastArena; }
+
+			static size_t max_node_size() noexcept {
+				return max_block_size;
+			}
+			static size_t get_max_alocator_size() noexcept {
+				return sizeof(m_aArena);
+			}
+		private:
+			static unsigned char* get_class_base(size_t _class) noexcept {
+				return &m_aArena[0] + class_offsets.offset[_class];
+			}
+		private:
+			static bool 			m_bInit;
+			static free_block* 		m_pFree[TCLASSES];
+			static size_t 			m_uiUsed[TCLASSES];
+			static size_t 			m_uiPeak[TCLASSES];
+			static size_t 			m_uiFallback;
+			static bool 			m_bLastArena;
+			static unsigned char 	m_aArena[arena_bytes] __attribute__ ((aligned (64)));
+		};
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		constexpr typename basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::offset_table
+			basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::class_offsets;
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		bool basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_bInit = false;
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		typename basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::free_block*
+			basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_pFree[TCLASSES];
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		size_t basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_uiUsed[TCLASSES];
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		size_t basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_uiPeak[TCLASSES];
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		size_t basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_uiFallback = 0;
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		bool basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_bLastArena = false;
+
+		template <size_t TBLOCKS, size_t TMINSIZE, size_t TCLASSES>
+		unsigned char basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::m_aArena[
+			basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>::arena_bytes];
+
+
+		/**
+		 * @brief A allocator filter that track the occupancy and the internal fragmentation of
+		 * a slab impl.
+		 *
+		 * The internal fragmentation is the number of bytes that are reserved from the
+		 * size classes but not requested by the caller. A allocation that the impl forwarded
+		 * to the heap is charged with the requested size. The allocator calls the filter
+		 * after the impl, so the filter ask the impl which path served the call.
+		 *
+		 * @tparam TSlabImpl The slab impl, a basic_allocator_slab_impl.
+		 */
+		template <class TSlabImpl>
+		class basic_allocator_slab_filter {
+		public:
+			basic_allocator_slab_filter() noexcept
+				: m_uiRequested(0), m_uiReserved(0), m_uiAllocs(0), m_uiDeallocs(0) { }
+
+			bool on_pre_alloc(size_t size, size_t alignment) { return true; }
+			bool on_pre_dealloc(size_t size, size_t alignment) { return true; }
+
+			void on_alloc(size_t size, size_t alignment) {
+				m_uiRequested += size;
+				m_uiReserved += get_reserved(size, alignment);
+				m_uiAllocs++;
+			}
+			void on_dealloc(size_t size, size_t alignment) {
+				m_uiRequested -= size;
+				m_uiReserved -= get_reserved(size, alignment);
+				m_uiDeallocs++;
+			}
+
+			/// Get the current requested bytes
+			size_t get_requested() const noexcept 	{ return m_uiRequested; }
+			/// Get the current reserved bytes, requested bytes rounded up to the block sizes
+			size_t get_reserved() const noexcept 	{ return m_uiReserved; }
+			/// Get the internal fragmentation in bytes
+			size_t get_fragmentation() const noexcept { return m_uiReserved - m_uiRequested; }
+			/// Get the number of allocate calls
+			size_t get_allocs() const noexcept 		{ return m_uiAllocs; }
+			/// Get the number of deallocate calls
+			size_t get_deallocs() const noexcept 	{ return m_uiDeallocs; }
+
+			/**
+			 * @brief Get the occupancy of the given class in percent.
+			 */
+			size_t get_occupancy(size_t _class) const noexcept {
+				return (TSlabImpl::get_used(_class) * 100) / TSlabImpl::blocks_per_class;
+			}
+		private:
+			size_t get_reserved(size_t size, size_t alignment) const noexcept {
+				size_t _class = TSlabImpl::class_index(size < alignment ? alignment : size);
+				return TSlabImpl::last_from_arena() ? TSlabImpl::block_size(_class) : size;
+			}
+		private:
+			size_t m_uiRequested;
+			size_t m_uiReserved;
+			size_t m_uiAllocs;
+			size_t m_uiDeallocs;
+		};
+
+		template <size_t TBLOCKS = 32, size_t TMINSIZE = 8, size_t TCLASSES = 6,
+				  class TFilter = basic_allocator_slab_filter<basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES> > >
+		using slab_allocator = basic_allocator<basic_allocator_slab_impl<TBLOCKS, TMINSIZE, TCLASSES>, TFilter>;
+	}
+}
+
+#endif // __MINILIB_BASIC_ALLOCATOR_SLAB_H__
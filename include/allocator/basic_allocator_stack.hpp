@@ -22,40 +22,313 @@
 
 #include "basic_allocator.hpp"
 #include "allocator_typetraits.hpp"
+#include "basic_malloc_allocator.hpp"
 
 namespace mofw {
 	namespace memory {
 
 		/**
-         * @brief Stack based allocator.
-         * @note - operates on buffer of TBUFFERSIZE bytes of stack memory
-         * @note - never frees memory
-         * @note - cannot be copied
+		 * @brief A upstream impl for basic_stack_arena that never give memory, the arena
+		 * then returns nullptr on overflow.
+		 */
+		class basic_arena_null_upstream {
+		public:
+			static void* allocate(size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+				return nullptr;
+			}
+			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(ptr);
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+			}
+		};
+
+		/**
+		 * @brief A marker of a basic_stack_arena, to rewind the arena to this position.
+		 */
+		struct basic_arena_marker {
+			void* 	chunk;
+			size_t 	offset;
+		};
+
+		/**
+		 * @brief A instance based monotonic arena.
+		 *
+		 * Memory is bumped from a inline buffer of TBUFFERSIZE bytes, deallocate do nothing.
+		 * All memory is given back in one step with reset(), or up to a marker with rewind().
+		 * When the buffer is full, the arena chains a new chunk from the TUpstream impl
+		 * (a allocator impl with static allocate/deallocate) and the chunks are given back
+		 * to the upstream on reset() or rewind().
+		 *
+		 * @tparam TBUFFERSIZE The size of the inline buffer in bytes.
+		 * @tparam TUpstream The upstream impl for overflow chunks, basic_arena_null_upstream for none.
+		 *
+		 * @note - cannot be copied, use basic_arena_allocator as handle for the containers
+		 * @note - not thread safe
+		 */
+		template <size_t TBUFFERSIZE, class TUpstream = basic_malloc_allocator_impl>
+		class basic_stack_arena {
+			struct arena_chunk {
+				arena_chunk* 	prev;
+				size_t 			size;
+			};
+		public:
+			using upstream_type = TUpstream;
+			using self_type = basic_stack_arena<TBUFFERSIZE, TUpstream>;
+			using marker_type = basic_arena_marker;
+
+			basic_stack_arena() noexcept
+				: m_pChunk(nullptr), m_sTop(0), m_sUpstream(0) { }
+
+			~basic_stack_arena() noexcept { reset(); }
+
+			/**
+			 * @brief Allocate a aligned buffer from the arena.
+			 * @param size		Size of desired buffer.
+			 * @param alignment	The alignment, must be a power of two; 0 use the default alignment.
+			 * @return Pointer to new memory, or NULL if the arena and the upstream are full.
+			 */
+			void* allocate(size_t size, size_t alignment) noexcept {
+				if(!mofw::is_aligvalid(alignment)) alignment = mofw::max_alignment;
+
+				void* _mem = bump(size, alignment);
+
+				if(_mem == nullptr && add_chunk(size, alignment)) {
+					_mem = bump(size, alignment);
+				}
+				return _mem;
+			}
+
+			/**
+			 * @brief Do nothing, the memory is given back with rewind() or reset().
+			 */
+			void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
+				MN_UNUSED_VARIABLE(ptr);
+				MN_UNUSED_VARIABLE(size);
+				MN_UNUSED_VARIABLE(alignment);
+			}
+
+			/**
+			 * @brief Get a marker of the current position.
+			 */
+			marker_type get_marker() const noexcept {
+				return marker_type{ m_pChunk, m_sTop };
+			}
+
+			/**
+			 * @brief Give all memory back that is allocated after the given marker was taken.
+			 * @param marker The marker from get_marker()
+			 */
+			void rewind(const marker_type& marker) noexcept {
+				while(m_pChunk != nullptr && m_pChunk != marker.chunk) {
+					arena_chunk* _chunk = m_pChunk;
+					m_pChunk = _chunk->prev;
+					m_sUpstream -= _chunk->size;
+
+					TUpstream::deallocate(_chunk, _chunk->size, mofw::max_alignment);
+				}
+				m_sTop = (m_pChunk == marker.chunk) ? marker.offset : get_capacity();
+			}
+
+			/**
+			 * @brief Give all memory back, the chunks from the upstream are freed.
+			 */
+			void reset() noexcept {
+				rewind(marker_type{ nullptr, 0 });
+			}
+
+			/**
+			 * @brief Get the used bytes of the current region (buffer or chunk)
+			 */
+			size_t get_used() const noexcept 		{ return m_sTop; }
+			/**
+			 * @brief Get the free bytes of the current region (buffer or chunk)
+			 */
+			size_t get_left() const noexcept 		{ return get_capacity() - m_sTop; }
+			/**
+			 * @brief Get the bytes that are currently borrowed from the upstream.
+			 */
+			size_t get_upstream() const noexcept 	{ return m_sUpstream; }
+
+			size_t get_max_alocator_size() const noexcept {
+				return TBUFFERSIZE;
+			}
+
+			basic_stack_arena(const self_type& other) = delete;
+			self_type& operator = (const self_type& other) = delete;
+		private:
+			unsigned char* get_base() noexcept {
+				return (m_pChunk == nullptr) ? &m_aBuffer[0]
+					: reinterpret_cast<unsigned char*>(m_pChunk) + sizeof(arena_chunk);
+			}
+			size_t get_capacity() const noexcept {
+				return (m_pChunk == nullptr) ? TBUFFERSIZE : m_pChunk->size - sizeof(arena_chunk);
+			}
+
+			void* bump(size_t size, size_t alignment) noexcept {
+				unsigned char* _base = get_base();
+				size_t _start = m_sTop + mofw::alig_offset(_base + m_sTop, alignment);
+				void* _mem = nullptr;
+
+				if(_start <= get_capacity() && size <= (get_capacity() - _start)) {
+					_mem = _base + _start;
+					m_sTop = _start + size;
+				}
+				return _mem;
+			}
+
+			bool add_chunk(size_t size, size_t alignment) noexcept {
+				size_t _size = (size + alignment > TBUFFERSIZE) ? (size + alignment) : TBUFFERSIZE;
+				_size += sizeof(arena_chunk);
+
+				arena_chunk* _chunk = static_cast<arena_chunk*>(TUpstream::allocate(_size, mofw::max_alignment));
+				if(_chunk == nullptr) return false;
+
+				_chunk->prev = m_pChunk;
+				_chunk->size = _size;
+
+				m_pChunk = _chunk;
+				m_sTop = 0;
+				m_sUpstream += _size;
+
+				return true;
+			}
+		private:
+			arena_chunk* 	m_pChunk;
+			size_t 			m_sTop;
+			size_t 			m_sUpstream;
+			unsigned char 	m_aBuffer[TBUFFERSIZE] __attribute__ ((aligned (16)));
+		};
+
+		/**
+		 * @brief A copyable handle of a basic_stack_arena with the interface of basic_allocator,
+		 * to use a arena in the containers.
+		 * @tparam TArena The type of the arena, a basic_stack_arena.
+		 */
+		template <class TArena>
+		class basic_arena_allocator {
+		public:
+			using allocator_category = nodeleter_allocator_tag;
+			using is_thread_safe = mofw::false_type ;
+			using arena_type = TArena;
+
+			using value_type = void;
+			using pointer = void*;
+			using const_pointer = const void*;
+			using difference_type = mofw::ptrdiff_t;
+			using size_type = size_t;
+
+			explicit basic_arena_allocator(arena_type& arena) noexcept
+				: m_pArena(&arena) { }
+
+			pointer allocate(size_t size, size_t alignment) {
+				return m_pArena->allocate(size, alignment);
+			}
+			pointer allocate(size_t size) {
+				return allocate(size, mofw::alignment_for(size));
+			}
+			pointer allocate(size_t count, size_t size, size_t alignment) {
+				return allocate(count * size, (alignment == 0) ? mofw::alignment_for(size) : alignment);
+			}
+
+			void deallocate(pointer address, size_t size, size_t alignment) noexcept {
+				m_pArena->deallocate(address, size, alignment);
+			}
+			void deallocate(pointer address, size_t size) noexcept {
+				deallocate(address, size, mofw::alignment_for(size));
+			}
+			void deallocate(pointer address, size_t count, size_t size, size_t alignment) noexcept {
+				deallocate(address, count * size, alignment);
+			}
+
+			template <class Type, typename... Args>
+			Type* construct(Args&&... args) {
+				void* _mem = allocate(sizeof(Type), alignof(Type));
+
+				return (_mem == nullptr) ? nullptr : ::new (_mem) Type(mofw::forward<Args>(args)...);
+			}
+
+			/**
+			 * @brief Call the deconstructor of the object, the memory is given back with the arena.
+			 */
+			template <class Type>
+			void destroy(Type* address) noexcept {
+				if(address == nullptr) return;
+				mofw::destruct<Type>(address);
+			}
+
+			size_t get_max_alocator_size() const noexcept {
+				return m_pArena->get_max_alocator_size();
+			}
+
+			/**
+			 * @brief Get the using arena
+			 */
+			arena_type& get_arena() noexcept { return *m_pArena; }
+		private:
+			arena_type* m_pArena;
+		};
+
+		/**
+		 * @brief Take a marker of a arena and rewind the arena to this marker on leaving the scope.
+		 * @code
+		 * basic_stack_arena<1024> arena;
+		 * {
+		 * 		basic_arena_scope<basic_stack_arena<1024> > scope(arena);
+		 * 		// allocate transient objects from arena
+		 * } // all allocations from the scope are given back
+		 * @endcode
+		 */
+		template <class TArena>
+		class basic_arena_scope {
+		public:
+			using arena_type = TArena;
+			using marker_type = typename TArena::marker_type;
+
+			explicit basic_arena_scope(arena_type& arena) noexcept
+				: m_refArena(arena), m_mMarker(arena.get_marker()) { }
+
+			~basic_arena_scope() noexcept { m_refArena.rewind(m_mMarker); }
+
+			basic_arena_scope(const basic_arena_scope& other) = delete;
+			basic_arena_scope& operator = (const basic_arena_scope& other) = delete;
+		private:
+			arena_type& 	m_refArena;
+			marker_type 	m_mMarker;
+		};
+
+		/**
+         * @brief Stack based allocator impl, a global arena for each TBUFFERSIZE.
+         * @note - operates on a static buffer of TBUFFERSIZE bytes
+         * @note - deallocate never frees memory, use reset() or rewind()
+         * @note - for independent arenas use basic_stack_arena
          *
          * @author RoseLeBlood
          * @date 2021.02.21
-         * @version 1.0
+         * @version 1.1
          */
         template <int TBUFFERSIZE>
 		class basic_allocator_stack_impl {
 		public:
-			using allocator_category = std_allocator_tag();
-			using is_thread_safe = std::false_type  ;
+			using allocator_category = nodeleter_allocator_tag;
+			using is_thread_safe = mofw::false_type  ;
+			using marker_type = size_t;
 
 			static void first() noexcept { }
 
 			static void* allocate(size_t size, size_t alignment) noexcept {
-				MN_UNUSED_VARIABLE(alignment);
+				if(!mofw::is_aligvalid(alignment)) alignment = mofw::max_alignment;
 
-				if(m_bufferTop < TBUFFERSIZE) {
-					if( (m_bufferTop+size) <= TBUFFERSIZE) {
-						char* ret = &m_aBuffer[0] + m_bufferTop;
-						m_bufferTop += size;
+				size_t _start = m_bufferTop + mofw::alig_offset(&m_aBuffer[0] + m_bufferTop, alignment);
+				void* _mem = nullptr;
 
-						return (void*)ret;
-					}
+				if(_start <= TBUFFERSIZE && size <= (TBUFFERSIZE - _start)) {
+					_mem = &m_aBuffer[0] + _start;
+					m_bufferTop = _start + size;
 				}
-				return nullptr;
+				return _mem;
 			}
 
 			static void deallocate(void* ptr, size_t size, size_t alignment) noexcept {
@@ -64,25 +337,37 @@ namespace mofw {
 				MN_UNUSED_VARIABLE(ptr);
 			}
 
+			/// Get a marker of the current position
+			static marker_type get_marker() noexcept 		{ return m_bufferTop; }
+			/// Give all memory back that is allocated after the marker was taken
+			static void rewind(marker_type marker) noexcept { if(marker < m_bufferTop) m_bufferTop = marker; }
+			/// Give all memory back
+			static void reset() noexcept 					{ m_bufferTop = 0; }
+
 			static size_t max_node_size()  {
-				return size_t(-1);
+				return TBUFFERSIZE;
 			}
 			static size_t get_max_alocator_size()  {
-				return __SIZE_MAX__;
+				return TBUFFERSIZE;
 			}
 		private:
            	static size_t          m_bufferTop;
-            static char*           m_aBuffer[TBUFFERSIZE];
+            static unsigned char   m_aBuffer[TBUFFERSIZE] __attribute__ ((aligned (16)));
 		};
 
 		template <int TBUFFERSIZE>
 		size_t basic_allocator_stack_impl<TBUFFERSIZE>::m_bufferTop = 0;
 		template <int TBUFFERSIZE>
-		char* basic_allocator_stack_impl<TBUFFERSIZE>::m_aBuffer[TBUFFERSIZE];
+		unsigned char basic_allocator_stack_impl<TBUFFERSIZE>::m_aBuffer[TBUFFERSIZE];
 
 		template <int TBUFFERSIZE, class TFilter = basic_allocator_filter>
 		using stack_allocator = basic_allocator<basic_allocator_stack_impl<TBUFFERSIZE>, TFilter>;
 
+		template <size_t TBUFFERSIZE, class TUpstream = basic_malloc_allocator_impl>
+		using stack_arena = basic_stack_arena<TBUFFERSIZE, TUpstream>;
+
+		template <size_t TBUFFERSIZE, class TUpstream = basic_malloc_allocator_impl>
+		using arena_allocator = basic_arena_allocator< basic_stack_arena<TBUFFERSIZE, TUpstream> >;
 	}
 }
 
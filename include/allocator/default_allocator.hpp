@@ -23,6 +23,7 @@
 #include "basic_malloc_allocator.hpp"
 #include "basic_new_allocaor.hpp"
 #include "basic_allocator_stack.hpp"
+#include "basic_allocator_slab.hpp"
 
 namespace mofw {
 	namespace memory {
@@ -39,7 +39,7 @@ namespace mofw {
 		template <class TMutex, class TAllocator, class TFilter = basic_allocator_filter>
 		class basic_threadsafed_allocator {
 		public:
-			using allocator_category = typename allocator::allocator_category ;
+			using allocator_category = typename TAllocator::allocator_category ;
 
 			using value_type = void;
 			using pointer = void*;
@@ -57,13 +57,13 @@ namespace mofw {
 
 
 			basic_threadsafed_allocator() noexcept
-				: m_lockObjct(), m_fFilter(), m_xTicksToWait(portMAX_DELAY) { allocator::first();  }
+				: m_lockObjct(), m_fFilter(), m_xTicksToWait(portMAX_DELAY) { allocator_impl::first();  }
 
 			basic_threadsafed_allocator(const lock_type& lckObject) noexcept
-				: m_lockObjct(lckObject), m_fFilter(), m_xTicksToWait(portMAX_DELAY)  { allocator::first();  }
+				: m_lockObjct(lckObject), m_fFilter(), m_xTicksToWait(portMAX_DELAY)  { allocator_impl::first();  }
 
 			basic_threadsafed_allocator(const lock_type& lckObject, const filter_type& _fFilter ) noexcept
-				: m_lockObjct(lckObject), m_fFilter(_fFilter), m_xTicksToWait(portMAX_DELAY)  { allocator::first();  }
+				: m_lockObjct(lckObject), m_fFilter(_fFilter), m_xTicksToWait(portMAX_DELAY)  { allocator_impl::first();  }
 
 			/**
 			 * @brief malloc() a buffer in a given TAllocator and cheak with the given TFilter
@@ -77,9 +77,9 @@ namespace mofw {
 
 				pointer _mem = nullptr;
 
-				if(m_fFilter.on_pre_alloc(size)) {
+				if(m_fFilter.on_pre_alloc(size, alignment)) {
 					_mem = allocator_impl::allocate(size, alignment);
-					m_fFilter.on_alloc(size);
+					m_fFilter.on_alloc(size, alignment);
 				}
 				return _mem;
 			}
@@ -101,7 +101,7 @@ namespace mofw {
 			 * @param alignment
 			 * @return Pointer to new memory, or NULL if allocation fails.
 			 */
-			pointer allocate(size_t count, size_t size, size_t alignment = 0) {
+			pointer allocate(size_t count, size_t size, size_t alignment) {
 				return allocate(count * size, (alignment == 0) ? mofw::alignment_for(size) : alignment);
 			}
 
@@ -114,9 +114,9 @@ namespace mofw {
 			void deallocate(pointer address, size_t size, size_t alignment) noexcept {
 				lock_guard lock(m_lockObjct, m_xTicksToWait);
 
-				if(m_fFilter.on_pre_dealloc(size)) {
+				if(m_fFilter.on_pre_dealloc(size, alignment)) {
 					allocator_impl::deallocate(address, size, alignment);
-					m_fFilter.on_dealloc(size);
+					m_fFilter.on_dealloc(size, alignment);
 				}
 			}
 
@@ -140,9 +140,9 @@ namespace mofw {
 				lock_guard lock(m_lockObjct, m_xTicksToWait);
 
 				size = size * count;
-				if(m_fFilter.on_pre_dealloc(size)) {
+				if(m_fFilter.on_pre_dealloc(size, alignment)) {
 					allocator_impl::deallocate(address, size, (alignment == 0) ? mofw::alignment_for(size) : alignment);
-					m_fFilter.on_dealloc(size);
+					m_fFilter.on_dealloc(size, alignment);
 				}
 			}
 
@@ -203,6 +203,14 @@ namespace mofw {
 				return m_lockObjct.is_locked();
 			}
 
+			/**
+			 * @brief Get the filter of this allocator, to read the counters of the filter.
+			 * @return The filter of this allocator.
+			 */
+			const filter_type& get_filter() const noexcept {
+				return m_fFilter;
+			}
+
 			basic_threadsafed_allocator(const self_type& other) noexcept = delete;
 			self_type& operator = (const basic_threadsafed_allocator& other) noexcept  = delete;
 		private:
@@ -52,6 +52,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -74,6 +75,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -96,6 +98,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -118,6 +121,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -140,6 +144,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -162,6 +167,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -184,6 +190,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -207,6 +214,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -229,6 +237,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -251,6 +260,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -273,6 +283,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -295,6 +306,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -317,6 +329,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
@@ -339,6 +352,7 @@ namespace mofw {
         using value_type = typename base_type::value_type;
         using difference_type = typename base_type::difference_type;
 
+        _atomic() = default;
         _atomic(const self_type&) = delete;
         _atomic& operator=(const self_type&) = delete;
         _atomic& operator=(const self_type&) volatile = delete;
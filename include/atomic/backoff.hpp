@@ -0,0 +1,77 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef _MINLIB_ATOMIC_BACKOFF_H_
+#define _MINLIB_ATOMIC_BACKOFF_H_
+
+#include "../config.hpp"
+
+#include <stdint.h>
+
+namespace mofw {
+    /**
+     * @brief Tell the cpu that this is a spin wait loop
+     */
+    inline void cpu_relax() {
+    #if defined(__i386__) || defined(__x86_64__)
+        __builtin_ia32_pause();
+    #elif defined(__aarch64__) || defined(__arm__)
+        __asm__ __volatile__("yield" ::: "memory");
+    #else
+        __asm__ __volatile__("nop" ::: "memory");
+    #endif
+    }
+
+    /**
+     * @brief Exponential backoff for spin wait loops.
+     *
+     * Each pause() spins twice as long as the one before, up to TMAX cpu_relax
+     * calls, so waiting cores do not hammer the cache line of the lock.
+     *
+     * @tparam TMAX The max number of cpu_relax calls per pause
+     */
+    template <uint32_t TMAX = 64>
+    class basic_backoff {
+        static_assert(TMAX > 0, "TMAX must be greater then zero");
+    public:
+        basic_backoff() noexcept : m_uiCount(1) { }
+
+        /**
+         * @brief Spin the current backoff time and double it
+         * @return The number of cpu_relax calls
+         */
+        uint32_t pause() noexcept {
+            uint32_t _count = m_uiCount;
+
+            for(uint32_t i = 0; i < _count; i++) cpu_relax();
+            if(m_uiCount < TMAX) m_uiCount <<= 1;
+
+            return _count;
+        }
+
+        /**
+         * @brief Start again with the shortest backoff time
+         */
+        void reset() noexcept { m_uiCount = 1; }
+    private:
+        uint32_t m_uiCount;
+    };
+
+    using backoff_t = basic_backoff<>;
+}
+
+#endif // _MINLIB_ATOMIC_BACKOFF_H_
@@ -22,6 +22,7 @@
 #include "config.hpp"
 
 #include "atomic.hpp"
+#include "atomic/backoff.hpp"
 #include "lock.hpp"
 
 namespace mofw {
@@ -54,11 +55,18 @@ namespace mofw {
 
         /**
          *  lock (take) a atomic_spinlock
+         *
+         *  Spin on a plain load with exponential backoff and try the exchange only,
+         *  when the lock looks free.
          *  @param timeout Not use
          */
         virtual int lock(unsigned int not_use = 0) {
+            backoff_t _backoff;
+
             while(! m_locked.compare_exchange_t(false, true,
-                mofw::memory_order::Acquire) ) { }
+                mofw::memory_order::Acquire) ) {
+                while(m_locked.load(mofw::memory_order::Relaxed)) _backoff.pause();
+            }
             return 0;
         }
 
@@ -75,16 +83,12 @@ namespace mofw {
         /**
          * Try to lock the atomic_spinlock
          *
-         * @note call lock with timeout from 0
-         *
          * @return true if the Lock was acquired, false when not
          */
         virtual bool try_lock() {
-            if( m_locked.compare_exchange_t(false, true, atomic_bool::memory_order::Acquire) )
-                return false;
-            else
-                lock();
-            return true;
+            bool _expected = false;
+
+            return m_locked.compare_exchange_strong(_expected, true, mofw::memory_order::Acquire);
         }
         /**
          * Is the atomic_spinlock created (initialized) ?
@@ -95,6 +99,14 @@ namespace mofw {
             return true;
         }
 
+        /**
+         * @brief Is locked?
+         * @return True if locked and false when not.
+         */
+        virtual bool is_locked() const {
+            return m_locked.load(mofw::memory_order::Relaxed);
+        }
+
         /**
 		 * @brief Converts the atomic_spinlock to value_type.
 		 * @return The convertet value
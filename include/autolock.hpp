@@ -23,6 +23,7 @@
 #include "lock.hpp"
 
 #include "mutex.hpp"
+#include "adaptive_mutex.hpp"
 #include "semaphore.hpp"
 #include "null_lock.hpp"
 
@@ -47,6 +48,11 @@ namespace mofw {
    */
   using automutx_t = basic_autolock<mutex_t>;
 
+  /**
+   * A autolock type for adaptive_mutex_t objects
+   */
+  using autoadaptmutx_t = basic_autolock<adaptive_mutex_t>;
+
   #if (MN_THREAD_CONFIG_RECURSIVE_MUTEX == MN_THREAD_CONFIG_YES)
   //using autoremutx_t = basic_autolock<remutex_t>;
   #endif
@@ -57,6 +63,8 @@ namespace mofw {
     using LockType_t = mofw::binary_semaphore_t;
   #elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_COUNTING_SEMAPHORE
     using LockType_t = mofw::counting_semaphore_t;
+  #elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_ADAPTIVE_MUTEX
+    using LockType_t = mofw::adaptive_mutex_t;
   //#elif MN_THREAD_CONFIG_LOCK_TYPE == MN_THREAD_CONFIG_RECURSIVE_MUTEX
   //  using LockType_t = remutex_t;
   #endif
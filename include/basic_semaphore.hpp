@@ -26,6 +26,7 @@
 #include "error.hpp"
 #include "lock.hpp"
 #include "excp/lock_exptions.hpp"
+#include "lock_profiler.hpp"
 
 
 
@@ -96,6 +97,17 @@ namespace mofw {
       void set_name(const char* name)       { vQueueAddToRegistry(m_pSpinlock, name); }
     #endif // configQUEUE_REGISTRY_SIZE
 
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      /**
+       * Set the name of this lock in the basic_lock_profiler.
+       *
+       * A mutex is always profiled. A binary or counting semaphore is mostly a signal
+       * and not a lock, so it is only profiled after this call.
+       */
+      void set_profile_name(const char* name) {
+        m_bProfiled = true; m_lockProbe.set_name(this, name); }
+    #endif
+
 
     /**
 	 * @brief Is locked?
@@ -137,6 +149,17 @@ namespace mofw {
      */
     int m_iCreateErrorCode;
 	bool m_isLocked;
+
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      /**
+       * The connection to the basic_lock_profiler
+       */
+      basic_lock_probe m_lockProbe;
+      /**
+       * Use the probe in lock() and unlock() of this class, the mutexes have their own
+       */
+      bool m_bProfiled;
+    #endif
   };
 }
 
@@ -21,10 +21,640 @@
 
 #include "config.hpp"
 
+#include <stdint.h>
+#include <new>
+
+#include "autolock.hpp"
+#include "allocator.hpp"
+#include "hash.hpp"
+
+#include "container/hash_map.hpp"
+
 namespace mofw {
 
+	/**
+	 * @brief The counters of a cache.
+	 */
+	struct cache_stats {
+		uint32_t hits;			/*!< The number of found keys */
+		uint32_t misses;		/*!< The number of not found keys */
+		uint32_t insertions;	/*!< The number of new keys */
+		uint32_t evictions;		/*!< The number of keys that are removed for a new key */
+		uint32_t rejections;	/*!< The number of new keys that the admission rejected */
+
+		cache_stats& operator += (const cache_stats& rhs) noexcept {
+			hits += rhs.hits; misses += rhs.misses; insertions += rhs.insertions;
+			evictions += rhs.evictions; rejections += rhs.rejections;
+			return *this;
+		}
+	};
+
+	/**
+	 * @brief Least recently used eviction for basic_cache.
+	 *
+	 * The slots are in a double linked list of indices, a access move the slot to the
+	 * front and the victim is the back.
+	 */
+	class cache_policy_lru {
+	public:
+		/// The policy data of each slot
+		struct node_type {
+			uint32_t prev;
+			uint32_t next;
+		};
+		static constexpr uint32_t npos = 0xffffffffU;
+
+		cache_policy_lru() noexcept : m_uiHead(npos), m_uiTail(npos) { }
+
+		void reset(uint32_t uiCapacity) noexcept {
+			MN_UNUSED_VARIABLE(uiCapacity);
+			m_uiHead = m_uiTail = npos;
+		}
+
+		template <class TEntry>
+		void on_insert(TEntry* pEntries, uint32_t index) noexcept {
+			link_front(pEntries, index);
+		}
+		template <class TEntry>
+		void on_access(TEntry* pEntries, uint32_t index) noexcept {
+			if(m_uiHead == index) return;
+
+			unlink(pEntries, index);
+			link_front(pEntries, index);
+		}
+		template <class TEntry>
+		void on_erase(TEntry* pEntries, uint32_t index) noexcept {
+			unlink(pEntries, index);
+		}
+		template <class TEntry>
+		uint32_t victim(TEntry* pEntries, uint32_t uiCapacity) noexcept {
+			MN_UNUSED_VARIABLE(pEntries);
+			MN_UNUSED_VARIABLE(uiCapacity);
+			return m_uiTail;
+		}
+	private:
+		template <class TEntry>
+		void link_front(TEntry* pEntries, uint32_t index) noexcept {
+			pEntries[index].node.prev = npos;
+			pEntries[index].node.next = m_uiHead;
+
+			if(m_uiHead != npos) pEntries[m_uiHead].node.prev = index;
+			m_uiHead = index;
+
+			if(m_uiTail == npos) m_uiTail = index;
+		}
+		template <class TEntry>
+		void unlink(TEntry* pEntries, uint32_t index) noexcept {
+			node_type& _node = pEntries[index].node;
+
+			if(_node.prev != npos) pEntries[_node.prev].node.next = _node.next;
+			else m_uiHead = _node.next;
+
+			if(_node.next != npos) pEntries[_node.next].node.prev = _node.prev;
+			else m_uiTail = _node.prev;
+		}
+	private:
+		uint32_t m_uiHead;
+		uint32_t m_uiTail;
+	};
+
+	/**
+	 * @brief CLOCK (second chance) eviction for basic_cache.
+	 *
+	 * Each slot has only a referenced bit, a access set the bit. The hand goes round the
+	 * slots, clear the set bits and take the first slot without the bit. A hit need
+	 * no list update, so it is cheaper as LRU.
+	 */
+	class cache_policy_clock {
+	public:
+		/// The policy data of each slot
+		struct node_type {
+			uint8_t referenced;
+		};
+
+		cache_policy_clock() noexcept : m_uiHand(0) { }
+
+		void reset(uint32_t uiCapacity) noexcept {
+			MN_UNUSED_VARIABLE(uiCapacity);
+			m_uiHand = 0;
+		}
+
+		template <class TEntry>
+		void on_insert(TEntry* pEntries, uint32_t index) noexcept {
+			pEntries[index].node.referenced = 0;
+		}
+		template <class TEntry>
+		void on_access(TEntry* pEntries, uint32_t index) noexcept {
+			pEntries[index].node.referenced = 1;
+		}
+		template <class TEntry>
+		void on_erase(TEntry* pEntries, uint32_t index) noexcept {
+			pEntries[index].node.referenced = 0;
+		}
+		/**
+		 * @brief Get the victim, only called when all slots are used.
+		 */
+		template <class TEntry>
+		uint32_t victim(TEntry* pEntries, uint32_t uiCapacity) noexcept {
+			while(pEntries[m_uiHand].node.referenced) {
+				pEntries[m_uiHand].node.referenced = 0;
+				m_uiHand = (m_uiHand + 1) % uiCapacity;
+			}
+			uint32_t _victim = m_uiHand;
+			m_uiHand = (m_uiHand + 1) % uiCapacity;
+
+			return _victim;
+		}
+	private:
+		uint32_t m_uiHand;
+	};
+
+	/**
+	 * @brief The admission for basic_cache that admit all new keys.
+	 */
+	struct cache_admission_none {
+		void record(result_type hash) noexcept { MN_UNUSED_VARIABLE(hash); }
+		bool admit(result_type candidate, result_type victim) noexcept {
+			MN_UNUSED_VARIABLE(candidate);
+			MN_UNUSED_VARIABLE(victim);
+			return true;
+		}
+	};
+
+	/**
+	 * @brief TinyLFU admission for basic_cache.
+	 *
+	 * A count-min sketch with 4 rows of TWIDTH 8 bit counters estimate the access
+	 * frequency of all keys, also of keys that are not in the cache. A new key only
+	 * replace the victim when it is more often used. After 10 * TWIDTH records all
+	 * counters are halved, so old frequencies fade out.
+	 *
+	 * @tparam TWIDTH The number of counters per row, must be a power of two.
+	 */
+	template <size_t TWIDTH = 256>
+	class cache_admission_tinylfu {
+		static_assert((TWIDTH & (TWIDTH - 1)) == 0, "TWIDTH must be a power of two");
+	public:
+		cache_admission_tinylfu() noexcept : m_uiSamples(0) {
+			for(size_t i = 0; i < 4 * TWIDTH; i++) m_aCounter[i] = 0;
+		}
+
+		void record(result_type hash) noexcept {
+			for(size_t _row = 0; _row < 4; _row++) {
+				uint8_t& _counter = m_aCounter[index(hash, _row)];
+				if(_counter < 255) _counter++;
+			}
+			if(++m_uiSamples >= 10 * TWIDTH) age();
+		}
+
+		bool admit(result_type candidate, result_type victim) noexcept {
+			return estimate(candidate) > estimate(victim);
+		}
+
+		/// Get the estimated frequency of the hash
+		uint8_t estimate(result_type hash) const noexcept {
+			uint8_t _min = 255;
+
+			for(size_t _row = 0; _row < 4; _row++) {
+				uint8_t _counter = m_aCounter[index(hash, _row)];
+				if(_counter < _min) _min = _counter;
+			}
+			return _min;
+		}
+	private:
+		static size_t index(result_type hash, size_t _row) noexcept {
+			// each row use a other part of the hash
+			uint32_t _h = static_cast<uint32_t>(hash) * (0x9e3779b1U + static_cast<uint32_t>(_row) * 0x7f4a7c16U);
+			return (_row * TWIDTH) + ((_h >> 16) & (TWIDTH - 1));
+		}
+		void age() noexcept {
+			for(size_t i = 0; i < 4 * TWIDTH; i++) m_aCounter[i] >>= 1;
+			m_uiSamples = 0;
+		}
+	private:
+		uint8_t m_aCounter[4 * TWIDTH];
+		size_t m_uiSamples;
+	};
+
+	/**
+	 * @brief A bounded key value cache with O(1) get and put.
+	 *
+	 * The entries are in one array with a fixed number of slots, a basic_hash_map
+	 * map the keys to the slots. When all slots are used a put evict the victim of
+	 * TPolicy, TAdmission can reject the new key to keep the victim.
+	 *
+	 * @tparam TKey 		The type of the keys.
+	 * @tparam TValue 		The type of the values, must be copy assignable.
+	 * @tparam TPolicy 		The eviction, cache_policy_lru or cache_policy_clock.
+	 * @tparam TAdmission 	The admission, cache_admission_none or cache_admission_tinylfu.
+	 * @tparam THash 		The hasher of the keys.
+	 * @tparam TAllocator 	The allocator for the slots and the index.
+	 *
+	 * @note Not thread safe, @see basic_striped_cache
+	 */
+	template <class TKey, class TValue,
+			  class TPolicy = cache_policy_lru,
+			  class TAdmission = cache_admission_none,
+			  class THash = mofw::hash<TKey>,
+			  class TAllocator = memory::default_allocator>
+	class basic_cache {
+	public:
+		using key_type = TKey;
+		using mapped_type = TValue;
+		using policy_type = TPolicy;
+		using admission_type = TAdmission;
+		using hasher = THash;
+		using allocator_type = TAllocator;
+		using size_type = mofw::size_t;
+		using self_type = basic_cache<TKey, TValue, TPolicy, TAdmission, THash, TAllocator>;
+
+		/// A slot of the cache
+		struct entry_type {
+			key_type key;
+			mapped_type value;
+			typename policy_type::node_type node;
+
+			entry_type(const key_type& k, const mapped_type& v)
+				: key(k), value(v) { }
+		};
+
+		using index_type = mofw::container::basic_hash_map<TKey, uint32_t, THash,
+								mofw::container::hash_map_equal, TAllocator>;
+
+		/**
+		 * @brief Construct the cache.
+		 * @param uiCapacity The maximal number of entries.
+		 */
+		explicit basic_cache(size_type uiCapacity = 0,
+							 const allocator_type& allocator = allocator_type())
+			: m_pEntries(nullptr), m_pFree(nullptr), m_uiCapacity(0), m_uiFree(0),
+			  m_mIndex(0, allocator), m_allocator(allocator) {
+
+			reset_stats();
+			if(uiCapacity > 0) resize(uiCapacity);
+		}
+
+		~basic_cache() {
+			release();
+		}
+
+		basic_cache(const self_type&) = delete;
+		self_type& operator = (const self_type&) = delete;
+
+		/**
+		 * @brief Drop all entries and set a new capacity.
+		 * @return True on success and false when the allocation failed, the cache has
+		 * then no capacity.
+		 */
+		bool resize(size_type uiCapacity) {
+			release();
+
+			if(uiCapacity == 0) return true;
+
+			void* _mem = m_allocator.allocate(block_size(uiCapacity),
+								mofw::alignment_for(sizeof(entry_type)));
+
+			if(_mem == nullptr || !m_mIndex.reserve(uiCapacity)) {
+				if(_mem) m_allocator.deallocate(_mem, block_size(uiCapacity),
+								mofw::alignment_for(sizeof(entry_type)));
+				return false;
+			}
+
+			m_pEntries = static_cast<entry_type*>(_mem);
+			m_pFree = reinterpret_cast<uint32_t*>(m_pEntries + uiCapacity);
+			m_uiCapacity = uiCapacity;
+
+			for(size_type i = 0; i < uiCapacity; i++)
+				m_pFree[i] = static_cast<uint32_t>(uiCapacity - 1 - i);
+			m_uiFree = uiCapacity;
+
+			m_tPolicy.reset(uiCapacity);
+			return true;
+		}
+
+		/**
+		 * @brief Find the value of the key and mark it as used.
+		 * @return The pointer to the value or nullptr on a miss. The pointer is valid until
+		 * the next put or erase.
+		 */
+		template <class K>
+		mapped_type* get(const K& key) {
+			m_tAdmission.record(mofw::hash_mix(hasher{}(key)));
+
+			uint32_t* _index = m_mIndex.get(key);
+
+			if(_index == nullptr) {
+				m_stats.misses++;
+				return nullptr;
+			}
+			m_stats.hits++;
+			m_tPolicy.on_access(m_pEntries, *_index);
+
+			return &m_pEntries[*_index].value;
+		}
+
+		/**
+		 * @brief Copy the value of the key.
+		 * @return True on a hit and false on a miss.
+		 */
+		template <class K>
+		bool get(const K& key, mapped_type& value) {
+			mapped_type* _value = get(key);
+
+			if(_value == nullptr) return false;
+
+			value = *_value;
+			return true;
+		}
+
+		/**
+		 * @brief Insert or update the value of the key.
+		 * @return True when the value is in the cache and false when the admission
+		 * rejected the key or the cache has no capacity.
+		 */
+		bool put(const key_type& key, const mapped_type& value) {
+			result_type _hash = mofw::hash_mix(hasher{}(key));
+			m_tAdmission.record(_hash);
+
+			uint32_t* _index = m_mIndex.get(key);
+
+			if(_index != nullptr) {
+				m_pEntries[*_index].value = value;
+				m_tPolicy.on_access(m_pEntries, *_index);
+				return true;
+			}
+			if(m_uiCapacity == 0) return false;
+
+			uint32_t _slot;
+
+			if(m_uiFree > 0) {
+				_slot = m_pFree[--m_uiFree];
+			} else {
+				_slot = m_tPolicy.victim(m_pEntries, m_uiCapacity);
+
+				entry_type& _victim = m_pEntries[_slot];
+
+				if(!m_tAdmission.admit(_hash, mofw::hash_mix(hasher{}(_victim.key)))) {
+					m_stats.rejections++;
+					return false;
+				}
+				m_tPolicy.on_erase(m_pEntries, _slot);
+				m_mIndex.erase(_victim.key);
+				_victim.~entry_type();
+
+				m_stats.evictions++;
+			}
+
+			new (&m_pEntries[_slot]) entry_type(key, value);
+			m_mIndex.insert(key, _slot);
+			m_tPolicy.on_insert(m_pEntries, _slot);
+
+			m_stats.insertions++;
+			return true;
+		}
+
+		/**
+		 * @brief Remove the key from the cache.
+		 * @return True when the key was in the cache.
+		 */
+		template <class K>
+		bool erase(const K& key) {
+			uint32_t* _index = m_mIndex.get(key);
+
+			if(_index == nullptr) return false;
+
+			uint32_t _slot = *_index;
+
+			m_tPolicy.on_erase(m_pEntries, _slot);
+			m_mIndex.erase(key);
+			m_pEntries[_slot].~entry_type();
+			m_pFree[m_uiFree++] = _slot;
+
+			return true;
+		}
+
+		/**
+		 * @brief Is the key in the cache, do not update the policy and the counters.
+		 */
+		template <class K>
+		bool contains(const K& key) const noexcept {
+			return m_mIndex.contains(key);
+		}
+
+		/**
+		 * @brief Remove all entries, the capacity is not changed.
+		 */
+		void clear() {
+			for(typename index_type::iterator it = m_mIndex.begin(); it != m_mIndex.end(); ++it)
+				m_pEntries[it->second].~entry_type();
+
+			m_mIndex.clear();
+
+			for(size_type i = 0; i < m_uiCapacity; i++)
+				m_pFree[i] = static_cast<uint32_t>(m_uiCapacity - 1 - i);
+			m_uiFree = m_uiCapacity;
+
+			m_tPolicy.reset(m_uiCapacity);
+		}
+
+		/// Get the number of entries
+		size_type size() const noexcept 			{ return m_uiCapacity - m_uiFree; }
+		/// Get the maximal number of entries
+		size_type capacity() const noexcept 		{ return m_uiCapacity; }
+		/// Is the cache empty
+		bool empty() const noexcept 				{ return size() == 0; }
+
+		/// Get the counters
+		const cache_stats& get_stats() const noexcept { return m_stats; }
+		/// Set all counters to zero
+		void reset_stats() noexcept {
+			m_stats.hits = m_stats.misses = m_stats.insertions = 0;
+			m_stats.evictions = m_stats.rejections = 0;
+		}
+	private:
+		static constexpr size_type block_size(size_type uiCapacity) noexcept {
+			return uiCapacity * (sizeof(entry_type) + sizeof(uint32_t));
+		}
+
+		void release() {
+			if(m_pEntries == nullptr) return;
+
+			clear();
+			m_allocator.deallocate(m_pEntries, block_size(m_uiCapacity),
+								mofw::alignment_for(sizeof(entry_type)));
+
+			m_pEntries = nullptr; m_pFree = nullptr;
+			m_uiCapacity = m_uiFree = 0;
+		}
+	private:
+		entry_type* m_pEntries;
+		uint32_t* m_pFree;
+		size_type m_uiCapacity;
+		size_type m_uiFree;
+
+		index_type m_mIndex;
+		policy_type m_tPolicy;
+		admission_type m_tAdmission;
+		cache_stats m_stats;
+		allocator_type m_allocator;
+	};
+
+	/**
+	 * @brief A thread safe cache, split into TSTRIPES basic_cache stripes each with his own lock.
+	 *
+	 * The key hash select the stripe, so tasks that use different keys rarely wait for each
+	 * other. The eviction and admission work per stripe.
+	 *
+	 * @tparam TSTRIPES The number of stripes.
+	 * @tparam TLOCK 	The lock type of each stripe.
+	 */
+	template <class TKey, class TValue,
+			  size_t TSTRIPES = MN_THREAD_CONFIG_CACHE_STRIPES,
+			  class TPolicy = cache_policy_lru,
+			  class TAdmission = cache_admission_none,
+			  class THash = mofw::hash<TKey>,
+			  class TLOCK = LockType_t,
+			  class TAllocator = memory::default_allocator>
+	class basic_striped_cache {
+		static_assert(TSTRIPES > 0, "TSTRIPES must be greater then zero");
+	public:
+		using key_type = TKey;
+		using mapped_type = TValue;
+		using hasher = THash;
+		using lock_type = TLOCK;
+		using size_type = mofw::size_t;
+		using cache_type = basic_cache<TKey, TValue, TPolicy, TAdmission, THash, TAllocator>;
+
+		/**
+		 * @brief Construct the cache.
+		 * @param uiCapacity The maximal number of entries of all stripes.
+		 */
+		explicit basic_striped_cache(size_type uiCapacity) {
+			for(size_t i = 0; i < TSTRIPES; i++)
+				m_aStripes[i].cache.resize( (uiCapacity + TSTRIPES - 1) / TSTRIPES );
+		}
+
+		basic_striped_cache(const basic_striped_cache&) = delete;
+		basic_striped_cache& operator = (const basic_striped_cache&) = delete;
+
+		/**
+		 * @brief Copy the value of the key.
+		 * @return True on a hit and false on a miss.
+		 */
+		template <class K>
+		bool get(const K& key, mapped_type& value) {
+			stripe& _stripe = get_stripe(key);
+			basic_autolock<TLOCK> _lock(_stripe.lock);
+
+			return _stripe.cache.get(key, value);
+		}
+
+		/**
+		 * @brief Insert or update the value of the key.
+		 * @see basic_cache::put
+		 */
+		bool put(const key_type& key, const mapped_type& value) {
+			stripe& _stripe = get_stripe(key);
+			basic_autolock<TLOCK> _lock(_stripe.lock);
+
+			return _stripe.cache.put(key, value);
+		}
+
+		/**
+		 * @brief Remove the key from the cache.
+		 */
+		template <class K>
+		bool erase(const K& key) {
+			stripe& _stripe = get_stripe(key);
+			basic_autolock<TLOCK> _lock(_stripe.lock);
+
+			return _stripe.cache.erase(key);
+		}
+
+		/**
+		 * @brief Is the key in the cache.
+		 */
+		template <class K>
+		bool contains(const K& key) {
+			stripe& _stripe = get_stripe(key);
+			basic_autolock<TLOCK> _lock(_stripe.lock);
+
+			return _stripe.cache.contains(key);
+		}
+
+		/**
+		 * @brief Remove all entries of all stripes.
+		 */
+		void clear() {
+			for(size_t i = 0; i < TSTRIPES; i++) {
+				basic_autolock<TLOCK> _lock(m_aStripes[i].lock);
+				m_aStripes[i].cache.clear();
+			}
+		}
+
+		/**
+		 * @brief Get the number of entries of all stripes.
+		 */
+		size_type size() {
+			size_type _size = 0;
+
+			for(size_t i = 0; i < TSTRIPES; i++) {
+				basic_autolock<TLOCK> _lock(m_aStripes[i].lock);
+				_size += m_aStripes[i].cache.size();
+			}
+			return _size;
+		}
+
+		/**
+		 * @brief Get the sum of the counters of all stripes.
+		 */
+		cache_stats get_stats() {
+			cache_stats _stats = { 0, 0, 0, 0, 0 };
+
+			for(size_t i = 0; i < TSTRIPES; i++) {
+				basic_autolock<TLOCK> _lock(m_aStripes[i].lock);
+				_stats += m_aStripes[i].cache.get_stats();
+			}
+			return _stats;
+		}
+
+		/**
+		 * @brief Set the counters of all stripes to zero.
+		 */
+		void reset_stats() {
+			for(size_t i = 0; i < TSTRIPES; i++) {
+				basic_autolock<TLOCK> _lock(m_aStripes[i].lock);
+				m_aStripes[i].cache.reset_stats();
+			}
+		}
+	private:
+		struct stripe {
+			lock_type lock;
+			cache_type cache;
+		};
+
+		template <class K>
+		stripe& get_stripe(const K& key) noexcept {
+			// use the high bits, the low bits select the slot in the index of the stripe
+			return m_aStripes[ (mofw::hash_mix(hasher{}(key)) >> 16) % TSTRIPES ];
+		}
+	private:
+		stripe m_aStripes[TSTRIPES];
+	};
+
+	template <class TKey, class TValue, class THash = mofw::hash<TKey> >
+	using lru_cache = basic_cache<TKey, TValue, cache_policy_lru, cache_admission_none, THash>;
+
+	template <class TKey, class TValue, class THash = mofw::hash<TKey> >
+	using clock_cache = basic_cache<TKey, TValue, cache_policy_clock, cache_admission_none, THash>;
+
+	template <class TKey, class TValue, class THash = mofw::hash<TKey> >
+	using tinylfu_cache = basic_cache<TKey, TValue, cache_policy_lru, cache_admission_tinylfu<>, THash>;
 
-};
+	template <class TKey, class TValue, size_t TSTRIPES = MN_THREAD_CONFIG_CACHE_STRIPES,
+			  class TPolicy = cache_policy_lru>
+	using striped_cache = basic_striped_cache<TKey, TValue, TSTRIPES, TPolicy>;
+}
 
 
-#endif
\ No newline at end of file
+#endif
@@ -38,6 +38,8 @@
 #define MN_THREAD_CONFIG_COUNTING_SEMAPHORE   2
 /// @brief Pre defined values for config items - Use a binary semaphore
 #define MN_THREAD_CONFIG_BINARY_SEMAPHORE     3
+/// @brief Pre defined helper values for config items - Use a adaptive (spin then block) mutex
+#define MN_THREAD_CONFIG_ADAPTIVE_MUTEX       4
 
 /// @brief Pre defined helper values for config items - Use for aktivating
 #define MN_THREAD_CONFIG_YES        1
@@ -148,11 +150,31 @@
     #define MN_THREAD_CONFIG_BASIC_ALIGNMENT     sizeof(unsigned char*)
 #endif
 
+#ifndef MN_THREAD_CONFIG_CACHE_LINE_SIZE
+    /// The size of a cache line in bytes, use to pad shared counters of lock free containers
+    #define MN_THREAD_CONFIG_CACHE_LINE_SIZE     32
+#endif
+
 #ifndef MN_THREAD_CONFIG_BASIC_HASHMUL_VAL
 	/// Basic value for struct::hash as basic hash calculate @see mofw::hash
 	#define MN_THREAD_CONFIG_BASIC_HASHMUL_VAL 2149645487U
 #endif // MN_THREAD_CONFIG_BASIC_HASHMUL_VAL
 
+#ifndef MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD
+	/// The maximal load of mofw::container::basic_hash_map in percent, before the table grow
+	#define MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD 85
+#endif // MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD
+
+#ifndef MN_THREAD_CONFIG_CACHE_STRIPES
+	/// The default number of lock stripes of mofw::basic_striped_cache
+	#define MN_THREAD_CONFIG_CACHE_STRIPES 4
+#endif // MN_THREAD_CONFIG_CACHE_STRIPES
+
+#ifndef MN_THREAD_CONFIG_MATH_SIMD
+	/// Use the SSE or NEON code paths of the math batch functions, when the target has it
+	#define MN_THREAD_CONFIG_MATH_SIMD MN_THREAD_CONFIG_YES
+#endif // MN_THREAD_CONFIG_MATH_SIMD
+
 //==================================
 // end basic config
 
@@ -246,6 +268,7 @@
      * MN_THREAD_CONFIG_MUTEX:      using the mutex as default lock type
      * MN_THREAD_CONFIG_BINARY_SEMAPHORE using the binary semaphore as default lock type
      * MN_THREAD_CONFIG_COUNTING_SEMAPHORE: using the counting semaphore as default lock type
+     * MN_THREAD_CONFIG_ADAPTIVE_MUTEX: using the adaptive mutex as default lock type
      * @note default: MN_THREAD_CONFIG_BINARY_SEMAPHORE
      */
     #define MN_THREAD_CONFIG_LOCK_TYPE MN_THREAD_CONFIG_BINARY_SEMAPHORE
@@ -257,6 +280,57 @@
      */
     #define MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST          MN_THREAD_CONFIG_NO
 #endif
+
+#ifndef MN_THREAD_CONFIG_TASK_LIST_MAX
+    /**
+     * How many tasks can hold the basic_task_list, must be a power of two
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_TASK_LIST_MAX                  32
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_LIST_NAMELEN
+    /**
+     * How many chars of the task name are copied to the basic_task_list, with the null
+     * @note default: configMAX_TASK_NAME_LEN
+     */
+    #define MN_THREAD_CONFIG_TASK_LIST_NAMELEN              configMAX_TASK_NAME_LEN
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_PROFILING
+    /**
+     * Record per task cpu time, context switches, wake latency and message queue depth?
+     * The switch counters need the FreeRTOS trace hooks, see task_profile.hpp
+     *
+     *'MN_THREAD_CONFIG_YES' or 'MN_THREAD_CONFIG_NO'
+     * @note default: MN_THREAD_CONFIG_NO
+     */
+    #define MN_THREAD_CONFIG_TASK_PROFILING                 MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_PROFILING_TLS_INDEX
+    /**
+     * The thread local storage index, that holds the profile counters of a basic_task
+     * @note default: configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1
+     */
+    #define MN_THREAD_CONFIG_TASK_PROFILING_TLS_INDEX       (configNUM_THREAD_LOCAL_STORAGE_POINTERS - 1)
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_PROFILER_STACKSIZE
+    /**
+     * Stack size for the task profile reporter task
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 2
+     */
+    #define MN_THREAD_CONFIG_TASK_PROFILER_STACKSIZE        (MN_THREAD_CONFIG_MINIMAL_STACK_SIZE * 2)
+#endif
+
+#ifndef MN_THREAD_CONFIG_TASK_PROFILER_PRIORITY
+    /**
+     * Priority for the task profile reporter task
+     * @note default: basic_task::priority::Low
+     */
+    #define MN_THREAD_CONFIG_TASK_PROFILER_PRIORITY         mofw::basic_task::priority::Low
+#endif
 //==================================
 // end task config
 
@@ -326,6 +400,54 @@
      */
     #define MN_THREAD_CONFIG_WORKQUEUE_MULTI_PRIORITY      mofw::basic_task::priority::Low
 #endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER
+    /**
+     * How many worker tasks run in the work stealing workqueue, the workers are pinned round robin to the cores
+     * @note default: portNUM_PROCESSORS
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER      portNUM_PROCESSORS
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUESIZE
+    /**
+     * How many work items can hold the local deque of each worker, must be a power of two
+     * @note default: 64
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUESIZE   64
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_INBOXSIZE
+    /**
+     * How many work items from other tasks can wait in the inbox of each worker, must be a power of two
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_INBOXSIZE   32
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_BATCH
+    /**
+     * How many work items a worker move at once from his inbox to his local deque
+     * @note default: 8
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_BATCH       8
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE
+    /**
+     * Stak size for the work stealing workqueue for all worker tasks
+     * @note default: MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE   MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY
+    /**
+     * @note default: Priority for the work stealing workqueue for all worker tasks
+     * @note default: basic_thread::PriorityLow
+     */
+    #define MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY    mofw::basic_task::priority::Low
+#endif
 //==================================
 // end workqueue config
 
@@ -374,6 +496,59 @@
      */
     #define MN_THREAD_CONFIG_RECURSIVE_MUTEX_CHEAKING     MN_THREAD_CONFIG_YES
 #endif
+
+#ifndef MN_THREAD_CONFIG_LOCK_PROFILING
+    /**
+     * Record the contention of the mutexes (basic_lock_profiler)? A binary or counting
+     * semaphore is only recorded after basic_semaphore::set_profile_name.
+     *
+     *'MN_THREAD_CONFIG_YES' or 'MN_THREAD_CONFIG_NO'
+     * @note default: MN_THREAD_CONFIG_NO
+     */
+    #define MN_THREAD_CONFIG_LOCK_PROFILING               MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_LOCK_PROFILING_MAX_LOCKS
+    /**
+     * How many locks can the basic_lock_profiler record, further locks are not recorded
+     * @note default: 32
+     */
+    #define MN_THREAD_CONFIG_LOCK_PROFILING_MAX_LOCKS     32
+#endif
+
+#ifndef MN_THREAD_CONFIG_LOCK_PROFILING_BUCKETS
+    /**
+     * The number of buckets of the wait and hold time histograms, bucket n holds the
+     * times from 2^(n-1) to 2^n - 1 micro seconds, the last bucket all greater times
+     * @note default: 16
+     */
+    #define MN_THREAD_CONFIG_LOCK_PROFILING_BUCKETS       16
+#endif
+
+#ifndef MN_THREAD_CONFIG_LOCK_PROFILING_TOP_WAITERS
+    /**
+     * How many waiting tasks are recorded per lock
+     * @note default: 4
+     */
+    #define MN_THREAD_CONFIG_LOCK_PROFILING_TOP_WAITERS   4
+#endif
+
+#ifndef MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN_MAX
+    /**
+     * How many cpu_relax calls spin the basic_adaptive_mutex at most, before the task blocks.
+     * The real spin limit adapts to the lock, see basic_adaptive_mutex
+     * @note default: 2048
+     */
+    #define MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN_MAX      2048
+#endif
+
+#ifndef MN_THREAD_CONFIG_ADAPTIVE_MUTEX_BACKOFF_MAX
+    /**
+     * The max cpu_relax calls of one backoff step in the basic_adaptive_mutex
+     * @note default: 64
+     */
+    #define MN_THREAD_CONFIG_ADAPTIVE_MUTEX_BACKOFF_MAX   64
+#endif
 // end mutex config
 
 // start queue config
@@ -454,13 +629,42 @@
 
 // start tickhook config
 //==================================
-#ifndef MN_THREAD_CONFIG_TICKHOOK_MAXENTRYS
-    ///The max entrys are hold the tickhook queue
-    #define MN_THREAD_CONFIG_TICKHOOK_MAXENTRYS     10
+#ifndef MN_THREAD_CONFIG_TICKHOOK_WHEEL_BITS
+    ///The number of bits per level of the tickhook wheel, each level has 2^bits slots
+    #define MN_THREAD_CONFIG_TICKHOOK_WHEEL_BITS     6
+#endif
+
+#ifndef MN_THREAD_CONFIG_TICKHOOK_WHEEL_LEVELS
+    ///The number of levels of the tickhook wheel, the wheel covers 2^(bits * levels) ticks
+    #define MN_THREAD_CONFIG_TICKHOOK_WHEEL_LEVELS   4
 #endif
 //==================================
 // end tickhook config
 
+// start timer service config
+//==================================
+#ifndef MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_BITS
+    ///The number of bits per level of the timer service wheel, each level has 2^bits slots
+    #define MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_BITS     8
+#endif
+
+#ifndef MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_LEVELS
+    ///The number of levels of the timer service wheel, the wheel covers 2^(bits * levels) ticks
+    #define MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_LEVELS   3
+#endif
+
+#ifndef MN_THREAD_CONFIG_TIMER_SERVICE_STACKSIZE
+    ///Stack size for the timer service task
+    #define MN_THREAD_CONFIG_TIMER_SERVICE_STACKSIZE      MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
+#endif
+
+#ifndef MN_THREAD_CONFIG_TIMER_SERVICE_PRIORITY
+    ///The priority of the timer service task
+    #define MN_THREAD_CONFIG_TIMER_SERVICE_PRIORITY       mofw::basic_task::priority::HalfCritical
+#endif
+//==================================
+// end timer service config
+
 
 
 // start net / socket config
@@ -476,6 +680,67 @@
 #ifndef MN_THREAD_CONFIG_NET_IPADDRESS6_SCOPEID_VAL
 	#define MN_THREAD_CONFIG_NET_IPADDRESS6_SCOPEID_VAL 0
 #endif
+
+/// Socket reactor backend: lwip_select
+#define MN_THREAD_CONFIG_NET_REACTOR_SELECT 	1
+/// Socket reactor backend: lwip_poll
+#define MN_THREAD_CONFIG_NET_REACTOR_POLL 		2
+
+#ifndef MN_THREAD_CONFIG_NET_REACTOR_BACKEND
+	/// The backend of the socket reactor, the handles are lwIP sockets
+	#define MN_THREAD_CONFIG_NET_REACTOR_BACKEND MN_THREAD_CONFIG_NET_REACTOR_SELECT
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_REACTOR_MAX_HANDLERS
+	/// The max number of sockets in one socket reactor, is limited on lwIP by CONFIG_LWIP_MAX_SOCKETS
+	#define MN_THREAD_CONFIG_NET_REACTOR_MAX_HANDLERS 	32
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_REACTOR_WHEEL_BITS
+	///The number of bits per level of the idle timeout wheel of the socket reactor
+	#define MN_THREAD_CONFIG_NET_REACTOR_WHEEL_BITS 	6
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_REACTOR_WHEEL_LEVELS
+	///The number of levels of the idle timeout wheel of the socket reactor
+	#define MN_THREAD_CONFIG_NET_REACTOR_WHEEL_LEVELS 	3
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_BUFFER_CHAIN_SEGMENTS
+	/// The max number of segments (buffers) in a net::basic_buffer_chain
+	#define MN_THREAD_CONFIG_NET_BUFFER_CHAIN_SEGMENTS 	8
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_DGRAM_BATCH_SIZE
+	/// The number of datagrams in a net::basic_dgram_batch
+	#define MN_THREAD_CONFIG_NET_DGRAM_BATCH_SIZE 	8
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_DGRAM_BATCH_PACKET_SIZE
+	/// The size of a packet buffer of a net::basic_dgram_batch, in bytes
+	#define MN_THREAD_CONFIG_NET_DGRAM_BATCH_PACKET_SIZE 	1472
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG
+	/// Move a net::basic_dgram_batch with recvmmsg and sendmmsg. Enable it only when the socket
+	/// handles are kernel sockets, lwIP has no batch calls and the default uses lwip_recvmsg / lwip_sendmsg
+	#define MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG MN_THREAD_CONFIG_NO
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_PACKET_POOL_PACKETS
+	/// The default number of packets of a net::basic_packet_pool
+	#define MN_THREAD_CONFIG_NET_PACKET_POOL_PACKETS 	16
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_PACKET_POOL_PACKET_SIZE
+	/// The default size of the data of a packet of a net::basic_packet_pool, in bytes
+	#define MN_THREAD_CONFIG_NET_PACKET_POOL_PACKET_SIZE 	1472
+#endif
+
+#ifndef MN_THREAD_CONFIG_NET_ACCEPTOR_SLOTS
+	/// The number of connection sockets of a net::basic_stream_acceptor, is limited on lwIP by CONFIG_LWIP_MAX_SOCKETS
+	#define MN_THREAD_CONFIG_NET_ACCEPTOR_SLOTS 	8
+#endif
 //==================================
 // end net / socket config
 
@@ -27,6 +27,7 @@
 #include "container/vector.hpp"
 #include "container/queue.hpp"
 #include "container/rb_tree.hpp"
+#include "container/hash_map.hpp"
 
 #include "container/array.hpp"
 
@@ -21,140 +21,222 @@
 #include "../config.hpp"
 
 # include <cassert>
+# include <new>
+#if defined(__GXX_RTTI)
 # include <typeinfo>
+#endif
 
-#include "algorithm.hpp"
+#include "../algorithm.hpp"
 #include "../allocator.hpp"
 #include "../def.hpp"
 #include "../functional.hpp"
 #include "../typetraits.hpp"
 
-#include "../utils/utils.hpp"
-
-
-
 namespace mofw {
 	namespace container {
+		namespace internal {
+			/**
+			 * @brief A unique id for each type, without RTTI.
+			 */
+			template <typename T>
+			struct any_type_id {
+				static const char id;
+			};
+			template <typename T>
+			const char any_type_id<T>::id = 0;
+		}
+
 		/**
 		 * @brief An Any class represents a general type and is capable of storing any type.
-		 * @note Code taken from https://github.com/martinmoene/any-lite. Original copyright by Martin Moene.
-		 * Distributed under the Boost Software License, Version 1.0.
 		 *
-		 * @note Modified for MiniThread
+		 * Small types (not bigger and not stricter aligned then the inline buffer and nothrow
+		 * move constructible) are stored in the buffer inside the object, with no allocation.
+		 * Bigger types are allocated with TAllocator. The type operations are a static table
+		 * of function pointers for each stored type, no virtual holder and no RTTI is needed.
+		 *
+		 * @tparam TAllocator The allocator for types, that are not fit in the inline buffer.
+		 * @tparam TSIZE The size of the inline buffer in bytes.
 		 */
+		template <class TAllocator = memory::default_allocator, size_t TSIZE = 2 * sizeof(void*)>
 		class basic_any {
-			/**
-			 * @brief Interface class for the holder.
-			 */
-			class basic_any_holder {
-			public:
-				virtual std::type_info const & type() const = 0;
-				virtual iholder * clone() const = 0;
+			template <class TA, size_t TS> friend class basic_any;
+
+			union storage {
+				void* heap;
+				alignas(void*) alignas(double) unsigned char buffer[TSIZE];
 			};
 
 			/**
-			 * @brief The real impl of the basic_any holder.
+			 * @brief The operations of the stored type.
 			 */
-			template< typename T >
-			class basic_any_holder_impl : public basic_any_holder {
-			public:
-				static const int TYPE_SIZE() { return sizeof(T); }
+			struct vtable {
+				const void* type_id;
+			#if defined(__GXX_RTTI)
+				const std::type_info& (*type)() noexcept;
+			#endif
+				void (*destroy)(storage& self, TAllocator& alloc) noexcept;
+				bool (*copy)(const storage& src, storage& dest, TAllocator& alloc);
+				void (*move)(storage& src, storage& dest) noexcept;
+				void* (*get)(storage& self) noexcept;
+				bool is_inline;
+			};
 
-				basic_any_holder_impl( T const & value ) : m_typeHold( value ) {}
-				basic_any_holder_impl( T && value ) : m_typeHold( mofw::move( value ) ) {}
+			template <typename T>
+			struct fits_inline {
+				static constexpr bool value = (sizeof(T) <= TSIZE) &&
+					(alignof(T) <= alignof(storage)) &&
+					noexcept(T(static_cast<T&&>(*static_cast<T*>(nullptr))));
+			};
 
+			/**
+			 * @brief The operations for types in the inline buffer.
+			 */
+			template <typename T>
+			struct inline_ops {
+			#if defined(__GXX_RTTI)
+				static const std::type_info& type() noexcept { return typeid(T); }
+			#endif
+				static T* ptr(storage& self) noexcept {
+					return reinterpret_cast<T*>(&self.buffer[0]);
+				}
+				static const T* ptr(const storage& self) noexcept {
+					return reinterpret_cast<const T*>(&self.buffer[0]);
+				}
+				static void destroy(storage& self, TAllocator&) noexcept {
+					ptr(self)->~T();
+				}
+				static bool copy(const storage& src, storage& dest, TAllocator&) {
+					::new (static_cast<void*>(&dest.buffer[0])) T(*ptr(src));
+					return true;
+				}
+				static void move(storage& src, storage& dest) noexcept {
+					::new (static_cast<void*>(&dest.buffer[0])) T(mofw::move(*ptr(src)));
+					ptr(src)->~T();
+				}
+				static void* get(storage& self) noexcept { return ptr(self); }
 
-				/**
-				 * @brief Get the type info of the given type.
-				 * @return the Type info of the given type.
-				 */
-				virtual std::type_info const & type() const override {
-					return typeid( T );
+				template <typename... Args>
+				static bool create(storage& self, TAllocator&, Args&&... args) {
+					::new (static_cast<void*>(&self.buffer[0])) T(mofw::forward<Args>(args)...);
+					return true;
 				}
+			};
 
-				/**
-				 * @brief Get a clone from this.
-				 * @return A clone from this.
-				 */
-				virtual basic_any_holder* clone() const override {
-					return new basic_any_holder_impl( m_typeHold );
+			/**
+			 * @brief The operations for types on the heap.
+			 */
+			template <typename T>
+			struct heap_ops {
+			#if defined(__GXX_RTTI)
+				static const std::type_info& type() noexcept { return typeid(T); }
+			#endif
+				static void destroy(storage& self, TAllocator& alloc) noexcept {
+					T* _ptr = static_cast<T*>(self.heap);
+
+					_ptr->~T();
+					alloc.deallocate(_ptr, sizeof(T), alignof(T));
+				}
+				static bool copy(const storage& src, storage& dest, TAllocator& alloc) {
+					return create(dest, alloc, *static_cast<const T*>(src.heap));
+				}
+				static void move(storage& src, storage& dest) noexcept {
+					dest.heap = src.heap;
+					src.heap = nullptr;
 				}
+				static void* get(storage& self) noexcept { return self.heap; }
 
-				/**
-				 * @brief Get the stored value.
-				 * @return The stored value.
-				 */
-				T get() { return m_typeHold; }
-				/**
-				 * @brief Get the stored value.
-				 * @return The stored value.
-				 */
-				const T get() const { return m_typeHold; }
-
-				/**
-				 * @brief Convert this to the type.
-				 */
-				operator T() { return get(); }
-			private:
-				/**
-				 * The stored value.
-				 */
-				T m_typeHold;
+				template <typename... Args>
+				static bool create(storage& self, TAllocator& alloc, Args&&... args) {
+					void* _mem = alloc.allocate(sizeof(T), alignof(T));
+
+					if(_mem == nullptr) return false;
+
+					self.heap = ::new (_mem) T(mofw::forward<Args>(args)...);
+					return true;
+				}
 			};
 
+			template <typename T>
+			using ops_type = typename conditional<fits_inline<T>::value, inline_ops<T>, heap_ops<T> >::type;
+
+			template <typename T>
+			static const vtable* get_vtable() noexcept {
+				static const vtable _table = {
+					&internal::any_type_id<T>::id,
+				#if defined(__GXX_RTTI)
+					&ops_type<T>::type,
+				#endif
+					&ops_type<T>::destroy,
+					&ops_type<T>::copy,
+					&ops_type<T>::move,
+					&ops_type<T>::get,
+					fits_inline<T>::value
+				};
+				return &_table;
+			}
 		public:
-			using self_type = basic_any<TAllocator>;
-			using holder_type = basic_any_holder;
+			using self_type = basic_any<TAllocator, TSIZE>;
+			using allocator_type = TAllocator;
+
+			/// The size of the inline buffer
+			static constexpr size_t inline_size = TSIZE;
 
 			/**
 			 * @brief Construct an empty basic_any type.
 			 */
-			constexpr basic_any() noexcept
-    			: m_asyContent( nullptr ) {}
+			basic_any() noexcept
+    			: m_pTable( nullptr ), m_alloCator() { }
 
 			/**
-			 * @brief Construct an any which stores the init parameter inside.
+			 * @brief Construct an any which stores the value inside.
 			 */
-			template< class T >
-			basic_any(const T & other ) : m_asyContent( nullptr ) {
-				construct(other);
+			template< class T, class TValue = decay_t<T>,
+					  class = enable_if_t<!is_same<TValue, self_type>::value> >
+			basic_any(T&& value ) : m_pTable( nullptr ), m_alloCator() {
+				create<TValue>(mofw::forward<T>(value));
 			}
 
 			/**
 			 * @brief Copy constructor, works with both empty and initialized Any values.
 			 */
 			basic_any( const self_type& other )
-			 	: m_asyContent(nullptr )  {
-					if ((this != &other) && !other.empty()) construct(other);
+			 	: m_pTable( nullptr ), m_alloCator(other.m_alloCator)  {
+				if (other.m_pTable && other.m_pTable->copy(other.m_sStorage, m_sStorage, m_alloCator))
+					m_pTable = other.m_pTable;
 			}
 
 			/**
-			 * @brief Copy constructor, works with both empty and initialized Any values.
+			 * @brief Move constructor, the other is empty after
 			 */
 			basic_any( self_type && other ) noexcept
-				: m_asyContent.content( mofw::move( other.m_asyContent ) ) {
-					other.m_asyContent = nullptr;
+				: m_pTable( nullptr ), m_alloCator(other.m_alloCator) {
+				move_from(other);
 			}
 
 			/**
 			 * @brief Deconstructor of this basic_any object
 			 */
-			~basic_any() { deconstruct(true); }
+			~basic_any() { reset(); }
 
 			/**
-			 * @brief Reset the basic_any
+			 * @brief Reset the basic_any, destroy the value
 			 */
 			void reset() noexcept {
-				deconstruct(false);
+				if(m_pTable) {
+					m_pTable->destroy(m_sStorage, m_alloCator);
+					m_pTable = nullptr;
+				}
 			}
 
 			/**
 			 * @brief Swaps the content of the two Anys.
 			 */
-			self_type& swap( any & other ) noexcept {
+			self_type& swap( self_type& other ) noexcept {
 				if (this == &other) return *this;
 
-        		mofw::swap( m_asyContent, other.m_asyContent );
+				self_type _tmp(mofw::move(other));
+				other.move_from(*this);
+				move_from(_tmp);
         		return *this;
     		}
 
@@ -163,7 +245,7 @@ namespace mofw {
 			 * @return True The basic_any is has any value and if false then not.
 			 */
 			bool has_value() const noexcept {
-        		return m_asyContent != nullptr;
+        		return m_pTable != nullptr;
    			}
 
    			/**
@@ -171,41 +253,58 @@ namespace mofw {
 			 * @return True The basic_any is empty and if false then not.
 			 */
    			bool is_empty() const noexcept {
-        		return m_asyContent == nullptr;
+        		return m_pTable == nullptr;
    			}
 
+   			/**
+			 * @brief Is the value in the inline buffer (no allocation)?
+			 */
+   			bool is_inline() const noexcept {
+        		return m_pTable != nullptr && m_pTable->is_inline;
+   			}
+
+   			/**
+			 * @brief Is the stored value of the type T?
+			 */
+   			template<class T>
+   			bool is_type() const noexcept {
+				return m_pTable != nullptr && m_pTable->type_id == &internal::any_type_id<T>::id;
+			}
+
+		#if defined(__GXX_RTTI)
    			/**
 			 * @brief Returns the type information of the stored content.
 			 * @return the type information of the stored content or when empty then the typeid from void.
 			 */
    			const std::type_info & type() const noexcept {
-				return has_value() ? m_asyContent->type() : typeid( void );
+				return has_value() ? m_pTable->type() : typeid( void );
 			}
+		#endif
 
 			/**
 			 * @brief Get the content as pointer.
-			 * @return The content as pointer.
+			 * @return The content as pointer, nullptr when empty or a other type.
 			 */
 			template<class T>
-			const T * to_pointer() const {
-				auto* _content = static_cast<basic_any_holder_impl<T> *>( m_asyContent );
-				return &( _content->get() );
+			const T * to_pointer() const noexcept {
+				if(!is_type<T>()) return nullptr;
+				return static_cast<const T*>(m_pTable->get(const_cast<storage&>(m_sStorage)));
 			}
 
 			/**
 			 * @brief Get the content as pointer.
-			 * @return The content as pointer.
+			 * @return The content as pointer, nullptr when empty or a other type.
 			 */
 			template< class T >
-			T * to_pointer() {
-				auto* _content = static_cast<basic_any_holder_impl<T> *>( m_asyContent );
-				return &( _content->get() );
+			T * to_pointer() noexcept {
+				if(!is_type<T>()) return nullptr;
+				return static_cast<T*>(m_pTable->get(m_sStorage));
 			}
 
 			/**
 			 * @brief Assignment operator for basic_any.
 			 */
-			self_type& operator=( const self_type& other ) noexcept {
+			self_type& operator=( const self_type& other ) {
         		self_type( other ).swap( *this );
         		return *this;
     		}
@@ -214,95 +313,115 @@ namespace mofw {
 			 * @brief Assignment operator for basic_any.
 			 */
     		self_type& operator=( self_type && other ) noexcept {
-				self_type( mofw::move( other ) ).swap( *this );
+				if(this != &other) {
+					reset();
+					move_from(other);
+				}
 				return *this;
 			}
 
 			/**
 			 * @brief Assignment operator for all types.
 			 */
-			template<typename T>
-			self_type& operator=(const T& other ) noexcept {
-				construct(other);
+			template< class T, class TValue = decay_t<T>,
+					  class = enable_if_t<!is_same<TValue, self_type>::value> >
+			self_type& operator=(T&& value ) {
+				reset();
+				create<TValue>(mofw::forward<T>(value));
 				return *this;
 			}
 
 			/**
-			 * @brief emplace
+			 * @brief Destroy the value and construct a new one of the type T in place
+			 * @return The pointer to the new value, nullptr when the allocation failed
 			 */
 			template< class T, class... Args >
-			void emplace( Args && ... args ) {
-				self_type( T( mofw::forward<Args>(args)... ) ).swap( *this );
+			T* emplace( Args && ... args ) {
+				reset();
+				create<T>(mofw::forward<Args>(args)...);
+				return to_pointer<T>();
 			}
 		private:
-			/**
-			 * @brief Helper function to construct the basic_any from other basic_any.
-			 */
-			void construct(const self_type& other) {
-				if(other.has_value())
-					m_asyContent = other.m_asyContent->clone() ;
-				else
-					m_asyContent = nullptr;
+			template< class T, class... Args >
+			void create(Args&&... args) {
+				if(ops_type<T>::create(m_sStorage, m_alloCator, mofw::forward<Args>(args)...))
+					m_pTable = get_vtable<T>();
 			}
 
 			/**
-			 * @brief Helper function to construct the basic_any from value.
+			 * @brief Move the value of other in this empty any, other is empty after
 			 */
-			template< class T >
-			void construct(const T & other) {
-				m_asyContent = new  basic_any_holder_impl<T>(other) ;
+			void move_from(self_type& other) noexcept {
+				if(other.m_pTable) {
+					other.m_pTable->move(other.m_sStorage, m_sStorage);
+					m_pTable = other.m_pTable;
+					other.m_pTable = nullptr;
+				}
 			}
-
+		private:
 			/**
-			 * @brief Helper function to deconstruct.
-			 * @param bdelete Then free the content.
-			 * @note only call with true in deconstructor.
+			 * @brief The operations of the stored type, nullptr when empty
 			 */
-			void deconstruct(bool bdelete = false) {
-				mofw::destruct<content_type>(m_asyContent);
-				if(bdelete) delete m_asyContent;
-			}
-		private:
+			const vtable* m_pTable;
 			/**
-			 * @brief Holder of the value.
+			 * @brief The inline buffer or the pointer to the heap value
 			 */
-			holder_type	m_asyContent;
+			storage m_sStorage;
+			allocator_type m_alloCator;
 		};
 
-		inline void swap( basic_any& x, basic_any& y ) noexcept {
+		using any = basic_any<>;
+
+		template <class TAllocator, size_t TSIZE>
+		inline void swap( basic_any<TAllocator, TSIZE>& x, basic_any<TAllocator, TSIZE>& y ) noexcept {
 			x.swap( y );
 		}
 
 		/**
 		 * @brief Make a basic_any object.
 		 * @return The moded basic_any object.
-		 * @example basic_any x = make_any<int>(3);
+		 * @example any x = make_any<int>(3);
 		 */
 		template< class T, class ...Args >
-		inline basic_any make_any( Args&& ...args ) {
-			return basic_any( mofw::in_place_type<T>, mofw::forward<Args>(args)...);
+		inline any make_any( Args&& ...args ) {
+			any _any;
+			_any.template emplace<T>(mofw::forward<Args>(args)...);
+			return _any;
 		}
 
 		/**
 		 * @brief Cast the extractet value from a basic_any* and return it as pointer.
-		 * @return The extractet value from a basic_any* as pointer.
-		 * @example int* pTmp = any_cast<int*>(_basicAnyObj).
+		 * @return The extractet value from a basic_any* as pointer, or nullptr on a other type.
+		 * @example const int* pTmp = any_cast<int>(&_basicAnyObj).
 		 */
-		template< class T >
-		inline const T* any_cast( const basic_any* other ) noexcept {
+		template< class T, class TAllocator, size_t TSIZE >
+		inline const T* any_cast( const basic_any<TAllocator, TSIZE>* other ) noexcept {
 			if(other == nullptr) return nullptr;
-			return operand->type() == typeid(T) ? operand->to_pointer<T>() : nullptr;
+			return other->template to_pointer<T>();
 		}
 
 		/**
 		 * @brief Cast the extractet value from a basic_any* and return it as pointer.
-		 * @return The extractet value from a basic_any* as pointer.
-		 * @example int* pTmp = any_cast<int*>(_basicAnyObj).
+		 * @return The extractet value from a basic_any* as pointer, or nullptr on a other type.
+		 * @example int* pTmp = any_cast<int>(&_basicAnyObj).
 		 */
-		template<class T >
-		inline T* any_cast(basic_any* other ) noexcept {
+		template< class T, class TAllocator, size_t TSIZE >
+		inline T* any_cast( basic_any<TAllocator, TSIZE>* other ) noexcept {
 			if(other == nullptr) return nullptr;
-			return operand->type() == typeid(T) ? operand->to_pointer<T>() : nullptr;
+			return other->template to_pointer<T>();
+		}
+
+		/**
+		 * @brief Cast the extractet value from a basic_any and return a copy.
+		 * @note The type must match, asserted.
+		 * @example int iTmp = any_cast<int>(_basicAnyObj).
+		 */
+		template< class T, class TAllocator, size_t TSIZE >
+		inline T any_cast( const basic_any<TAllocator, TSIZE>& other ) {
+			const T* _value = other.template to_pointer<T>();
+
+			assert(_value != nullptr);
+			return *_value;
 		}
 	}
 }
@@ -19,126 +19,245 @@
 #define __MINLIB_ATOMIC_QUEUE_H__
 
 #include "../atomic.hpp"
+#include "../functional.hpp"
 
 namespace mofw {
 	namespace container {
 
 		/**
-         * @brief A basic lockfree atomic queue
+         * @brief A bounded lock free multi producer / multi consumer queue.
          *
-         * @tparam T         The type of an element
-         * @tparam TMAXITEMS Maximal items can queue
+         * The queue is a ring of TMAXITEMS cells, each cell has a sequence number that says
+         * if the cell is free for the producer of a round or filled for the consumer of a
+         * round. The enqueue and the dequeue position are on their own cache line, a producer
+         * claim a cell with one compare exchange on the enqueue position and publish the
+         * element with a release store of the sequence. After construction no memory is
+         * allocated.
+         *
+         * @tparam T         The type of an element, must be default constructible and movable
+         * @tparam TMAXITEMS Maximal items can queue, must be a power of two
          */
         template <class T, mofw::size_t TMAXITEMS >
         class basic_atomic_queue {
-		public:
-			struct node {
-				T data;
-				node * next;
+        	static_assert(TMAXITEMS >= 2, "TMAXITEMS must be greater then one");
+        	static_assert((TMAXITEMS & (TMAXITEMS - 1)) == 0, "TMAXITEMS must be a power of two");
+
+			struct cell {
+				mofw::atomic_size_t 	sequence;
+				T 						data;
 			};
 		public:
 			using value_type = T;
 			using reference = T&;
 			using lreference = T&&;
-			using pointer = node*;
+			using pointer = T*;
 
 			using const_value_type = const T;
 			using const_reference = const T&;
+			using size_type = mofw::size_t;
 
 			using self_type = basic_atomic_queue<T, TMAXITEMS>;
 
-			basic_atomic_queue()
-				: m_atHead(), m_curItems(0) { }
+			basic_atomic_queue() noexcept
+				: m_atEnqueue(0), m_atDequeue(0) {
+				for(size_type i = 0; i < TMAXITEMS; i++)
+					m_aCells[i].sequence.store(i, memory_order::Relaxed);
+			}
 
 			basic_atomic_queue(const self_type& other) = delete;
 			basic_atomic_queue(const self_type&& other) = delete;
+			self_type& operator = (const self_type& other) = delete;
 
 			/**
-             * @brief Push a element to the queue
-             * @param pElement The element
+             * @brief Try to push a element to the queue, never blocks
+             * @param _Element The element
+             * @return True when the element is pushed and false when the queue is full
+             */
+            bool try_push(const_reference _Element) noexcept {
+            	cell* _cell = claim_enqueue();
+
+            	if(_cell != nullptr) {
+					_cell->data = _Element;
+					publish_enqueue(_cell);
+            	}
+				return _cell != nullptr;
+            }
+
+            /**
+             * @brief Try to push a element to the queue, never blocks
+             * @param _Element The element to move in the queue
+             * @return True when the element is pushed and false when the queue is full
              */
-            bool push(reference _Element) noexcept {
-            	if(full()) return false;
+            bool try_push(lreference _Element) noexcept {
+            	cell* _cell = claim_enqueue();
 
-				node * n = new node;
-				n->data = _Element;
+            	if(_cell != nullptr) {
+					_cell->data = mofw::move(_Element);
+					publish_enqueue(_cell);
+            	}
+				return _cell != nullptr;
+            }
 
-				node* stale_head = m_atHead.load(memory_order::Release);
-				m_curItems++;
+            /**
+             * @brief Try to pop the oldest element from the queue, never blocks
+             * @param _Element Reference to hold the poped element
+             * @return True when a element is poped and false when the queue is empty
+             */
+            bool try_pop(reference _Element) noexcept {
+            	size_type _pos = m_atDequeue.load(memory_order::Relaxed);
+            	cell* _cell = nullptr;
 
-				do {
-					n->next = stale_head;
-				} while (!m_atHead.compare_exchange_weak(stale_head, n, memory_order::Release));
+            	for(;;) {
+            		_cell = &m_aCells[_pos & (TMAXITEMS - 1)];
 
-				return true;
+            		size_type _seq = _cell->sequence.load(memory_order::Acquire);
+            		intptr_t _diff = static_cast<intptr_t>(_seq) - static_cast<intptr_t>(_pos + 1);
+
+            		if(_diff == 0) {
+            			if(m_atDequeue.compare_exchange_weak(_pos, _pos + 1, memory_order::Relaxed))
+            				break;
+            		} else if(_diff < 0) {
+            			return false;
+            		} else {
+            			_pos = m_atDequeue.load(memory_order::Relaxed);
+            		}
+            	}
+            	_Element = mofw::move(_cell->data);
+            	_cell->sequence.store(_pos + TMAXITEMS, memory_order::Release);
+
+            	return true;
+            }
+
+            /**
+             * @brief Push a element to the queue, never blocks
+             * @see try_push
+             */
+            bool push(const_reference _Element) noexcept {
+            	return try_push(_Element);
+            }
+
+            /**
+             * @brief Pop a element from the queue, never blocks
+             * @see try_pop
+             */
+            bool pop(reference _Element) noexcept {
+            	return try_pop(_Element);
+            }
+
+            /**
+             * @brief Push many elements to the queue, stop when the queue is full
+             * @param _pElements The elements to push
+             * @param _count The number of elements in _pElements
+             * @return The number of pushed elements
+             */
+            size_type push_bulk(const_value_type* _pElements, size_type _count) noexcept {
+            	size_type _pushed = 0;
+
+            	while(_pushed < _count && try_push(_pElements[_pushed]))
+            		_pushed++;
+
+            	return _pushed;
             }
 
-            pointer pop_all(void) noexcept {
-				T* last = m_atHead.exchange(0, memory_order::Consume), * first = nullptr;
-				while(last) {
-					T * tmp = last;
-					last = last->next;
-					tmp->next = first;
-					first = tmp;
-				}
-				return first;
-			}
             /**
-             * @brief Clear the queue
+             * @brief Pop many elements from the queue, stop when the queue is empty
+             * @param _pElements The buffer for the poped elements
+             * @param _count The maximal number of elements to pop
+             * @return The number of poped elements
              */
-            constexpr void clear() noexcept {
-                m_queue.clear();
+            size_type pop_bulk(pointer _pElements, size_type _count) noexcept {
+            	size_type _poped = 0;
+
+            	while(_poped < _count && try_pop(_pElements[_poped]))
+            		_poped++;
+
+            	return _poped;
+            }
+
+            /**
+             * @brief Clear the queue, pop all elements
+             */
+            void clear() noexcept {
+                value_type _tmp;
+                while(try_pop(_tmp)) { }
             }
             /**
              * @brief Check, if queue is empty.
-             *
+             * @note Only a snapshot when other tasks push or pop
              * @return true The queue is empty and false when not
              */
-            constexpr bool empty() noexcept {
-                return m_curItems.load() == 0;
+            bool empty() const noexcept {
+                return size() == 0;
             }
-
-            constexpr bool full() noexcept {
-				return m_curItems.load() == TMAXITEMS;
+            /**
+             * @brief Check, if queue is full.
+             * @note Only a snapshot when other tasks push or pop
+             * @return true The queue is full and false when not
+             */
+            bool full() const noexcept {
+				return size() >= TMAXITEMS;
             }
             /**
              * @brief How many items can queue
              * @return The maximal number of entries can queue
              */
-            constexpr  mofw::size_t length() noexcept {
+            constexpr mofw::size_t length() const noexcept {
                 return TMAXITEMS;
             }
             /**
              *  How many items are currently in the queue.
+             *  @note Only a snapshot when other tasks push or pop
              *  @return the number of items in the queue.
              */
-            constexpr  mofw::size_t size() noexcept {
-                return m_curItems.load();
+            mofw::size_t size() const noexcept {
+            	size_type _tail = m_atDequeue.load(memory_order::Acquire);
+            	size_type _head = m_atEnqueue.load(memory_order::Acquire);
+
+                return (_head > _tail) ? (_head - _tail) : 0;
             }
 
             /**
              *  How many empty spaves are currently left in the queue.
              *  @return the number of remaining spaces.
              */
-            constexpr mofw::size_t left() noexcept {
-            	if(full()) return 0;
-                return TMAXITEMS - m_curItems.load();
+            mofw::size_t left() const noexcept {
+            	size_type _size = size();
+                return (_size >= TMAXITEMS) ? 0 : TMAXITEMS - _size;
             }
+		private:
+			cell* claim_enqueue() noexcept {
+				size_type _pos = m_atEnqueue.load(memory_order::Relaxed);
+				cell* _cell = nullptr;
 
-            void swap(const self_type& other)  {
-				mofw::swap(m_atHead, other.m_atHead);
-				mofw::swap(m_curItems, other.m_curItems);
-			}
+				for(;;) {
+					_cell = &m_aCells[_pos & (TMAXITEMS - 1)];
 
-            self_type& operator = (const self_type& other) {
-				m_atHead = other.m_atHead;
-				m_curItems = other.m_curItems;
+					size_type _seq = _cell->sequence.load(memory_order::Acquire);
+					intptr_t _diff = static_cast<intptr_t>(_seq) - static_cast<intptr_t>(_pos);
 
-				return *this;
-            }
-		protected:
-			mofw::_atomic<pointer> m_atHead;
-			mofw::atomic_size_t m_curItems;
+					if(_diff == 0) {
+						if(m_atEnqueue.compare_exchange_weak(_pos, _pos + 1, memory_order::Relaxed))
+							break;
+					} else if(_diff < 0) {
+						return nullptr;
+					} else {
+						_pos = m_atEnqueue.load(memory_order::Relaxed);
+					}
+				}
+				return _cell;
+			}
+
+			void publish_enqueue(cell* _cell) noexcept {
+				size_type _pos = _cell->sequence.load(memory_order::Relaxed);
+				_cell->sequence.store(_pos + 1, memory_order::Release);
+			}
+		private:
+			cell 					m_aCells[TMAXITEMS];
+			alignas(mofw::cache_line_size)
+			mofw::atomic_size_t 	m_atEnqueue;
+			alignas(mofw::cache_line_size)
+			mofw::atomic_size_t 	m_atDequeue;
+			char 					m_aPad[mofw::cache_line_size - sizeof(mofw::atomic_size_t)];
         };
 
 		template <class T, mofw::size_t TMAXITEMS = 64>
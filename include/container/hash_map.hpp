@@ -0,0 +1,663 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_BASIC_HASH_MAP_H__
+#define __MINILIB_BASIC_HASH_MAP_H__
+
+#include "../config.hpp"
+
+#include <stdint.h>
+#include <new>
+
+#include "../algorithm.hpp"
+#include "../allocator.hpp"
+#include "../functional.hpp"
+#include "../hash.hpp"
+#include "../string.hpp"
+
+#include "pair.hpp"
+
+namespace mofw {
+	namespace container {
+
+		/**
+		 * @brief The default key compare of basic_hash_map, compare with operator ==.
+		 * @note The compare is a template, so it can compare the key_type with an other type.
+		 */
+		struct hash_map_equal {
+			template <class TA, class TB>
+			bool operator () (const TA& a, const TB& b) const noexcept {
+				return a == b;
+			}
+		};
+
+		/**
+		 * @brief The transparent hasher for string keys. A basic_string, a basic_string_view and
+		 * a C string with the same chars have the same (FNV-1a) hash, so a lookup with a view or
+		 * a C string needs no temporary key.
+		 */
+		struct hash_map_string_hash {
+			template <class T>
+			result_type operator () (const T& str) const noexcept {
+				return view(str).hash();
+			}
+
+			/// Get the view of the chars of a string, a view or a C string
+			template <typename TChar>
+			static basic_string_view<TChar> view(basic_string_view<TChar> str) noexcept {
+				return str;
+			}
+			template <typename TChar, class TAllocator, size_t TSSO>
+			static basic_string_view<TChar> view(const basic_string<TChar, TAllocator, TSSO>& str) noexcept {
+				return str.view();
+			}
+			template <typename TChar>
+			static basic_string_view<TChar> view(const TChar* str) noexcept {
+				return basic_string_view<TChar>(str);
+			}
+		};
+
+		/**
+		 * @brief The transparent compare for string keys, compare the chars of a basic_string,
+		 * a basic_string_view or a C string.
+		 */
+		struct hash_map_string_equal {
+			template <class TA, class TB>
+			bool operator () (const TA& a, const TB& b) const noexcept {
+				return hash_map_string_hash::view(a).equals(hash_map_string_hash::view(b));
+			}
+		};
+
+		/**
+		 * @brief The default hasher and compare of basic_hash_map for a key type. String and
+		 * string view keys use the transparent hash_map_string_hash and hash_map_string_equal.
+		 */
+		template <class TKey>
+		struct hash_map_key_traits {
+			using hasher = mofw::hash<TKey>;
+			using key_equal = hash_map_equal;
+		};
+		template <typename TChar, class TAllocator, size_t TSSO>
+		struct hash_map_key_traits<basic_string<TChar, TAllocator, TSSO> > {
+			using hasher = hash_map_string_hash;
+			using key_equal = hash_map_string_equal;
+		};
+		template <typename TChar>
+		struct hash_map_key_traits<basic_string_view<TChar> > {
+			using hasher = hash_map_string_hash;
+			using key_equal = hash_map_string_equal;
+		};
+
+		/**
+		 * @brief Forward iterator for basic_hash_map, skip the empty slots.
+		 *
+		 * @tparam TPair The value type of the map, const for a const_iterator.
+		 */
+		template <class TPair>
+		class basic_hash_map_iterator {
+		public:
+			using iterator_category = forward_iterator_tag;
+			using value_type = TPair;
+			using pointer = TPair*;
+			using reference = TPair&;
+			using difference_type = mofw::ptrdiff_t;
+			using size_type = mofw::size_t;
+			using self_type = basic_hash_map_iterator<TPair>;
+
+			basic_hash_map_iterator() noexcept
+				: m_pSlots(nullptr), m_pDist(nullptr), m_uiIndex(0), m_uiCapacity(0) { }
+
+			basic_hash_map_iterator(pointer pSlots, const uint8_t* pDist, size_type uiIndex, size_type uiCapacity) noexcept
+				: m_pSlots(pSlots), m_pDist(pDist), m_uiIndex(uiIndex), m_uiCapacity(uiCapacity) { skip(); }
+
+			/// A iterator is convertable to a const_iterator
+			template <class TOther>
+			basic_hash_map_iterator(const basic_hash_map_iterator<TOther>& other) noexcept
+				: m_pSlots(other.m_pSlots), m_pDist(other.m_pDist),
+				  m_uiIndex(other.m_uiIndex), m_uiCapacity(other.m_uiCapacity) { }
+
+			reference operator * () const noexcept 	{ return m_pSlots[m_uiIndex]; }
+			pointer operator -> () const noexcept 	{ return &m_pSlots[m_uiIndex]; }
+
+			self_type& operator ++ () noexcept {
+				++m_uiIndex; skip();
+				return *this;
+			}
+			self_type operator ++ (int) noexcept {
+				self_type _tmp = *this;
+				++(*this);
+				return _tmp;
+			}
+
+			template <class TOther>
+			bool operator == (const basic_hash_map_iterator<TOther>& rhs) const noexcept {
+				return m_uiIndex == rhs.m_uiIndex && m_pDist == rhs.m_pDist;
+			}
+			template <class TOther>
+			bool operator != (const basic_hash_map_iterator<TOther>& rhs) const noexcept {
+				return !(*this == rhs);
+			}
+		private:
+			void skip() noexcept {
+				while(m_uiIndex < m_uiCapacity && m_pDist[m_uiIndex] == 0) ++m_uiIndex;
+			}
+		public:
+			pointer m_pSlots;
+			const uint8_t* m_pDist;
+			size_type m_uiIndex;
+			size_type m_uiCapacity;
+		};
+
+		/**
+		 * @brief A flat open addressing hash map with robin hood probing.
+		 *
+		 * All pairs are stored in one array, a second byte array holds the probe distance
+		 * of each slot (0 for a empty slot). Both arrays are one allocation from TAllocator.
+		 * A insert take the slot from a pair that is closer to his home slot (robin hood),
+		 * so a lookup can stop when the probe distance of the slot is smaller than his own.
+		 * A erase shift the following pairs back, there are no tombstones.
+		 *
+		 * The capacity is always a power of two and the table grow when the load is over
+		 * MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD percent. The hash of THash is mixed before use,
+		 * so the simple multiply hashes of mofw::hash are good enough for the low bits.
+		 *
+		 * find, contains, count and erase are templates: they can be called with any type
+		 * that THash can hash and TKeyEqual can compare with key_type (heterogeneous lookup),
+		 * the hash of the other type must be the same as the hash of the equal key. For
+		 * basic_string and basic_string_view keys the default hasher and compare accept
+		 * strings, views and C strings without a temporary key.
+		 *
+		 * @tparam TKey 		The type for the key.
+		 * @tparam TValue 		The type for the value.
+		 * @tparam THash 		The hasher for the key, default hash_map_key_traits<TKey>::hasher.
+		 * @tparam TKeyEqual 	The compare for the key, default hash_map_key_traits<TKey>::key_equal.
+		 * @tparam TAllocator 	The allocator for the table.
+		 *
+		 * @note Insert and erase invalidate all iterators, a rehash invalidate all iterators
+		 * and pointers to the pairs. The pairs are moved on displacement and rehash, so the
+		 * mapped type can be move only (use emplace to insert).
+		 * @note Not thread safe.
+		 *
+		 * @ingroup container
+		 */
+		template <class TKey, class TValue,
+				  class THash = typename hash_map_key_traits<TKey>::hasher,
+				  class TKeyEqual = typename hash_map_key_traits<TKey>::key_equal,
+				  class TAllocator = memory::default_allocator>
+		class basic_hash_map {
+		public:
+			using key_type = TKey;
+			using mapped_type = TValue;
+			using value_type = mofw::container::pair<TKey, TValue>;
+			using reference = value_type&;
+			using const_reference = const value_type&;
+			using pointer = value_type*;
+			using const_pointer = const value_type*;
+
+			using hasher = THash;
+			using key_equal = TKeyEqual;
+			using allocator_type = TAllocator;
+
+			using difference_type = mofw::ptrdiff_t;
+			using size_type = mofw::size_t;
+
+			using iterator = basic_hash_map_iterator<value_type>;
+			using const_iterator = basic_hash_map_iterator<const value_type>;
+
+			using self_type = basic_hash_map<TKey, TValue, THash, TKeyEqual, TAllocator>;
+
+			/// The smallest capacity of a not empty table
+			static constexpr size_type min_capacity = 8;
+			/// The biggest stored probe distance, longer distances are saturated
+			static constexpr uint8_t max_distance = 255;
+
+			explicit basic_hash_map(size_type uiCapacity = 0,
+									const allocator_type& allocator = allocator_type()) noexcept
+				: m_pSlots(nullptr), m_pDist(nullptr), m_uiCapacity(0), m_uiSize(0),
+				  m_allocator(allocator) {
+
+				if(uiCapacity > 0) reserve(uiCapacity);
+			}
+
+			basic_hash_map(const self_type& other)
+				: m_pSlots(nullptr), m_pDist(nullptr), m_uiCapacity(0), m_uiSize(0),
+				  m_allocator(other.m_allocator) {
+
+				copy_from(other);
+			}
+
+			basic_hash_map(self_type&& other) noexcept
+				: m_pSlots(other.m_pSlots), m_pDist(other.m_pDist), m_uiCapacity(other.m_uiCapacity),
+				  m_uiSize(other.m_uiSize), m_allocator(other.m_allocator) {
+
+				other.m_pSlots = nullptr; other.m_pDist = nullptr;
+				other.m_uiCapacity = 0; other.m_uiSize = 0;
+			}
+
+			~basic_hash_map() {
+				release();
+			}
+
+			self_type& operator = (const self_type& rhs) {
+				if(this != &rhs) {
+					clear();
+					copy_from(rhs);
+				}
+				return *this;
+			}
+
+			self_type& operator = (self_type&& rhs) noexcept {
+				if(this != &rhs) {
+					release();
+					swap(rhs);
+				}
+				return *this;
+			}
+
+			/**
+			 * @brief Inserts value, when the key not exist.
+			 * @return Returns a pair consisting of an iterator to the inserted element (or to the element that
+			 *	prevented the insertion) and a bool denoting whether the insertion took place.
+			 * When the table can not grow and is full then the iterator is end().
+			 */
+			mofw::container::pair<iterator, bool> insert(const value_type& value) {
+				return emplace_value(value.first, value_type(value));
+			}
+
+			/**
+			 * @brief insert key_type key with mapped_type value, when the key not exist.
+			 * @see insert(const value_type&)
+			 */
+			mofw::container::pair<iterator, bool> insert(const key_type& key, const mapped_type& value) {
+				return emplace_value(key, value_type(key, value));
+			}
+
+			/**
+			 * @brief Inserts a new element constructed in-place with the given args, when the key
+			 * not exist.
+			 * @see insert(const value_type&)
+			 */
+			template <class... Args>
+			mofw::container::pair<iterator, bool> emplace(const key_type& key, Args&&... args) {
+				size_type _index = find_index(key);
+
+				if(_index != npos)
+					return mofw::container::pair<iterator, bool>(make_iterator(_index), false);
+
+				mapped_type _value(mofw::forward<Args>(args)...);
+				key_type _key(key);
+
+				return insert_new(key, value_type(mofw::move(_key), mofw::move(_value)));
+			}
+
+			/**
+			 * @brief Insert the value, or assign it to the element when the key exist.
+			 * @return True when the value is inserted and false when assigned.
+			 */
+			bool insert_or_assign(const key_type& key, const mapped_type& value) {
+				size_type _index = find_index(key);
+
+				if(_index != npos) {
+					m_pSlots[_index].second = value;
+					return false;
+				}
+				return insert_new(key, value_type(key, value)).second;
+			}
+
+			/**
+			 * @brief Get the value for the key, when the key not exist then insert a default
+			 * constructed value.
+			 */
+			mapped_type& operator [] (const key_type& key) {
+				return emplace(key).first->second;
+			}
+
+			/**
+			 * @brief Finds an element with a key equal to key.
+			 * @return The iterator to the element or end().
+			 */
+			template <class K>
+			iterator find(const K& key) noexcept {
+				size_type _index = find_index(key);
+				return (_index == npos) ? end() : make_iterator(_index);
+			}
+			template <class K>
+			const_iterator find(const K& key) const noexcept {
+				size_type _index = find_index(key);
+				return (_index == npos) ? end() : make_iterator(_index);
+			}
+
+			/**
+			 * @brief Get a pointer to the value of the key.
+			 * @return The pointer to the value or nullptr when the key not exist.
+			 */
+			template <class K>
+			mapped_type* get(const K& key) noexcept {
+				size_type _index = find_index(key);
+				return (_index == npos) ? nullptr : &m_pSlots[_index].second;
+			}
+			template <class K>
+			const mapped_type* get(const K& key) const noexcept {
+				size_type _index = find_index(key);
+				return (_index == npos) ? nullptr : &m_pSlots[_index].second;
+			}
+
+			/**
+			 * @brief Is a element with the key in the map.
+			 */
+			template <class K>
+			bool contains(const K& key) const noexcept {
+				return find_index(key) != npos;
+			}
+
+			/**
+			 * @brief Returns the number of elements with key key, 1 or 0.
+			 */
+			template <class K>
+			size_type count(const K& key) const noexcept {
+				return (find_index(key) != npos) ? 1 : 0;
+			}
+
+			/**
+			 * @brief Removes the element with the key equivalent to key.
+			 * @return Number of elements removed (0 or 1).
+			 */
+			template <class K>
+			size_type erase(const K& key) {
+				size_type _index = find_index(key);
+
+				if(_index == npos) return 0;
+
+				erase_index(_index);
+				return 1;
+			}
+
+			/**
+			 * @brief Removes the element at the given position.
+			 * @return The iterator to the next element, a erase can move the next element in
+			 * this slot.
+			 * @note When the backward shift wraps around the end of the table, the element from
+			 * slot 0 is moved into the last slot. A erase-while-iterating loop from begin() then
+			 * visits this element a second time, it never skips a element.
+			 */
+			iterator erase(const_iterator pos) {
+				size_type _index = pos.m_uiIndex;
+
+				if(_index >= m_uiCapacity || m_pDist[_index] == 0) return end();
+
+				erase_index(_index);
+				return make_iterator(_index);
+			}
+
+			/**
+			 * @brief Destroy all elements, the capacity is not changed.
+			 */
+			void clear() {
+				for(size_type i = 0; i < m_uiCapacity; i++) {
+					if(m_pDist[i] != 0) {
+						m_pSlots[i].~value_type();
+						m_pDist[i] = 0;
+					}
+				}
+				m_uiSize = 0;
+			}
+
+			/**
+			 * @brief Reserve space for at least uiCount elements without a rehash.
+			 * @return True on success and false when the allocation failed.
+			 */
+			bool reserve(size_type uiCount) {
+				return rehash( (uiCount * 100 + MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD - 1)
+								/ MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD );
+			}
+
+			/**
+			 * @brief Set the number of slots to at least uiCount and rehash all elements.
+			 *
+			 * The new capacity is the next power of two, but never less as needed for the
+			 * current elements. rehash(0) shrinks the table to fit.
+			 * @return True on success and false when the allocation failed.
+			 */
+			bool rehash(size_type uiCount) {
+				size_type _needed = (m_uiSize * 100 + MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD - 1)
+										/ MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD;
+				if(uiCount < _needed) uiCount = _needed;
+
+				size_type _capacity = 0;
+
+				if(uiCount > 0) _capacity = min_capacity;
+				while(_capacity < uiCount) _capacity <<= 1;
+
+				if(_capacity == m_uiCapacity) return true;
+
+				return rehash_to(_capacity);
+			}
+
+			/**
+			 * @brief Exchanges the contents of the container with those of other.
+			 */
+			void swap(self_type& other) noexcept {
+				mofw::swap(m_pSlots, other.m_pSlots);
+				mofw::swap(m_pDist, other.m_pDist);
+				mofw::swap(m_uiCapacity, other.m_uiCapacity);
+				mofw::swap(m_uiSize, other.m_uiSize);
+				mofw::swap(m_allocator, other.m_allocator);
+			}
+
+			iterator begin() noexcept 				{ return iterator(m_pSlots, m_pDist, 0, m_uiCapacity); }
+			iterator end() noexcept 				{ return iterator(m_pSlots, m_pDist, m_uiCapacity, m_uiCapacity); }
+			const_iterator begin() const noexcept 	{ return const_iterator(m_pSlots, m_pDist, 0, m_uiCapacity); }
+			const_iterator end() const noexcept 	{ return const_iterator(m_pSlots, m_pDist, m_uiCapacity, m_uiCapacity); }
+
+			/// Is the map empty
+			bool empty() const noexcept 			{ return m_uiSize == 0; }
+			/// Get the number of elements
+			size_type size() const noexcept 		{ return m_uiSize; }
+			/// Get the number of slots
+			size_type capacity() const noexcept 	{ return m_uiCapacity; }
+			/// Get the current load in percent
+			size_type load() const noexcept 		{ return m_uiCapacity ? (m_uiSize * 100) / m_uiCapacity : 0; }
+			/// Get the number of used bytes for the table
+			size_type get_memory_usage() const noexcept { return m_uiCapacity * (sizeof(value_type) + 1); }
+		private:
+			static constexpr size_type npos = size_type(-1);
+
+			template <class K>
+			size_type home_index(const K& key) const noexcept {
+				return mofw::hash_mix(hasher{}(key)) & (m_uiCapacity - 1);
+			}
+
+			template <class K>
+			size_type find_index(const K& key) const noexcept {
+				if(m_uiSize == 0) return npos;
+
+				const size_type _mask = m_uiCapacity - 1;
+				size_type _index = home_index(key);
+				uint8_t _dist = 1;
+
+				// a slot closer to his home as we are to our home ends the search
+				while(m_pDist[_index] >= _dist) {
+					if(key_equal{}(m_pSlots[_index].first, key)) return _index;
+
+					_index = (_index + 1) & _mask;
+					if(_dist < max_distance) _dist++;
+				}
+				return npos;
+			}
+
+			mofw::container::pair<iterator, bool> emplace_value(const key_type& key, value_type&& value) {
+				size_type _index = find_index(key);
+
+				if(_index != npos)
+					return mofw::container::pair<iterator, bool>(make_iterator(_index), false);
+
+				return insert_new(key, mofw::move(value));
+			}
+
+			/**
+			 * @brief Insert a element with a not existing key, grow the table when needed.
+			 */
+			mofw::container::pair<iterator, bool> insert_new(const key_type& key, value_type&& value) {
+				if( (m_uiSize + 1) * 100 > m_uiCapacity * MN_THREAD_CONFIG_HASH_MAP_MAX_LOAD ) {
+					size_type _capacity = m_uiCapacity * 2;
+					if(_capacity == 0) _capacity = min_capacity;
+
+					// when the grow failed then use the free slots
+					if(!rehash_to(_capacity) && m_uiSize >= m_uiCapacity)
+						return mofw::container::pair<iterator, bool>(end(), false);
+				}
+				place(m_pSlots, m_pDist, m_uiCapacity, value);
+				m_uiSize++;
+
+				return mofw::container::pair<iterator, bool>(make_iterator(find_index(key)), true);
+			}
+
+			/**
+			 * @brief Robin hood placement of value into the given table, there must be a free slot.
+			 * The value is moved into the table, displaced elements are swapped out by move.
+			 */
+			static void place(pointer pSlots, uint8_t* pDist, size_type uiCapacity, value_type& value) {
+				const size_type _mask = uiCapacity - 1;
+				size_type _index = mofw::hash_mix(hasher{}(value.first)) & _mask;
+				uint8_t _dist = 1;
+
+				while(pDist[_index] != 0) {
+					// take the slot from the richer element and go on with it
+					if(pDist[_index] < _dist) {
+						mofw::swap(pSlots[_index], value);
+						mofw::swap(pDist[_index], _dist);
+					}
+					_index = (_index + 1) & _mask;
+					if(_dist < max_distance) _dist++;
+				}
+				new (&pSlots[_index]) value_type(mofw::move(value));
+				pDist[_index] = _dist;
+			}
+
+			/**
+			 * @brief Remove the element in the slot and shift the following elements back.
+			 */
+			void erase_index(size_type _index) {
+				const size_type _mask = m_uiCapacity - 1;
+				size_type _next = (_index + 1) & _mask;
+
+				m_pSlots[_index].~value_type();
+				m_pDist[_index] = 0;
+
+				while(m_pDist[_next] > 1) {
+					new (&m_pSlots[_index]) value_type(mofw::move(m_pSlots[_next]));
+					m_pSlots[_next].~value_type();
+
+					// a saturated distance stay saturated, the real distance is unknown
+					m_pDist[_index] = m_pDist[_next];
+					if(m_pDist[_index] != max_distance) m_pDist[_index]--;
+					m_pDist[_next] = 0;
+
+					_index = _next;
+					_next = (_next + 1) & _mask;
+				}
+				m_uiSize--;
+			}
+
+			bool rehash_to(size_type uiCapacity) {
+				pointer _pSlots = nullptr;
+				uint8_t* _pDist = nullptr;
+
+				if(uiCapacity > 0) {
+					void* _mem = m_allocator.allocate(block_size(uiCapacity),
+										mofw::alignment_for(sizeof(value_type)));
+					if(_mem == nullptr) return false;
+
+					_pSlots = static_cast<pointer>(_mem);
+					_pDist = reinterpret_cast<uint8_t*>(_pSlots + uiCapacity);
+
+					for(size_type i = 0; i < uiCapacity; i++) _pDist[i] = 0;
+				}
+
+				for(size_type i = 0; i < m_uiCapacity; i++) {
+					if(m_pDist[i] == 0) continue;
+
+					place(_pSlots, _pDist, uiCapacity, m_pSlots[i]);
+					m_pSlots[i].~value_type();
+				}
+				free_table();
+
+				m_pSlots = _pSlots;
+				m_pDist = _pDist;
+				m_uiCapacity = uiCapacity;
+
+				return true;
+			}
+
+			void copy_from(const self_type& other) {
+				if(other.m_uiSize == 0 || !reserve(other.m_uiSize)) return;
+
+				for(size_type i = 0; i < other.m_uiCapacity; i++) {
+					if(other.m_pDist[i] == 0) continue;
+
+					value_type _value(other.m_pSlots[i]);
+					place(m_pSlots, m_pDist, m_uiCapacity, _value);
+					m_uiSize++;
+				}
+			}
+
+			void release() {
+				clear();
+				free_table();
+
+				m_pSlots = nullptr;
+				m_pDist = nullptr;
+				m_uiCapacity = 0;
+			}
+
+			void free_table() {
+				if(m_pSlots != nullptr)
+					m_allocator.deallocate(m_pSlots, block_size(m_uiCapacity),
+										mofw::alignment_for(sizeof(value_type)));
+			}
+
+			static constexpr size_type block_size(size_type uiCapacity) noexcept {
+				return uiCapacity * (sizeof(value_type) + 1);
+			}
+
+			iterator make_iterator(size_type _index) noexcept {
+				return iterator(m_pSlots, m_pDist, _index, m_uiCapacity);
+			}
+			const_iterator make_iterator(size_type _index) const noexcept {
+				return const_iterator(m_pSlots, m_pDist, _index, m_uiCapacity);
+			}
+		private:
+			pointer m_pSlots;
+			uint8_t* m_pDist;
+			size_type m_uiCapacity;
+			size_type m_uiSize;
+			allocator_type m_allocator;
+		};
+
+		/**
+		 * @brief A flat open addressing hash map.
+		 * @tparam TKey The type for the key.
+		 * @tparam TValue The type for the value.
+		 *
+		 * @ingroup container
+		 */
+		template <class TKey, class TValue, class THash = mofw::hash<TKey> >
+		using hash_map = basic_hash_map<TKey, TValue, THash>;
+	}
+}
+
+#endif // __MINILIB_BASIC_HASH_MAP_H__
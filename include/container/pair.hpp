@@ -42,11 +42,15 @@ namespace mofw {
 
 			explicit basic_pair(const reference_first a) noexcept
 				: first(a) { }
-			basic_pair(const reference_first a, reference_second b)
+			basic_pair(const_reference_first a, const_reference_second b)
 				: first(a), second(b) { }
+			basic_pair(first_type&& a, second_type&& b)
+				: first(mofw::move(a)), second(mofw::move(b)) { }
 
 			basic_pair(const self_type& other) noexcept
 				: first(other.first), second(other.second) { }
+			basic_pair(self_type&& other) noexcept
+				: first(mofw::move(other.first)), second(mofw::move(other.second)) { }
 
 			void swap(const self_type& other) noexcept {
 				self_type _temp(this);
@@ -58,6 +62,11 @@ namespace mofw {
 				second = rhs.second;
 				return *this;
 			}
+			self_type& operator = (self_type&& rhs) noexcept {
+				first = mofw::move(rhs.first);
+				second = mofw::move(rhs.second);
+				return *this;
+			}
 
 			bool operator == (const self_type& rhs) noexcept {
 				if(first != rhs.first) return false;
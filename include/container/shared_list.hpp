@@ -26,7 +26,7 @@
 #include "list.hpp"
 
 #include "../autolock.hpp"
-#include "../pointer/mn_shared_ptr.hpp"
+#include "../pointer/shared_ptr.hpp"
 
 #include <list>
 namespace mofw {
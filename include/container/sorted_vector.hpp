@@ -22,7 +22,7 @@
 
 #include "../functional.hpp"
 #include "pair.hpp"
-#include "../utils/mn_sort.hpp"
+#include "../utils/sort.hpp"
 #include "vector.hpp"
 
 namespace mofw {
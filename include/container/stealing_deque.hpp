@@ -0,0 +1,153 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINLIB_STEALING_DEQUE_H__
+#define __MINLIB_STEALING_DEQUE_H__
+
+#include "../config.hpp"
+
+#include "../atomic.hpp"
+
+namespace mofw {
+	namespace container {
+
+		/**
+		 * @brief A bounded Chase-Lev work stealing deque of pointers.
+		 *
+		 * Only the owner task push and pop at the bottom (LIFO), all other tasks can steal
+		 * from the top (FIFO). Push and pop of the owner are without compare exchange, only the
+		 * race for the last element and steal use a compare exchange on the top position. The
+		 * top and the bottom position are on their own cache line.
+		 *
+		 * @tparam T 		 The pointed type, the deque store T*
+		 * @tparam TCAPACITY The maximal number of elements, must be a power of two
+		 */
+		template <class T, mofw::size_t TCAPACITY>
+		class basic_stealing_deque {
+			static_assert(TCAPACITY >= 2, "TCAPACITY must be greater then one");
+			static_assert((TCAPACITY & (TCAPACITY - 1)) == 0, "TCAPACITY must be a power of two");
+		public:
+			using value_type = T*;
+			using reference = T*&;
+			using size_type = mofw::size_t;
+			using self_type = basic_stealing_deque<T, TCAPACITY>;
+
+			basic_stealing_deque() noexcept
+				: m_atTop(0), m_atBottom(0) { }
+
+			basic_stealing_deque(const self_type& other) = delete;
+			self_type& operator = (const self_type& other) = delete;
+
+			/**
+			 * @brief Push a element at the bottom, only call from the owner
+			 * @param _pElement The element
+			 * @return True when the element is pushed and false when the deque is full
+			 */
+			bool push(value_type _pElement) noexcept {
+				long _bottom = m_atBottom.load(memory_order::Relaxed);
+				long _top = m_atTop.load(memory_order::Acquire);
+
+				if(_bottom - _top >= static_cast<long>(TCAPACITY)) return false;
+
+				m_aBuffer[_bottom & (TCAPACITY - 1)].store(_pElement, memory_order::Relaxed);
+				mofw::atomic_thread_fence(memory_order::Release);
+				m_atBottom.store(_bottom + 1, memory_order::Relaxed);
+
+				return true;
+			}
+
+			/**
+			 * @brief Pop the newest element from the bottom, only call from the owner
+			 * @param _pElement The reference for the poped element
+			 * @return True when a element is poped and false when the deque is empty
+			 */
+			bool pop(reference _pElement) noexcept {
+				long _bottom = m_atBottom.load(memory_order::Relaxed) - 1;
+				bool _ret = false;
+
+				m_atBottom.store(_bottom, memory_order::Relaxed);
+				mofw::atomic_thread_fence(memory_order::SeqCst);
+
+				long _top = m_atTop.load(memory_order::Relaxed);
+
+				if(_top <= _bottom) {
+					_pElement = m_aBuffer[_bottom & (TCAPACITY - 1)].load(memory_order::Relaxed);
+					_ret = true;
+
+					if(_top == _bottom) {
+						// the last element, race with the thiefs
+						_ret = m_atTop.compare_exchange_strong(_top, _top + 1, memory_order::SeqCst);
+						m_atBottom.store(_bottom + 1, memory_order::Relaxed);
+					}
+				} else {
+					m_atBottom.store(_bottom + 1, memory_order::Relaxed);
+				}
+				return _ret;
+			}
+
+			/**
+			 * @brief Steal the oldest element from the top, can call from any task
+			 * @param _pElement The reference for the stolen element
+			 * @return True when a element is stolen and false when the deque is empty or a
+			 * other task was faster
+			 */
+			bool steal(reference _pElement) noexcept {
+				long _top = m_atTop.load(memory_order::Acquire);
+				mofw::atomic_thread_fence(memory_order::SeqCst);
+				long _bottom = m_atBottom.load(memory_order::Acquire);
+				bool _ret = false;
+
+				if(_top < _bottom) {
+					value_type _element = m_aBuffer[_top & (TCAPACITY - 1)].load(memory_order::Relaxed);
+
+					if(m_atTop.compare_exchange_strong(_top, _top + 1, memory_order::SeqCst)) {
+						_pElement = _element;
+						_ret = true;
+					}
+				}
+				return _ret;
+			}
+
+			/**
+			 * @brief Get the number of elements
+			 * @note Only a snapshot when other tasks push, pop or steal
+			 */
+			size_type size() const noexcept {
+				long _bottom = m_atBottom.load(memory_order::Acquire);
+				long _top = m_atTop.load(memory_order::Acquire);
+
+				return (_bottom > _top) ? static_cast<size_type>(_bottom - _top) : 0;
+			}
+
+			bool empty() const noexcept 				{ return size() == 0; }
+			constexpr size_type length() const noexcept { return TCAPACITY; }
+		private:
+			mofw::_atomic_ptr<T> 	m_aBuffer[TCAPACITY];
+
+			alignas(mofw::cache_line_size)
+			mofw::atomic_long 		m_atTop;
+
+			alignas(mofw::cache_line_size)
+			mofw::atomic_long 		m_atBottom;
+		};
+
+		template <class T, mofw::size_t TCAPACITY = 64>
+		using stealing_deque = basic_stealing_deque<T, TCAPACITY>;
+	}
+}
+
+#endif // __MINLIB_STEALING_DEQUE_H__
@@ -0,0 +1,378 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINLIB_TIMING_WHEEL_H__
+#define __MINLIB_TIMING_WHEEL_H__
+
+#include "../config.hpp"
+
+#include <stdint.h>
+#include <stddef.h>
+
+namespace mofw {
+	namespace container {
+
+		template <class TNode, unsigned int TBITS, unsigned int TLEVELS>
+		class basic_timing_wheel;
+
+		/**
+		 * @brief The intrusive link of a timing wheel element, derive the element from this.
+		 */
+		class timing_wheel_node {
+			template <class TNode, unsigned int TBITS, unsigned int TLEVELS>
+			friend class basic_timing_wheel;
+		public:
+			timing_wheel_node() noexcept
+				: m_pNext(nullptr), m_ppPrev(nullptr), m_uiExpire(0) { }
+
+			timing_wheel_node(const timing_wheel_node&) = delete;
+			timing_wheel_node& operator = (const timing_wheel_node&) = delete;
+
+			/**
+			 * @brief Is the element in a wheel?
+			 */
+			bool is_linked() const noexcept { return m_ppPrev != nullptr; }
+			/**
+			 * @brief Get the tick on that the element expires
+			 */
+			uint32_t get_expire() const noexcept { return m_uiExpire; }
+		private:
+			timing_wheel_node*  m_pNext;
+			timing_wheel_node** m_ppPrev;
+			uint32_t 			m_uiExpire;
+		};
+
+		/**
+		 * @brief A hierarchical timing wheel with intrusive elements.
+		 *
+		 * Each level has 2^TBITS slots, a slot of level n covers 2^(TBITS * n) ticks.
+		 * Insert and erase are O(1), a tick touches only the elements of the current slot
+		 * and every 2^TBITS ticks the elements of one slot of the next level are moved down.
+		 * Delays greater then max_delay are moved down in steps of max_delay.
+		 *
+		 * A tick can be split in begin_advance, that detach the slots of the tick in O(1),
+		 * and advance_one, that move down or expire one detached element. So a owner that
+		 * guard the wheel with a critical section never hold it longer as O(1).
+		 *
+		 * The wheel is not thread safe and allocates no memory.
+		 *
+		 * @tparam TNode 	The element type, must be derived from timing_wheel_node
+		 * @tparam TBITS 	The number of bits per level (slots = 2^TBITS)
+		 * @tparam TLEVELS 	The number of levels
+		 */
+		template <class TNode, unsigned int TBITS = 6, unsigned int TLEVELS = 4>
+		class basic_timing_wheel {
+			static_assert(TBITS > 0 && TLEVELS > 0, "TBITS and TLEVELS must be greater then zero");
+			static_assert(TBITS * TLEVELS < 32, "TBITS * TLEVELS must be less then 32");
+		public:
+			using value_type = TNode;
+			using pointer = TNode*;
+			using node_type = timing_wheel_node;
+			using tick_type = uint32_t;
+			using size_type = size_t;
+			using self_type = basic_timing_wheel<TNode, TBITS, TLEVELS>;
+
+			static constexpr tick_type slots = tick_type(1) << TBITS;
+			static constexpr tick_type max_delay = (tick_type(1) << (TBITS * TLEVELS)) - 1;
+
+			basic_timing_wheel() noexcept
+				: m_uiNow(0), m_szCount(0) {
+
+				for(unsigned int l = 0; l < TLEVELS; l++) {
+					for(tick_type s = 0; s < slots; s++) m_pSlots[l][s] = nullptr;
+					m_pDetached[l] = nullptr;
+				}
+			}
+
+			basic_timing_wheel(const self_type&) = delete;
+			self_type& operator = (const self_type&) = delete;
+
+			/**
+			 * @brief Insert a element that expires in delay ticks
+			 * @param pNode The element, must not be in a wheel
+			 * @param delay The delay in ticks, 0 is handled as 1
+			 * @return False when the element is already in a wheel
+			 */
+			bool insert(pointer pNode, tick_type delay) noexcept {
+				node_type* _node = static_cast<node_type*>(pNode);
+				if(_node->is_linked()) return false;
+
+				_node->m_uiExpire = m_uiNow + (delay == 0 ? 1 : delay);
+				link(_node);
+
+				m_szCount++;
+				return true;
+			}
+
+			/**
+			 * @brief Remove a element from the wheel
+			 * @return False when the element is not in a wheel
+			 */
+			bool erase(pointer pNode) noexcept {
+				node_type* _node = static_cast<node_type*>(pNode);
+				if(!_node->is_linked()) return false;
+
+				unlink(_node);
+				return true;
+			}
+
+			/**
+			 * @brief Advance the wheel one tick and call fn(TNode*) for each expired element.
+			 *
+			 * The element is removed before fn is called, so fn can insert it again or erase
+			 * any other element.
+			 * @return The number of expired elements
+			 */
+			template <class TFunc>
+			size_type advance(TFunc fn) {
+				size_type _expired = 0;
+
+				begin_advance();
+				while(advance_one([&_expired, &fn](pointer pNode) { fn(pNode); _expired++; })) { }
+
+				return _expired;
+			}
+
+			/**
+			 * @brief Advance the wheel one tick and detach the slots that must be moved down
+			 * and the slot of the expired elements, O(TLEVELS).
+			 *
+			 * The detached elements are still in the wheel and can be erased, call advance_one
+			 * until it returns false before the next begin_advance.
+			 */
+			void begin_advance() noexcept {
+				m_uiNow++;
+
+				tick_type _idx = m_uiNow & (slots - 1);
+
+				if(_idx == 0) {
+					for(unsigned int l = 1; l < TLEVELS; l++) {
+						tick_type _sub = (m_uiNow >> (TBITS * l)) & (slots - 1);
+						detach(m_pSlots[l][_sub], m_pDetached[l]);
+
+						if(_sub != 0) break;
+					}
+				}
+				detach(m_pSlots[0][_idx], m_pDetached[0]);
+			}
+
+			/**
+			 * @brief Handle one detached element of the current tick, O(1).
+			 *
+			 * Elements of a higher level are moved down first, a element that expires at the
+			 * current tick joins the expired elements. Then the expired elements are removed
+			 * one by one and fn(TNode*) is called.
+			 * @return True when a element was handled and false when the tick is done.
+			 */
+			template <class TFunc>
+			bool advance_one(TFunc fn) {
+				node_type* _node = nullptr;
+				bool _handled = true;
+
+				for(unsigned int l = 1; l < TLEVELS && _node == nullptr; l++)
+					_node = m_pDetached[l];
+
+				if(_node != nullptr) {
+					remove(_node);
+
+					if(_node->m_uiExpire == m_uiNow)
+						push(m_pDetached[0], _node);
+					else
+						link(_node);
+				} else if(m_pDetached[0] != nullptr) {
+					_node = m_pDetached[0];
+					unlink(_node);
+
+					fn(static_cast<pointer>(_node));
+				} else {
+					_handled = false;
+				}
+				return _handled;
+			}
+
+			/**
+			 * @brief Is a tick started with begin_advance not done
+			 */
+			bool is_advancing() const noexcept {
+				bool _advancing = false;
+
+				for(unsigned int l = 0; l < TLEVELS; l++)
+					_advancing = _advancing || (m_pDetached[l] != nullptr);
+
+				return _advancing;
+			}
+
+			/**
+			 * @brief Get the number of ticks until the next tick that can expire a element.
+			 *
+			 * A element in a higher level is counted at the tick of his next move down, so
+			 * the result is never later then the first expiry. O(TLEVELS * 2^TBITS)
+			 * @return The ticks, 0 when a tick is not done and max_delay + 1 when the wheel is empty
+			 */
+			tick_type next_expire() const noexcept {
+				tick_type _next = max_delay + 1;
+
+				if(is_advancing()) {
+					_next = 0;
+				} else if(m_szCount > 0) {
+					for(tick_type d = 1; d < slots && _next > max_delay; d++) {
+						if(m_pSlots[0][(m_uiNow + d) & (slots - 1)] != nullptr) _next = d;
+					}
+					// the lowest used level moves down first, higher levels move at multiples of it
+					bool _used = false;
+
+					for(unsigned int l = 1; l < TLEVELS && !_used; l++) {
+						for(tick_type s = 0; s < slots && !_used; s++)
+							_used = (m_pSlots[l][s] != nullptr);
+
+						if(_used) {
+							tick_type _span = tick_type(1) << (TBITS * l);
+							tick_type _move = _span - (m_uiNow & (_span - 1));
+
+							if(_move < _next) _next = _move;
+						}
+					}
+				}
+				return _next;
+			}
+
+			/**
+			 * @brief Set the time of the wheel up to ticks ticks forward, but only over ticks
+			 * that expire or move down no element. O(TLEVELS * 2^TBITS), O(1) when empty.
+			 * @return The number of skipped ticks, the remaining ticks must be advanced.
+			 */
+			tick_type skip(tick_type ticks) noexcept {
+				tick_type _next = next_expire();
+
+				if(m_szCount > 0 && ticks >= _next)
+					ticks = (_next > 0) ? _next - 1 : 0;
+
+				m_uiNow += ticks;
+				return ticks;
+			}
+
+			/**
+			 * @brief Advance the wheel ticks ticks, see advance(TFunc)
+			 */
+			template <class TFunc>
+			size_type advance(tick_type ticks, TFunc fn) {
+				size_type _expired = 0;
+
+				for(; ticks > 0; ticks--) {
+					if(m_szCount == 0) { m_uiNow += ticks; break; }
+
+					_expired += advance(fn);
+				}
+				return _expired;
+			}
+
+			/**
+			 * @brief Remove all elements
+			 */
+			void clear() noexcept {
+				for(unsigned int l = 0; l < TLEVELS; l++) {
+					for(tick_type s = 0; s < slots; s++) {
+						node_type* _node = m_pSlots[l][s];
+
+						while(_node != nullptr) {
+							node_type* _next = _node->m_pNext;
+							_node->m_pNext = nullptr; _node->m_ppPrev = nullptr;
+							_node = _next;
+						}
+						m_pSlots[l][s] = nullptr;
+					}
+					node_type* _node = m_pDetached[l];
+
+					while(_node != nullptr) {
+						node_type* _next = _node->m_pNext;
+						_node->m_pNext = nullptr; _node->m_ppPrev = nullptr;
+						_node = _next;
+					}
+					m_pDetached[l] = nullptr;
+				}
+				m_szCount = 0;
+			}
+
+			/**
+			 * @brief Remove all elements and set the current tick to 0
+			 */
+			void reset() noexcept { clear(); m_uiNow = 0; }
+
+			/**
+			 * @brief Get the current tick of the wheel
+			 */
+			tick_type now() const noexcept { return m_uiNow; }
+			/**
+			 * @brief Get the number of elements in the wheel
+			 */
+			size_type size() const noexcept { return m_szCount; }
+
+			bool empty() const noexcept { return m_szCount == 0; }
+		private:
+			void link(node_type* _node) noexcept {
+				tick_type _delta = _node->m_uiExpire - m_uiNow;
+				tick_type _expire = _node->m_uiExpire;
+				unsigned int _level = 0;
+
+				if(_delta > max_delay) {
+					_expire = m_uiNow + max_delay;
+					_level = TLEVELS - 1;
+				} else {
+					while(_level < TLEVELS - 1 && _delta >= (tick_type(1) << (TBITS * (_level + 1))))
+						_level++;
+				}
+				push(m_pSlots[_level][(_expire >> (TBITS * _level)) & (slots - 1)], _node);
+			}
+
+			static void push(node_type*& head, node_type* _node) noexcept {
+				_node->m_pNext = head;
+				if(head != nullptr) head->m_ppPrev = &_node->m_pNext;
+
+				_node->m_ppPrev = &head;
+				head = _node;
+			}
+
+			/** move the list from head to target, target must be empty */
+			static void detach(node_type*& head, node_type*& target) noexcept {
+				target = head;
+				head = nullptr;
+
+				if(target != nullptr) target->m_ppPrev = &target;
+			}
+
+			static void remove(node_type* _node) noexcept {
+				*_node->m_ppPrev = _node->m_pNext;
+				if(_node->m_pNext != nullptr) _node->m_pNext->m_ppPrev = _node->m_ppPrev;
+
+				_node->m_pNext = nullptr; _node->m_ppPrev = nullptr;
+			}
+
+			void unlink(node_type* _node) noexcept {
+				remove(_node);
+				m_szCount--;
+			}
+		private:
+			node_type* m_pSlots[TLEVELS][slots];
+			/** The lists of the current tick: [0] the expired elements, [n] the elements to move down from level n */
+			node_type* m_pDetached[TLEVELS];
+			tick_type  m_uiNow;
+			size_type  m_szCount;
+		};
+	}
+}
+
+#endif // __MINLIB_TIMING_WHEEL_H__
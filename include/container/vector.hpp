@@ -49,7 +49,7 @@ namespace mofw {
 
             void reallocate(size_type newCapacity, size_type oldSize) {
 
-            	void* mem = m_allocator.allocate(newCapacity, sizeof(value_type) );
+            	void* mem = m_allocator.allocate(newCapacity, sizeof(value_type), mofw::alignment_for(sizeof(value_type)) );
                 pointer newBegin = new (mem) value_type();
 
                 const size_type newSize = oldSize < newCapacity ? oldSize : newCapacity;
@@ -66,7 +66,7 @@ namespace mofw {
             void reallocate_discard_old(size_type newCapacity) {
                 assert(newCapacity > size_type(m_capacityEnd - m_begin));
 
-                void* mem = m_allocator.allocate(newCapacity, sizeof(value_type) );
+                void* mem = m_allocator.allocate(newCapacity, sizeof(value_type), mofw::alignment_for(sizeof(value_type)) );
                 pointer newBegin = new (mem) value_type();
 
 
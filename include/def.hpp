@@ -53,6 +53,7 @@ namespace mofw {
 
     const size_t default_alignment = alignof(void*);
 	constexpr size_t max_alignment = alignof(max_align_t);
+	constexpr size_t cache_line_size = MN_THREAD_CONFIG_CACHE_LINE_SIZE;
 
 	using ::clock_t;
 	using ::time_t;
@@ -201,12 +201,15 @@
 #define ERR_WORKQUEUE_ADD                   0x7005		/*!< The item can not add to the workqueue */
 
 #define ERR_MEMPOOL_OK                    	NO_ERROR 	/*!< No error*/
+#define ERR_MEMPOOL_ALREADYINIT           	0x8001 		/*!< The mempool is allready created */
+#define ERR_MEMPOOL_INUSE                 	0x8002 		/*!< The mempool has memory in use */
 #define ERR_MEMPOOL_BADALIGNMENT          	0x8003 		/*!< The given ligent im mempool are bad */
 #define ERR_MEMPOOL_CREATE                	0x8004 		/*!< The mempool can not create */
 #define ERR_MEMPOOL_MIN                   	0x8005 		/*!< Reserve */
 
 #define ERR_TICKHOOK_OK                   	NO_ERROR	/*!< No Error in one of the tickhook function */
 #define ERR_TICKHOOK_ADD                  	0x9001 		/*!< Error to add a new tickhook*/
+#define ERR_TICKHOOK_REMOVE                	0x9002 		/*!< The tickhook is not in the list */
 #define ERR_TICKHOOK_ENTRY_NULL          	0x900A 		/*!< The entry is null */
 
 #define ERR_MN_WIFI_OK          		  	NO_ERROR
@@ -70,7 +70,7 @@ namespace mofw {
 	 */
 	template<typename T>
 	struct hash {
-		const result_type operator()(T& t) const noexcept {
+		const result_type operator()(const T& t) const noexcept {
 			return internal::rjenkins_hash(t);
 		}
 	};
@@ -158,6 +158,35 @@ namespace mofw {
 		}
     };
 
+	/**
+	 * @brief Mix the bits of a hash, so that the low bits depend on all bits.
+	 * The hash of mofw::hash for integers is only a multiply, use this befor use the
+	 * low bits as a table index. (murmur3 finalizer)
+	 */
+	inline result_type hash_mix(result_type _hash) noexcept {
+		uint32_t _h = static_cast<uint32_t>(_hash);
+
+		_h ^= _h >> 16; _h *= 0x85ebca6bU;
+		_h ^= _h >> 13; _h *= 0xc2b2ae35U;
+		_h ^= _h >> 16;
+
+		return static_cast<result_type>(_h);
+	}
+
+	/**
+	 * @brief The FNV-1a hash of a null terminated string.
+	 * Unlike rjenkins_hash_string the order of the chars changes the hash.
+	 */
+	inline result_type hash_string(const char* strValue, size_t maxLength = size_t(-1)) noexcept {
+		uint32_t _h = 2166136261U;
+
+		for(size_t i = 0; i < maxLength && strValue[i] != '\0'; i++) {
+			_h ^= static_cast<uint8_t>(strValue[i]);
+			_h *= 16777619U;
+		}
+		return static_cast<result_type>(_h);
+	}
+
     template <class T>
 	struct hash_function {
 		result_type operator () (T key, size_t maxValue) const noexcept {
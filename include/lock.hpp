@@ -128,7 +128,8 @@ namespace mofw {
      */
     basic_autolock(LOCK &m)
       : m_ref_lock(m) {
-      assert( (m_ref_lock.lock(portMAX_DELAY) != NO_ERROR) );
+      m_bLocked = (m_ref_lock.lock(portMAX_DELAY) == NO_ERROR);
+      assert(m_bLocked);
     }
     /**
      * Create a basic_autolock with a specific LockType, with timeout
@@ -139,7 +140,7 @@ namespace mofw {
      */
     basic_autolock(LOCK &m, unsigned long xTicksToWait)
       : m_ref_lock(m) {
-      assert( (m_ref_lock.lock(xTicksToWait) != NO_ERROR) );
+      m_bLocked = (m_ref_lock.lock(xTicksToWait) == NO_ERROR);
     }
     /**
      *  Destroy a basic_autolock.
@@ -147,7 +148,7 @@ namespace mofw {
      *  @post The LockObject will be unlocked, when the lock Object locked
      */
     ~basic_autolock() {
-        m_ref_lock.unlock();
+        if(m_bLocked) m_ref_lock.unlock();
     }
 
     operator bool () {
@@ -159,6 +160,10 @@ namespace mofw {
      *  in the destructor.
      */
     LOCK &m_ref_lock;
+    /**
+     * Was the lock taken in the constructor?
+     */
+    bool m_bLocked;
   };
 
 
@@ -195,7 +200,8 @@ namespace mofw {
      *  @post The LockObject will be locked.
      */
     ~basic_autounlock() {
-        assert( (m_ref_lock.lock(m_xTicksToWait) != NO_ERROR) );
+        int _ret = m_ref_lock.lock(m_xTicksToWait);
+        assert(_ret == NO_ERROR); (void)_ret;
     }
 
     void set_timeout(unsigned long xTicksToWait = portMAX_DELAY) {
@@ -0,0 +1,233 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_LOCK_PROFILER_
+#define MINLIB_ESP32_LOCK_PROFILER_
+
+#include "config.hpp"
+
+#if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/portmacro.h>
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "copyable.hpp"
+
+namespace mofw {
+    /**
+     * A task that waited for a lock
+     */
+    struct lock_waiter {
+        TaskHandle_t task;                      /*!< The task, NULL for a free entry */
+        char name[configMAX_TASK_NAME_LEN];     /*!< The name of the task */
+        uint32_t count;                         /*!< How often the task had to wait */
+        uint32_t wait_us;                       /*!< The sum of the wait times in micro seconds */
+    };
+
+    /**
+     * The contention record of one lock
+     */
+    struct lock_profile {
+        const void* lock;                       /*!< The lock object */
+        char name[16];                          /*!< The name, set with set_profile_name */
+        uint32_t acquisitions;                  /*!< The number of locks */
+        uint32_t contended;                     /*!< The number of locks, that had to wait */
+        uint32_t timeouts;                      /*!< The number of waits, that timed out */
+        uint64_t wait_us;                       /*!< The sum of the wait times in micro seconds */
+        uint64_t hold_us;                       /*!< The sum of the hold times in micro seconds */
+        uint32_t wait_max_us;                   /*!< The max wait time in micro seconds */
+        uint32_t hold_max_us;                   /*!< The max hold time in micro seconds */
+        uint32_t wait_histogram[MN_THREAD_CONFIG_LOCK_PROFILING_BUCKETS]; /*!< The wait times, log2 micro seconds */
+        uint32_t hold_histogram[MN_THREAD_CONFIG_LOCK_PROFILING_BUCKETS]; /*!< The hold times, log2 micro seconds */
+        lock_waiter top_waiters[MN_THREAD_CONFIG_LOCK_PROFILING_TOP_WAITERS]; /*!< The tasks with the longest waits */
+    };
+
+    /**
+     * The registry of all profiled locks.
+     *
+     * A lock is added on the first lock() and removed in its destructor. Each record has its
+     * own short critical section, so the locks do not contend on the profiler.
+     *
+     * @code{c}
+     * mutex_t mutex;
+     * mutex.set_profile_name("net");
+     * ...
+     * basic_lock_profiler::instance().dump(4);
+     * @endcode
+     *
+     * @ingroup lock
+     */
+    class basic_lock_profiler : MN_ONSIGLETN_CLASS {
+        friend class basic_lock_probe;
+    public:
+        static constexpr size_t capacity = MN_THREAD_CONFIG_LOCK_PROFILING_MAX_LOCKS;
+        static constexpr size_t buckets = MN_THREAD_CONFIG_LOCK_PROFILING_BUCKETS;
+        static constexpr size_t top_waiters = MN_THREAD_CONFIG_LOCK_PROFILING_TOP_WAITERS;
+
+        /**
+         * Get the singleton instance
+         * @return The singleton instance
+         */
+        static basic_lock_profiler& instance();
+
+        /**
+         * Get the number of profiled locks
+         */
+        size_t get_num_locks();
+
+        /**
+         * Copy the records of the hottest locks, sorted by the sum of the wait times
+         *
+         * @param pProfiles The array for the records
+         * @param maxProfiles The size of the array
+         * @return The number of copied records
+         */
+        size_t hottest(lock_profile* pProfiles, size_t maxProfiles);
+
+        /**
+         * Print the hottest locks with the histograms and the top waiters to stdout
+         *
+         * @param maxLocks How many locks to print
+         */
+        void dump(size_t maxLocks = 8);
+
+        /**
+         * Set all counters to zero, the locks stay in the registry
+         */
+        void reset();
+
+        /**
+         * Get the histogram bucket of the time
+         */
+        static size_t get_bucket(uint32_t us);
+    private:
+        basic_lock_profiler();
+
+        /**
+         * A record with the lock state, that is not in the snapshot
+         */
+        struct slot {
+            portMUX_TYPE mux;
+            bool used;
+            uint32_t depth;             /*!< The number of holders, more then one for recursive locks */
+            uint32_t locked_at;         /*!< The time, as the depth became 1 */
+            lock_profile profile;
+        };
+
+        int attach(const void* lock);
+        void detach(int index);
+
+        void set_name(int index, const char* name);
+        void on_acquire(int index, uint32_t wait_us, bool contended);
+        void on_timeout(int index, uint32_t wait_us);
+        void on_release(int index);
+
+        /**
+         * Fill the indexes of the used slots, sorted by the wait time
+         * @return The number of indexes
+         */
+        size_t sorted(int* pIndex, size_t maxIndex);
+        void copy(int index, lock_profile& profile);
+    private:
+        /**
+         * Guard for attach and detach, the records have a own mux
+         */
+        portMUX_TYPE m_muxSlots;
+        slot m_aSlots[MN_THREAD_CONFIG_LOCK_PROFILING_MAX_LOCKS];
+    };
+
+    /**
+     * The connection of a lock to the basic_lock_profiler, a member of the lock.
+     *
+     * A copy of a lock is a new lock for the profiler.
+     */
+    class basic_lock_probe {
+    public:
+        basic_lock_probe() : m_iIndex(-1) { }
+        basic_lock_probe(const basic_lock_probe&) : m_iIndex(-1) { }
+        basic_lock_probe& operator = (const basic_lock_probe&) { return *this; }
+
+        ~basic_lock_probe();
+
+        /**
+         * Take the lock with the take function and record the wait
+         *
+         * Try first without waiting, only a failed try counts as contended and is timed.
+         *
+         * @param lock The lock object, the key in the registry
+         * @param timeout The timeout for the take function
+         * @param take The take function, BaseType_t take(TickType_t timeout)
+         * @return The return value of the take function
+         */
+        template <class TTake>
+        BaseType_t take(const void* lock, unsigned int timeout, TTake take) {
+            BaseType_t _ret = take(0);
+
+            if(_ret == pdTRUE) {
+                acquired(lock, 0, false);
+            } else if(timeout != 0) {
+                uint32_t _start = now();
+                _ret = take(timeout);
+
+                if(_ret == pdTRUE) acquired(lock, now() - _start, true);
+                else timed_out(lock, now() - _start);
+            }
+            return _ret;
+        }
+
+        /**
+         * Record a lock without wait, for the ISR paths
+         */
+        void acquired(const void* lock) { acquired(lock, 0, false); }
+        /**
+         * Record the unlock, call after the lock was given successfully
+         */
+        void released();
+
+        /**
+         * Set the name of the record
+         */
+        void set_name(const void* lock, const char* name);
+
+        /**
+         * Get the time in micro seconds
+         */
+        static uint32_t now();
+    private:
+        void acquired(const void* lock, uint32_t wait_us, bool contended);
+        void timed_out(const void* lock, uint32_t wait_us);
+        /**
+         * Get the registry index, attach the lock on first use
+         * @return The index or -1 when the registry is full
+         */
+        int get_index(const void* lock);
+    private:
+        /**
+         * The index in the registry, -1 not attached and -2 registry was full
+         */
+        int m_iIndex;
+    };
+}
+
+#endif // MN_THREAD_CONFIG_LOCK_PROFILING
+
+#endif
@@ -0,0 +1,279 @@
+/**
+ * @file
+ * @brief Batch functions over contiguous arrays of the vecnx types.
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MINILIB_MATH_BATCH_HPP__
+#define __MINILIB_MATH_BATCH_HPP__
+
+#include "../config.hpp"
+
+#include <math.h>
+
+#include "types.hpp"
+
+#if MN_THREAD_CONFIG_MATH_SIMD == MN_THREAD_CONFIG_YES
+	#if defined(__SSE__) || defined(_M_X64)
+		#include <xmmintrin.h>
+		#define MN_MATH_SIMD_SSE 1
+	#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+		#include <arm_neon.h>
+		#define MN_MATH_SIMD_NEON 1
+	#endif
+#endif
+
+namespace mofw {
+	namespace math {
+		/**
+		 * @brief A row major 3x3 matrix.
+		 */
+		template <typename TTYPE>
+		struct mat3x {
+			using value_type = TTYPE;
+			value_type m[9];
+		};
+
+		/**
+		 * @brief A row major 4x4 matrix.
+		 */
+		template <typename TTYPE>
+		struct mat4x {
+			using value_type = TTYPE;
+			value_type m[16];
+		};
+
+		using mat3f = mat3x<float>;
+		using mat3d = mat3x<double>;
+		using mat4f = mat4x<float>;
+		using mat4d = mat4x<double>;
+
+		static_assert(sizeof(vec2f) == 2 * sizeof(float), "vec2f must be packed for the batch functions");
+		static_assert(sizeof(vec3f) == 3 * sizeof(float), "vec3f must be packed for the batch functions");
+		static_assert(sizeof(vec4f) == 4 * sizeof(float), "vec4f must be packed for the batch functions");
+
+		/**
+		 * The batch functions work on arrays of count vectors. The generic versions are
+		 * scalar loops, the float versions use SSE or NEON when the target has it and
+		 * MN_THREAD_CONFIG_MATH_SIMD is MN_THREAD_CONFIG_YES. Input and output arrays
+		 * can be the same array, but must not overlap otherwise.
+		 */
+		namespace batch {
+
+			/**
+			 * @brief out[i] = dot(a[i], b[i])
+			 */
+			template <class TVec>
+			void dot(const TVec* a, const TVec* b, typename TVec::value_type* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					typename TVec::value_type _sum = a[i].narray[0] * b[i].narray[0];
+
+					for(size_t c = 1; c < TVec::dimension; c++)
+						_sum += a[i].narray[c] * b[i].narray[c];
+
+					out[i] = _sum;
+				}
+			}
+
+			/**
+			 * @brief out[i] = cross(a[i], b[i])
+			 */
+			template <typename TTYPE>
+			void cross(const vec3x<TTYPE>* a, const vec3x<TTYPE>* b, vec3x<TTYPE>* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					TTYPE _x = a[i].y * b[i].z - a[i].z * b[i].y;
+					TTYPE _y = a[i].z * b[i].x - a[i].x * b[i].z;
+					TTYPE _z = a[i].x * b[i].y - a[i].y * b[i].x;
+
+					out[i].x = _x; out[i].y = _y; out[i].z = _z;
+				}
+			}
+
+			/**
+			 * @brief out[i] = length(v[i])
+			 */
+			template <class TVec>
+			void length(const TVec* v, typename TVec::value_type* out, size_t count) {
+				dot(v, v, out, count);
+
+				for(size_t i = 0; i < count; i++)
+					out[i] = static_cast<typename TVec::value_type>(::sqrt(out[i]));
+			}
+
+			/**
+			 * @brief v[i] = v[i] / length(v[i]), vectors with the length 0 are not changed.
+			 */
+			template <class TVec>
+			void normalize(TVec* v, size_t count) {
+				using value_type = typename TVec::value_type;
+
+				for(size_t i = 0; i < count; i++) {
+					value_type _len = v[i].narray[0] * v[i].narray[0];
+
+					for(size_t c = 1; c < TVec::dimension; c++)
+						_len += v[i].narray[c] * v[i].narray[c];
+
+					if(_len == value_type(0)) continue;
+
+					_len = static_cast<value_type>(::sqrt(_len));
+
+					for(size_t c = 0; c < TVec::dimension; c++)
+						v[i].narray[c] /= _len;
+				}
+			}
+
+			/**
+			 * @brief y[i] = alpha * x[i] + y[i]
+			 */
+			template <class TVec>
+			void axpy(typename TVec::value_type alpha, const TVec* x, TVec* y, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					for(size_t c = 0; c < TVec::dimension; c++)
+						y[i].narray[c] += alpha * x[i].narray[c];
+				}
+			}
+
+			/**
+			 * @brief out[i] = m * in[i]
+			 */
+			template <typename TTYPE>
+			void transform(const mat3x<TTYPE>& m, const vec3x<TTYPE>* in, vec3x<TTYPE>* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					TTYPE _x = m.m[0] * in[i].x + m.m[1] * in[i].y + m.m[2] * in[i].z;
+					TTYPE _y = m.m[3] * in[i].x + m.m[4] * in[i].y + m.m[5] * in[i].z;
+					TTYPE _z = m.m[6] * in[i].x + m.m[7] * in[i].y + m.m[8] * in[i].z;
+
+					out[i].x = _x; out[i].y = _y; out[i].z = _z;
+				}
+			}
+
+			/**
+			 * @brief out[i] = m * in[i]
+			 */
+			template <typename TTYPE>
+			void transform(const mat4x<TTYPE>& m, const vec4x<TTYPE>* in, vec4x<TTYPE>* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					TTYPE _v[4] = { in[i].x, in[i].y, in[i].z, in[i].w };
+
+					for(size_t r = 0; r < 4; r++)
+						out[i].narray[r] = m.m[r * 4 + 0] * _v[0] + m.m[r * 4 + 1] * _v[1] +
+										   m.m[r * 4 + 2] * _v[2] + m.m[r * 4 + 3] * _v[3];
+				}
+			}
+
+#if defined(MN_MATH_SIMD_SSE) || defined(MN_MATH_SIMD_NEON)
+			namespace internal {
+				/**
+				 * y[i] += alpha * x[i] over a flat float array.
+				 */
+				inline void saxpy(float alpha, const float* x, float* y, size_t n) {
+					size_t i = 0;
+	#if defined(MN_MATH_SIMD_SSE)
+					__m128 _alpha = _mm_set1_ps(alpha);
+
+					for(; i + 4 <= n; i += 4)
+						_mm_storeu_ps(y + i, _mm_add_ps(_mm_loadu_ps(y + i),
+											 _mm_mul_ps(_alpha, _mm_loadu_ps(x + i))));
+	#else
+					for(; i + 4 <= n; i += 4)
+						vst1q_f32(y + i, vmlaq_n_f32(vld1q_f32(y + i), vld1q_f32(x + i), alpha));
+	#endif
+					for(; i < n; i++) y[i] += alpha * x[i];
+				}
+			}
+
+			inline void axpy(float alpha, const vec2f* x, vec2f* y, size_t count) {
+				// x and y can be null when count is 0, so &x[0] is only formed when there is a element
+				if(count > 0) internal::saxpy(alpha, &x[0].x, &y[0].x, count * 2);
+			}
+			inline void axpy(float alpha, const vec3f* x, vec3f* y, size_t count) {
+				if(count > 0) internal::saxpy(alpha, &x[0].x, &y[0].x, count * 3);
+			}
+			inline void axpy(float alpha, const vec4f* x, vec4f* y, size_t count) {
+				if(count > 0) internal::saxpy(alpha, &x[0].x, &y[0].x, count * 4);
+			}
+
+			inline void dot(const vec4f* a, const vec4f* b, float* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+	#if defined(MN_MATH_SIMD_SSE)
+					__m128 _p = _mm_mul_ps(_mm_loadu_ps(&a[i].x), _mm_loadu_ps(&b[i].x));
+					_p = _mm_add_ps(_p, _mm_movehl_ps(_p, _p));
+					_p = _mm_add_ss(_p, _mm_shuffle_ps(_p, _p, 1));
+					out[i] = _mm_cvtss_f32(_p);
+	#else
+					float32x4_t _p = vmulq_f32(vld1q_f32(&a[i].x), vld1q_f32(&b[i].x));
+					float32x2_t _s = vadd_f32(vget_low_f32(_p), vget_high_f32(_p));
+					out[i] = vget_lane_f32(vpadd_f32(_s, _s), 0);
+	#endif
+				}
+			}
+
+			inline void normalize(vec4f* v, size_t count) {
+				float _len[1];
+
+				for(size_t i = 0; i < count; i++) {
+					dot(&v[i], &v[i], _len, 1);
+
+					if(_len[0] == 0.0f) continue;
+	#if defined(MN_MATH_SIMD_SSE)
+					_mm_storeu_ps(&v[i].x, _mm_div_ps(_mm_loadu_ps(&v[i].x), _mm_set1_ps(::sqrtf(_len[0]))));
+	#else
+					vst1q_f32(&v[i].x, vmulq_n_f32(vld1q_f32(&v[i].x), 1.0f / ::sqrtf(_len[0])));
+	#endif
+				}
+			}
+
+			inline void transform(const mat4f& m, const vec4f* in, vec4f* out, size_t count) {
+	#if defined(MN_MATH_SIMD_SSE)
+				// the columns of the row major matrix
+				__m128 _c0 = _mm_setr_ps(m.m[0], m.m[4], m.m[8],  m.m[12]);
+				__m128 _c1 = _mm_setr_ps(m.m[1], m.m[5], m.m[9],  m.m[13]);
+				__m128 _c2 = _mm_setr_ps(m.m[2], m.m[6], m.m[10], m.m[14]);
+				__m128 _c3 = _mm_setr_ps(m.m[3], m.m[7], m.m[11], m.m[15]);
+
+				for(size_t i = 0; i < count; i++) {
+					__m128 _r = _mm_mul_ps(_c0, _mm_set1_ps(in[i].x));
+					_r = _mm_add_ps(_r, _mm_mul_ps(_c1, _mm_set1_ps(in[i].y)));
+					_r = _mm_add_ps(_r, _mm_mul_ps(_c2, _mm_set1_ps(in[i].z)));
+					_r = _mm_add_ps(_r, _mm_mul_ps(_c3, _mm_set1_ps(in[i].w)));
+
+					_mm_storeu_ps(&out[i].x, _r);
+				}
+	#else
+				const float _cols[16] = { m.m[0], m.m[4], m.m[8],  m.m[12],
+										  m.m[1], m.m[5], m.m[9],  m.m[13],
+										  m.m[2], m.m[6], m.m[10], m.m[14],
+										  m.m[3], m.m[7], m.m[11], m.m[15] };
+				float32x4_t _c0 = vld1q_f32(_cols), _c1 = vld1q_f32(_cols + 4);
+				float32x4_t _c2 = vld1q_f32(_cols + 8), _c3 = vld1q_f32(_cols + 12);
+
+				for(size_t i = 0; i < count; i++) {
+					float32x4_t _r = vmulq_n_f32(_c0, in[i].x);
+					_r = vmlaq_n_f32(_r, _c1, in[i].y);
+					_r = vmlaq_n_f32(_r, _c2, in[i].z);
+					_r = vmlaq_n_f32(_r, _c3, in[i].w);
+
+					vst1q_f32(&out[i].x, _r);
+				}
+	#endif
+			}
+#endif // MN_MATH_SIMD_SSE || MN_MATH_SIMD_NEON
+		}
+	}
+}
+
+#endif // __MINILIB_MATH_BATCH_HPP__
@@ -0,0 +1,401 @@
+/**
+ * @file
+ * @brief Batch functions to convert and blend whole pixel buffers.
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef __MINILIB_MATH_COLOR_BATCH_HPP__
+#define __MINILIB_MATH_COLOR_BATCH_HPP__
+
+#include "../config.hpp"
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "batch.hpp"
+
+#if defined(MN_MATH_SIMD_SSE) && (defined(__SSE2__) || defined(_M_X64))
+	#include <emmintrin.h>
+	#define MN_MATH_SIMD_SSE2 1
+#endif
+
+namespace mofw {
+	namespace math {
+		/**
+		 * @brief A 8 bit HSV color, the hue 0-255 is the full circle.
+		 */
+		struct hsv8 {
+			uint8_t h;
+			uint8_t s;
+			uint8_t v;
+		};
+
+		/**
+		 * @brief A 8 bit gamma lookup table.
+		 */
+		class gamma_lut {
+		public:
+			/**
+			 * @brief Construct a new gamma table
+			 * @param gamma The gamma value, 2.2 for the most LEDs and displays
+			 */
+			explicit gamma_lut(float gamma = 2.2f) { set_gamma(gamma); }
+
+			/**
+			 * @brief Rebuild the table for a other gamma value
+			 */
+			void set_gamma(float gamma) {
+				for(int i = 0; i < 256; i++)
+					m_table[i] = static_cast<uint8_t>(::powf(i / 255.0f, gamma) * 255.0f + 0.5f);
+			}
+
+			uint8_t operator [] (uint8_t value) const { return m_table[value]; }
+
+			/**
+			 * @brief Correct count 8 bit values in place
+			 */
+			void apply(uint8_t* data, size_t count) const {
+				for(size_t i = 0; i < count; i++)
+					data[i] = m_table[data[i]];
+			}
+
+			/**
+			 * @brief Correct the color channels of count ARGB8888 pixels in place, alpha is not changed
+			 */
+			void apply(uint32_t* argb, size_t count) const {
+				for(size_t i = 0; i < count; i++) {
+					uint32_t _p = argb[i];
+
+					argb[i] = (_p & 0xFF000000u) |
+							  (uint32_t(m_table[(_p >> 16) & 0xFF]) << 16) |
+							  (uint32_t(m_table[(_p >> 8) & 0xFF]) << 8) |
+							   uint32_t(m_table[_p & 0xFF]);
+				}
+			}
+
+			const uint8_t* get_table() const { return m_table; }
+		private:
+			uint8_t m_table[256];
+		};
+
+		/**
+		 * The color batch functions work on whole frames in the following formats:
+		 * - RGBA float: 4 floats per pixel in the order r, g, b, a and the range 0-1
+		 * - ARGB8888: one uint32_t per pixel as 0xAARRGGBB, the same as basic_color::operator unsigned long
+		 * - RGB565: one uint16_t per pixel
+		 *
+		 * All conversions between the 8 bit formats are integer fixed point. The float packing
+		 * and the alpha blending use SSE2 or NEON when MN_THREAD_CONFIG_MATH_SIMD is enabled,
+		 * the SIMD and the scalar paths give the same results.
+		 */
+		namespace batch {
+			namespace internal {
+				/** x / 255 rounded, exact for x <= 255 * 255 */
+				inline uint32_t div255(uint32_t x) {
+					x += 128; return (x + (x >> 8)) >> 8;
+				}
+
+				inline uint32_t unit_to_u8(float x) {
+					x = (x < 0.0f) ? 0.0f : (x > 1.0f) ? 1.0f : x;
+					return static_cast<uint32_t>(x * 255.0f + 0.5f);
+				}
+			}
+
+			/**
+			 * @brief Pack count RGBA float pixels to ARGB8888, the values are clamped to 0-1
+			 */
+			inline void pack_argb8888(const float* rgba, uint32_t* out, size_t count) {
+				size_t i = 0;
+#if defined(MN_MATH_SIMD_SSE2)
+				const __m128 _zero = _mm_setzero_ps(), _one = _mm_set1_ps(1.0f);
+				const __m128 _scale = _mm_set1_ps(255.0f), _half = _mm_set1_ps(0.5f);
+				__m128i _v[4];
+
+				for(; i + 4 <= count; i += 4) {
+					for(int p = 0; p < 4; p++) {
+						__m128 _f = _mm_min_ps(_mm_max_ps(_mm_loadu_ps(rgba + (i + p) * 4), _zero), _one);
+						// r g b a -> b g r a, the byte order of 0xAARRGGBB
+						_v[p] = _mm_shuffle_epi32(_mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_f, _scale), _half)),
+												  _MM_SHUFFLE(3, 0, 1, 2));
+					}
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i),
+						_mm_packus_epi16(_mm_packs_epi32(_v[0], _v[1]), _mm_packs_epi32(_v[2], _v[3])));
+				}
+#elif defined(MN_MATH_SIMD_NEON)
+				const float32x4_t _zero = vdupq_n_f32(0.0f), _one = vdupq_n_f32(1.0f);
+				const float32x4_t _half = vdupq_n_f32(0.5f);
+				uint32x4_t _c[4];
+
+				for(; i + 4 <= count; i += 4) {
+					float32x4x4_t _f = vld4q_f32(rgba + i * 4);
+
+					for(int c = 0; c < 4; c++)
+						_c[c] = vcvtq_u32_f32(vmlaq_n_f32(_half, vminq_f32(vmaxq_f32(_f.val[c], _zero), _one), 255.0f));
+
+					vst1q_u32(out + i, vorrq_u32(vorrq_u32(vshlq_n_u32(_c[3], 24), vshlq_n_u32(_c[0], 16)),
+												 vorrq_u32(vshlq_n_u32(_c[1], 8), _c[2])));
+				}
+#endif
+				for(; i < count; i++) {
+					const float* _p = rgba + i * 4;
+
+					out[i] = (internal::unit_to_u8(_p[3]) << 24) | (internal::unit_to_u8(_p[0]) << 16) |
+							 (internal::unit_to_u8(_p[1]) << 8)  |  internal::unit_to_u8(_p[2]);
+				}
+			}
+
+			/**
+			 * @brief Unpack count ARGB8888 pixels to RGBA float
+			 */
+			inline void unpack_argb8888(const uint32_t* in, float* rgba, size_t count) {
+				const float _scale = 1.0f / 255.0f;
+				size_t i = 0;
+#if defined(MN_MATH_SIMD_SSE2)
+				const __m128i _zero = _mm_setzero_si128();
+				const __m128 _vscale = _mm_set1_ps(_scale);
+
+				for(; i + 4 <= count; i += 4) {
+					__m128i _px = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+					__m128i _w[2] = { _mm_unpacklo_epi8(_px, _zero), _mm_unpackhi_epi8(_px, _zero) };
+
+					for(int p = 0; p < 4; p++) {
+						__m128i _d = (p & 1) ? _mm_unpackhi_epi16(_w[p >> 1], _zero)
+											 : _mm_unpacklo_epi16(_w[p >> 1], _zero);
+						// b g r a -> r g b a
+						_d = _mm_shuffle_epi32(_d, _MM_SHUFFLE(3, 0, 1, 2));
+						_mm_storeu_ps(rgba + (i + p) * 4, _mm_mul_ps(_mm_cvtepi32_ps(_d), _vscale));
+					}
+				}
+#elif defined(MN_MATH_SIMD_NEON)
+				const uint32x4_t _mask = vdupq_n_u32(0xFF);
+
+				for(; i + 4 <= count; i += 4) {
+					uint32x4_t _px = vld1q_u32(in + i);
+					float32x4x4_t _f;
+
+					_f.val[0] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(_px, 16), _mask)), _scale);
+					_f.val[1] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(vshrq_n_u32(_px, 8), _mask)), _scale);
+					_f.val[2] = vmulq_n_f32(vcvtq_f32_u32(vandq_u32(_px, _mask)), _scale);
+					_f.val[3] = vmulq_n_f32(vcvtq_f32_u32(vshrq_n_u32(_px, 24)), _scale);
+
+					vst4q_f32(rgba + i * 4, _f);
+				}
+#endif
+				for(; i < count; i++) {
+					float* _p = rgba + i * 4;
+
+					_p[0] = float((in[i] >> 16) & 0xFF) * _scale;
+					_p[1] = float((in[i] >> 8) & 0xFF) * _scale;
+					_p[2] = float(in[i] & 0xFF) * _scale;
+					_p[3] = float(in[i] >> 24) * _scale;
+				}
+			}
+
+			/**
+			 * @brief Convert count ARGB8888 pixels to RGB565, the alpha is dropped
+			 */
+			inline void argb8888_to_rgb565(const uint32_t* in, uint16_t* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					uint32_t _p = in[i];
+
+					out[i] = static_cast<uint16_t>(((_p >> 8) & 0xF800) | ((_p >> 5) & 0x07E0) | ((_p >> 3) & 0x001F));
+				}
+			}
+
+			/**
+			 * @brief Convert count RGB565 pixels to ARGB8888 with full alpha
+			 * The low bits are filled with the high bits, so 0x1F is 0xFF and not 0xF8
+			 */
+			inline void rgb565_to_argb8888(const uint16_t* in, uint32_t* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					uint32_t _p = in[i];
+					uint32_t _r = (_p >> 11) & 0x1F, _g = (_p >> 5) & 0x3F, _b = _p & 0x1F;
+
+					out[i] = 0xFF000000u | (((_r << 3) | (_r >> 2)) << 16) |
+							 (((_g << 2) | (_g >> 4)) << 8) | ((_b << 3) | (_b >> 2));
+				}
+			}
+
+			/**
+			 * @brief Pack count RGBA float pixels to RGB565, the values are clamped to 0-1
+			 */
+			inline void pack_rgb565(const float* rgba, uint16_t* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					const float* _p = rgba + i * 4;
+
+					out[i] = static_cast<uint16_t>(((internal::unit_to_u8(_p[0]) * 31 + 127) / 255) << 11 |
+												   ((internal::unit_to_u8(_p[1]) * 63 + 127) / 255) << 5 |
+												   ((internal::unit_to_u8(_p[2]) * 31 + 127) / 255));
+				}
+			}
+
+			/**
+			 * @brief Unpack count RGB565 pixels to RGBA float with alpha 1
+			 */
+			inline void unpack_rgb565(const uint16_t* in, float* rgba, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					float* _p = rgba + i * 4;
+
+					_p[0] = float((in[i] >> 11) & 0x1F) * (1.0f / 31.0f);
+					_p[1] = float((in[i] >> 5) & 0x3F) * (1.0f / 63.0f);
+					_p[2] = float(in[i] & 0x1F) * (1.0f / 31.0f);
+					_p[3] = 1.0f;
+				}
+			}
+
+			/**
+			 * @brief Blend count ARGB8888 pixels over dst with the alpha of src (source over, straight alpha)
+			 *
+			 * dst.c = (src.c * src.a + dst.c * (255 - src.a)) / 255 and
+			 * dst.a = src.a + dst.a * (255 - src.a) / 255
+			 */
+			inline void blend_argb8888(const uint32_t* src, uint32_t* dst, size_t count) {
+				size_t i = 0;
+#if defined(MN_MATH_SIMD_SSE2)
+				const __m128i _zero = _mm_setzero_si128();
+				const __m128i _alpha_one = _mm_set1_epi32(static_cast<int>(0xFF000000u));
+				const __m128i _v255 = _mm_set1_epi16(255), _v128 = _mm_set1_epi16(128);
+
+				for(; i + 4 <= count; i += 4) {
+					__m128i _s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+					__m128i _d = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+					// the source alpha channel is 255, so the alpha result is a + da * (255 - a)
+					__m128i _s1 = _mm_or_si128(_s, _alpha_one);
+					__m128i _r[2];
+
+					for(int h = 0; h < 2; h++) {
+						__m128i _sw = h ? _mm_unpackhi_epi8(_s, _zero) : _mm_unpacklo_epi8(_s, _zero);
+						__m128i _s1w = h ? _mm_unpackhi_epi8(_s1, _zero) : _mm_unpacklo_epi8(_s1, _zero);
+						__m128i _dw = h ? _mm_unpackhi_epi8(_d, _zero) : _mm_unpacklo_epi8(_d, _zero);
+						__m128i _a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(_sw, 0xFF), 0xFF);
+
+						__m128i _x = _mm_add_epi16(_mm_mullo_epi16(_s1w, _a),
+												   _mm_mullo_epi16(_dw, _mm_sub_epi16(_v255, _a)));
+						_x = _mm_add_epi16(_x, _v128);
+						_r[h] = _mm_srli_epi16(_mm_add_epi16(_x, _mm_srli_epi16(_x, 8)), 8);
+					}
+					_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_packus_epi16(_r[0], _r[1]));
+				}
+#elif defined(MN_MATH_SIMD_NEON)
+				const uint8x8_t _v255 = vdup_n_u8(255);
+
+				for(; i + 8 <= count; i += 8) {
+					// val[0] = b, val[1] = g, val[2] = r, val[3] = a
+					uint8x8x4_t _s = vld4_u8(reinterpret_cast<const uint8_t*>(src + i));
+					uint8x8x4_t _d = vld4_u8(reinterpret_cast<const uint8_t*>(dst + i));
+					uint8x8_t _a = _s.val[3], _ia = vmvn_u8(_a);
+
+					_s.val[3] = _v255;
+
+					for(int c = 0; c < 4; c++) {
+						uint16x8_t _x = vmlal_u8(vmull_u8(_s.val[c], _a), _d.val[c], _ia);
+						_d.val[c] = vrshrn_n_u16(vrsraq_n_u16(_x, _x, 8), 8);
+					}
+					vst4_u8(reinterpret_cast<uint8_t*>(dst + i), _d);
+				}
+#endif
+				for(; i < count; i++) {
+					uint32_t _s = src[i], _d = dst[i];
+					uint32_t _a = _s >> 24, _ia = 255 - _a;
+
+					dst[i] = (internal::div255(255 * _a + (_d >> 24) * _ia) << 24) |
+							 (internal::div255(((_s >> 16) & 0xFF) * _a + ((_d >> 16) & 0xFF) * _ia) << 16) |
+							 (internal::div255(((_s >> 8) & 0xFF) * _a + ((_d >> 8) & 0xFF) * _ia) << 8) |
+							  internal::div255((_s & 0xFF) * _a + (_d & 0xFF) * _ia);
+				}
+			}
+
+			/**
+			 * @brief Blend count RGB565 pixels over dst with a constant alpha (0-255)
+			 * The blend use 5 bit alpha, all three channels are blended with one multiplication.
+			 */
+			inline void blend_rgb565(const uint16_t* src, uint16_t* dst, uint8_t alpha, size_t count) {
+				const uint32_t _a = (uint32_t(alpha) + 4) >> 3;
+				const uint32_t _mask = 0x07E0F81Fu;
+
+				for(size_t i = 0; i < count; i++) {
+					uint32_t _s = (src[i] | (uint32_t(src[i]) << 16)) & _mask;
+					uint32_t _d = (dst[i] | (uint32_t(dst[i]) << 16)) & _mask;
+					uint32_t _r = ((_s * _a + _d * (32 - _a)) >> 5) & _mask;
+
+					dst[i] = static_cast<uint16_t>(_r | (_r >> 16));
+				}
+			}
+
+			/**
+			 * @brief Convert count ARGB8888 pixels to 8 bit HSV, the alpha is dropped
+			 */
+			inline void rgb_to_hsv(const uint32_t* argb, hsv8* out, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					int _r = (argb[i] >> 16) & 0xFF, _g = (argb[i] >> 8) & 0xFF, _b = argb[i] & 0xFF;
+					int _max = _r > _g ? (_r > _b ? _r : _b) : (_g > _b ? _g : _b);
+					int _min = _r < _g ? (_r < _b ? _r : _b) : (_g < _b ? _g : _b);
+					int _delta = _max - _min;
+
+					out[i].v = static_cast<uint8_t>(_max);
+
+					if(_delta == 0) {
+						out[i].h = 0; out[i].s = 0;
+						continue;
+					}
+					out[i].s = static_cast<uint8_t>((255 * _delta + _max / 2) / _max);
+
+					int _h;
+					if(_max == _r)      _h = 0   + 43 * (_g - _b) / _delta;
+					else if(_max == _g) _h = 85  + 43 * (_b - _r) / _delta;
+					else                _h = 171 + 43 * (_r - _g) / _delta;
+
+					out[i].h = static_cast<uint8_t>(_h & 0xFF);
+				}
+			}
+
+			/**
+			 * @brief Convert count 8 bit HSV colors to ARGB8888 with full alpha
+			 */
+			inline void hsv_to_rgb(const hsv8* in, uint32_t* argb, size_t count) {
+				for(size_t i = 0; i < count; i++) {
+					uint32_t _h = in[i].h, _s = in[i].s, _v = in[i].v;
+					uint32_t _r, _g, _b;
+
+					if(_s == 0) {
+						_r = _g = _b = _v;
+					} else {
+						uint32_t _region = _h / 43;
+						uint32_t _rem = (_h - _region * 43) * 6;
+
+						uint32_t _p = (_v * (255 - _s)) >> 8;
+						uint32_t _q = (_v * (255 - ((_s * _rem) >> 8))) >> 8;
+						uint32_t _t = (_v * (255 - ((_s * (255 - _rem)) >> 8))) >> 8;
+
+						switch(_region) {
+							case 0:  _r = _v; _g = _t; _b = _p; break;
+							case 1:  _r = _q; _g = _v; _b = _p; break;
+							case 2:  _r = _p; _g = _v; _b = _t; break;
+							case 3:  _r = _p; _g = _q; _b = _v; break;
+							case 4:  _r = _t; _g = _p; _b = _v; break;
+							default: _r = _v; _g = _p; _b = _q; break;
+						}
+					}
+					argb[i] = 0xFF000000u | (_r << 16) | (_g << 8) | _b;
+				}
+			}
+		}
+	}
+}
+
+#endif // __MINILIB_MATH_COLOR_BATCH_HPP__
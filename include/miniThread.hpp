@@ -32,7 +32,9 @@
 #include "config.hpp"
 #include "def.hpp"
 #include "version.hpp"
+#include "string.hpp"
 #include "autolock.hpp"
+#include "shared_lock.hpp"
 #include "micros.hpp"
 #include "task.hpp"
 #include "tasklet.hpp"
@@ -40,6 +42,8 @@
 
 #include "critical.hpp"
 #include "timer.hpp"
+#include "timer_service.hpp"
+#include "task_profiler.hpp"
 
 #if MN_THREAD_CONFIG_CONDITION_VARIABLE_SUPPORT == MN_THREAD_CONFIG_YES
 #include "convar.hpp"
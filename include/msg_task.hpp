@@ -61,7 +61,7 @@ namespace mn {
              * @param uiPriority FreeRTOS priority of this Task.
              * @param usStackDepth Number of "words" allocated for the Task stack. default 2048
               */
-            explicit basic_message_task(std::string strName = "message_task",
+            explicit basic_message_task(string_view strName = "message_task",
 										basic_task::priority uiPriority = priority::Normal,
 										unsigned short  usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE);
 
@@ -71,7 +71,7 @@ namespace mofw {
      */
     virtual int unlock();
 
-    virtual bool try_lock() { lock(0); return m_isLocked; }
+    virtual bool try_lock() { return lock(0) == ERR_MUTEX_OK; }
   };
 
   /**
@@ -179,15 +179,17 @@ namespace mofw {
         using mutex_type = Mutex;
 
         explicit lock_guard(mutex_type& m) : m_ref_lock(m) {
-            assert( (m_ref_lock.lock(portMAX_DELAY) != NO_ERROR) );
+            int _ret = m_ref_lock.lock(portMAX_DELAY);
+            assert(_ret == NO_ERROR); (void)_ret;
         }
 
         lock_guard(mutex_type &m, unsigned long xTicksToWait)
             : m_ref_lock(m) {
-            assert( (m_ref_lock.lock(xTicksToWait) != NO_ERROR) );
+            int _ret = m_ref_lock.lock(xTicksToWait);
+            assert(_ret == NO_ERROR); (void)_ret;
         }
 
-        lock_guard(mutex_type& m, adopt_lock_t) : lock_guard(m) { }
+        lock_guard(mutex_type& m, adopt_lock_t) : m_ref_lock(m) { }
 
         ~lock_guard() {
             m_ref_lock.unlock();
@@ -196,7 +198,7 @@ namespace mofw {
         lock_guard(lock_guard const&) = delete;
         lock_guard& operator=(lock_guard const&) = delete;
     private:
-        mutex_type m_ref_lock;
+        mutex_type& m_ref_lock;
     };
 
     template <class Mutex>
@@ -206,63 +208,72 @@ namespace mofw {
 
         unique_lock() noexcept : m_mut(nullptr), m_owns(false) { }
         explicit unique_lock(mutex_type& m, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) 
-            : m_mut(m), m_owns(true) {m_mut->lock(timeout);}
+            : m_mut(&m), m_owns(m.lock(timeout) == ERR_MUTEX_OK) { }
 
         unique_lock(mutex_type& m, defer_lock_t) noexcept
-            : m_mut(m), m_owns(false) { } 
+            : m_mut(&m), m_owns(false) { } 
 
         unique_lock(mutex_type& m, try_to_lock_t)
-            : m_mut(m), m_owns(m.try_lock()) { } 
+            : m_mut(&m), m_owns(m.try_lock()) { } 
         unique_lock(mutex_type& m, adopt_lock_t) 
-            : m_mut(m), m_owns(false) { }  
+            : m_mut(&m), m_owns(true) { }  
 
         template <class Clock, class Duration>
         unique_lock(mutex_type& m, const chrono::time_point<Clock, Duration>& abs_time)
-            : m_mut(m), m_owns(m.try_lock_until(abs_time)) {}
+            : m_mut(&m), m_owns(m.try_lock_until(abs_time)) {}
 
         template <class Rep, class Period>
         unique_lock(mutex_type& m, const chrono::duration<Rep, Period>& rel_time)
-             :  m_mut(m), m_owns(m.try_lock_for(rel_time)) {}
+             :  m_mut(&m), m_owns(m.try_lock_for(rel_time)) {}
 
         ~unique_lock() { if (m_owns) m_mut->unlock(); }
 
         unique_lock(unique_lock const&) = delete;
         unique_lock& operator=(unique_lock const&) = delete;
 
-        unique_lock(unique_lock&& u) noexcept;
-        unique_lock& operator=(unique_lock&& u) noexcept;
+        unique_lock(unique_lock&& u) noexcept
+            : m_mut(u.m_mut), m_owns(u.m_owns) { u.m_mut = nullptr; u.m_owns = false; }
+
+        unique_lock& operator=(unique_lock&& u) noexcept {
+            if (m_owns) m_mut->unlock();
+            m_mut = u.m_mut; m_owns = u.m_owns;
+            u.m_mut = nullptr; u.m_owns = false;
+            return *this;
+        }
 
         void lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
             if (m_mut == nullptr) return;
             if (m_owns) return;
 
-            m_mut->lock(timeout);
-            m_owns = true;
+            m_owns = m_mut->lock(timeout) == ERR_MUTEX_OK;
         }
         bool try_lock() {
-            if (m_mut == nullptr) return;
-            if (m_owns) return;
+            if (m_mut == nullptr) return false;
+            if (m_owns) return true;
 
-            m_owns = m_mut->lock(0) == 0;
+            m_owns = m_mut->try_lock();
+            return m_owns;
         }
 
         template <class Rep, class Period>
         bool try_lock_for(const chrono::duration<Rep, Period>& rel_time) {
-            if (m_mut == nullptr) return;
-            if (m_owns) return;
+            if (m_mut == nullptr) return false;
+            if (m_owns) return true;
 
             m_owns = m_mut->try_lock_for(rel_time);
+            return m_owns;
         }
         template <class Clock, class Duration>
         bool try_lock_until(const chrono::time_point<Clock, Duration>& abs_time) {
-            if (m_mut == nullptr) return;
-            if (m_owns) return;
+            if (m_mut == nullptr) return false;
+            if (m_owns) return true;
 
             m_owns = m_mut->try_lock_until(abs_time);
+            return m_owns;
         }
 
         void unlock() {
-            if (!__owns_) return;
+            if (!m_owns) return;
             m_mut->unlock();
             m_owns = false;
         }
@@ -0,0 +1,156 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_NET_BASIC_BUFFER_CHAIN_H__
+#define __MINILIB_NET_BASIC_BUFFER_CHAIN_H__
+
+#include "../config.hpp"
+
+#include <stddef.h>
+#include <lwip/sockets.h>
+
+#include "../buffer.hpp"
+
+namespace mofw {
+	namespace net {
+		/**
+		 * @brief A chain of buffers for scatter / gather I/O (sendv and recvv of the sockets).
+		 *
+		 * The chain holds only pointers to the buffers, up to MN_THREAD_CONFIG_NET_BUFFER_CHAIN_SEGMENTS
+		 * segments, as a iovec array that is passed to lwip_sendmsg and lwip_recvmsg without
+		 * a copy. The buffers must live as long as the chain is used.
+		 *
+		 * consume removes the sent bytes from the front of the chain: a partial write changes
+		 * only the first segments, so a send can resume in the middle of a segment.
+		 *
+		 * @code{c}
+		 * net::buffer_chain_t chain;
+		 * chain.append(&header, sizeof(header));
+		 * chain.append(payload);				// a mofw::buffer
+		 * chain.append(&crc, sizeof(crc));
+		 *
+		 * socket.sendv(chain);
+		 * @endcode
+		 *
+		 * @ingroup socket
+		 */
+		class basic_buffer_chain {
+		public:
+			using self_type = basic_buffer_chain;
+			using size_type = size_t;
+			using segment_type = struct iovec;
+
+			static constexpr size_type max_segments = MN_THREAD_CONFIG_NET_BUFFER_CHAIN_SEGMENTS;
+
+			basic_buffer_chain() noexcept
+				: m_szFirst(0), m_szCount(0), m_szBytes(0) { }
+
+			/**
+			 * @brief Add a segment to the end of the chain
+			 * @param pData The data of the segment
+			 * @param size The size of the segment in bytes
+			 * @return False when the chain is full
+			 */
+			bool append(const void* pData, size_type size) noexcept {
+				if(m_szCount >= max_segments) return false;
+				if(size == 0) return true;
+
+				m_aSegments[m_szCount].iov_base = const_cast<void*>(pData);
+				m_aSegments[m_szCount].iov_len = size;
+
+				m_szCount++;
+				m_szBytes += size;
+				return true;
+			}
+
+			/**
+			 * @brief Add the used part of a buffer, for sending
+			 * @return False when the chain is full
+			 */
+			template <typename TVALUE, class TALLOCATOR>
+			bool append(const buffer<TVALUE, TALLOCATOR>& buf) noexcept {
+				return append(buf.begin(), buf.get_used_bytes());
+			}
+
+			/**
+			 * @brief Add the whole memory of a buffer, for receiving
+			 * @return False when the chain is full
+			 */
+			template <typename TVALUE, class TALLOCATOR>
+			bool append_space(buffer<TVALUE, TALLOCATOR>& buf) noexcept {
+				return append(buf.begin(), buf.get_size_bytes());
+			}
+
+			/**
+			 * @brief Remove bytes from the front of the chain, after a partial send or receive
+			 * @param bytes The number of bytes to remove
+			 * @return The number of removed bytes
+			 */
+			size_type consume(size_type bytes) noexcept {
+				size_type _ret = 0;
+
+				while(bytes > 0 && m_szFirst < m_szCount) {
+					segment_type& _seg = m_aSegments[m_szFirst];
+
+					if(bytes < _seg.iov_len) {
+						_seg.iov_base = static_cast<char*>(_seg.iov_base) + bytes;
+						_seg.iov_len -= bytes;
+
+						_ret += bytes;
+						break;
+					}
+					bytes -= _seg.iov_len;
+					_ret += _seg.iov_len;
+					m_szFirst++;
+				}
+				m_szBytes -= _ret;
+				return _ret;
+			}
+
+			/**
+			 * @brief Remove all segments
+			 */
+			void clear() noexcept { m_szFirst = m_szCount = m_szBytes = 0; }
+
+			/**
+			 * @brief Get the first segment, that is not consumed
+			 */
+			segment_type* data() noexcept 			{ return &m_aSegments[m_szFirst]; }
+			/**
+			 * @brief Get the number of the segments, that are not consumed
+			 */
+			size_type segments() const noexcept 	{ return m_szCount - m_szFirst; }
+			/**
+			 * @brief Get the number of bytes, that are not consumed
+			 */
+			size_type size() const noexcept 		{ return m_szBytes; }
+
+			bool empty() const noexcept 			{ return m_szBytes == 0; }
+			bool is_full() const noexcept 			{ return m_szCount >= max_segments; }
+		private:
+			segment_type m_aSegments[max_segments];
+
+			size_type m_szFirst;
+			size_type m_szCount;
+			size_type m_szBytes;
+		};
+
+		using buffer_chain_t = basic_buffer_chain;
+	}
+}
+
+#endif // __MINILIB_NET_BASIC_BUFFER_CHAIN_H__
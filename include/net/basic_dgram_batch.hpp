@@ -0,0 +1,196 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_NET_BASIC_DGRAM_BATCH_H__
+#define __MINILIB_NET_BASIC_DGRAM_BATCH_H__
+
+#include "../config.hpp"
+
+#include <stddef.h>
+#include <string.h>
+#include <lwip/sockets.h>
+
+#include "basic_ip4_endpoint.hpp"
+
+namespace mofw {
+	namespace net {
+		class basic_dgram_ip_socket;
+
+		/**
+		 * @brief A batch of datagrams with their endpoints, for basic_dgram_ip_socket::recive_batch
+		 * and basic_dgram_ip_socket::send_batch.
+		 *
+		 * The batch holds MN_THREAD_CONFIG_NET_DGRAM_BATCH_SIZE packet buffers of
+		 * MN_THREAD_CONFIG_NET_DGRAM_BATCH_PACKET_SIZE bytes, the addresses and the message headers,
+		 * all allocated once with the batch. With MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG the whole batch
+		 * is moved with one recvmmsg or sendmmsg call, else with one lwip_recvmsg or lwip_sendmsg
+		 * per datagram in a loop. MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG is off by default, enable it
+		 * only when the socket layer is the kernel's and not lwIP.
+		 *
+		 * The endpoints are stored as socket address, get_endpoint creates the endpoint only
+		 * when it is needed. A received batch can be send back as it is (echo).
+		 *
+		 * @code{c}
+		 * net::dgram_batch_t batch;		// better static or as member, the batch is big
+		 *
+		 * while(socket.recive_batch(batch) > 0) {
+		 *     for(size_t i = 0; i < batch.size(); i++)
+		 *         handle_packet(batch.data(i), batch.length(i));
+		 * }
+		 * @endcode
+		 *
+		 * @ingroup socket
+		 */
+		class basic_dgram_batch {
+			friend class basic_dgram_ip_socket;
+		public:
+			using self_type = basic_dgram_batch;
+			using size_type = size_t;
+			using endpoint_type = basic_ip4_endpoint;
+
+		#if MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG == MN_THREAD_CONFIG_YES
+			using message_type = struct mmsghdr;
+		#else
+			/** The same layout as struct mmsghdr */
+			struct message_type {
+				struct msghdr msg_hdr;
+				unsigned int msg_len;
+			};
+		#endif
+
+			static constexpr size_type capacity = MN_THREAD_CONFIG_NET_DGRAM_BATCH_SIZE;
+			static constexpr size_type packet_size = MN_THREAD_CONFIG_NET_DGRAM_BATCH_PACKET_SIZE;
+
+			basic_dgram_batch() noexcept
+				: m_szFirst(0), m_szCount(0) {
+
+				memset(m_aMsgs, 0, sizeof(m_aMsgs));
+				memset(m_aAddr, 0, sizeof(m_aAddr));
+
+				for(size_type i = 0; i < capacity; i++) {
+					m_aIov[i].iov_base = m_aData[i];
+					m_aIov[i].iov_len = packet_size;
+
+					m_aMsgs[i].msg_hdr.msg_name = &m_aAddr[i];
+					m_aMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+					m_aMsgs[i].msg_hdr.msg_iov = &m_aIov[i];
+					m_aMsgs[i].msg_hdr.msg_iovlen = 1;
+				}
+			}
+
+			basic_dgram_batch(const basic_dgram_batch&) = delete;
+			basic_dgram_batch& operator = (const basic_dgram_batch&) = delete;
+
+			/**
+			 * @brief Add a datagram for sending, the data is copied in the packet buffer
+			 * @param pData The data of the datagram
+			 * @param size The size of the data, max packet_size
+			 * @param ep The endpoint to send the datagram
+			 * @return False when the batch is full or the data too big
+			 */
+			bool push(const void* pData, size_type size, endpoint_type& ep) noexcept {
+				if(m_szCount >= capacity || size > packet_size) return false;
+
+				memcpy(m_aData[m_szCount], pData, size);
+				m_aIov[m_szCount].iov_len = size;
+				m_aMsgs[m_szCount].msg_len = size;
+				set_endpoint(m_szCount, ep);
+
+				m_szCount++;
+				return true;
+			}
+
+			/**
+			 * @brief Set the endpoint of a datagram
+			 */
+			void set_endpoint(size_type index, endpoint_type& ep) noexcept {
+				struct sockaddr_in& _addr = m_aAddr[index];
+
+				_addr.sin_family = AF_INET;
+				_addr.sin_port = htons(ep.get_port());
+				_addr.sin_addr.s_addr = (in_addr_t)ep.get_host();
+
+				m_aMsgs[index].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+			}
+
+			/**
+			 * @brief Get the endpoint of a datagram, the sender of a received datagram
+			 */
+			endpoint_type get_endpoint(size_type index) const noexcept {
+				return endpoint_type( basic_ip4_address( (uint32_t) m_aAddr[index].sin_addr.s_addr ),
+					ntohs(m_aAddr[index].sin_port) );
+			}
+
+			/**
+			 * @brief Remove all datagrams
+			 */
+			void clear() noexcept { m_szFirst = m_szCount = 0; }
+
+			/**
+			 * @brief Get the packet buffer of a datagram
+			 */
+			char* data(size_type index) noexcept 					{ return m_aData[index]; }
+			/**
+			 * @brief Get the size of a datagram in bytes
+			 */
+			size_type length(size_type index) const noexcept 		{ return m_aMsgs[index].msg_len; }
+
+			/**
+			 * @brief Get the number of datagrams in the batch
+			 */
+			size_type size() const noexcept 						{ return m_szCount; }
+			/**
+			 * @brief Get the number of datagrams, that are not sent
+			 */
+			size_type pending() const noexcept 						{ return m_szCount - m_szFirst; }
+
+			bool empty() const noexcept 							{ return m_szCount == 0; }
+			bool is_full() const noexcept 							{ return m_szCount >= capacity; }
+		private:
+			/** reset all entrys for a receive */
+			void prepare_receive() noexcept {
+				for(size_type i = 0; i < capacity; i++) {
+					m_aIov[i].iov_len = packet_size;
+					m_aMsgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_in);
+					m_aMsgs[i].msg_hdr.msg_flags = 0;
+				}
+				m_szFirst = m_szCount = 0;
+			}
+
+			/** set the count after a receive, the received datagrams can be sent back */
+			void received(size_type count) noexcept {
+				for(size_type i = 0; i < count; i++)
+					m_aIov[i].iov_len = m_aMsgs[i].msg_len;
+
+				m_szCount = count;
+			}
+		private:
+			message_type m_aMsgs[capacity];
+			struct iovec m_aIov[capacity];
+			struct sockaddr_in m_aAddr[capacity];
+			char m_aData[capacity][packet_size];
+
+			/** The first datagram, that is not sent */
+			size_type m_szFirst;
+			size_type m_szCount;
+		};
+
+		using dgram_batch_t = basic_dgram_batch;
+	}
+}
+
+#endif // __MINILIB_NET_BASIC_DGRAM_BATCH_H__
@@ -22,6 +22,9 @@
 #include "basic_socket.hpp"
 #include "basic_ip4_socket.hpp"
 #include "basic_ip6_socket.hpp"
+#include "basic_buffer_chain.hpp"
+#include "basic_dgram_batch.hpp"
+#include "basic_packet_pool.hpp"
 
 namespace mofw {
 	namespace net {
@@ -91,6 +94,81 @@ namespace mofw {
 			 */
 			int send_to(char* buffer, int offset, int size, const socket_flags& socketFlags, endpoint_type& ep);
 
+			/**
+			 * @brief Recive a datagram direct in the packet, up to the capacity of the packet.
+			 * The length of the packet is set to the number of received bytes.
+			 *
+			 * @param pkt The packet for the data
+			 * @param[out] ep The endpoint from recive the data, can be NULL
+			 * @param socketFlags The options for recive
+			 * @return Returns the number of bytes received, -1 on error or when pkt is empty
+			 */
+			int recive_from(packet_ptr& pkt, endpoint_type* ep, const socket_flags& socketFlags  = socket_flags::none) {
+				if(!pkt) return -1;
+
+				int _iret = recive_from(pkt->data(), 0, pkt->capacity(), socketFlags, ep);
+				pkt->set_length( (_iret > 0) ? _iret : 0 );
+				return _iret;
+			}
+
+			/**
+			 * @brief Send the used bytes of the packet to the given endpoint
+			 *
+			 * @param pkt The packet to send
+			 * @param ep The endpoint to send the packet
+			 * @param socketFlags The options for send
+			 * @return Returns the number of bytes sent, -1 on error or when pkt is empty
+			 */
+			int send_to(const packet_ptr& pkt, endpoint_type& ep, const socket_flags& socketFlags  = socket_flags::none) {
+				if(!pkt) return -1;
+				return send_to(pkt->data(), 0, pkt->length(), socketFlags, ep);
+			}
+
+			/**
+			 * @brief Send the segments of the chain as one datagram to the given endpoint,
+			 * with lwip_sendmsg and without copy them together
+			 *
+			 * @param chain The chain to send, is not changed
+			 * @param ep The endpoint to send the datagram
+			 * @param socketFlags The options for send
+			 * @return Returns the number of bytes sent, -1 on error
+			 */
+			int sendv_to(basic_buffer_chain& chain, endpoint_type& ep, const socket_flags& socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Receive one datagram into the segments of the chain, with lwip_recvmsg
+			 *
+			 * @param chain The chain to fill, is not changed
+			 * @param[out] ep The endpoint from recive the data, can be NULL
+			 * @param socketFlags The options for recive
+			 * @return Returns the number of bytes received, -1 on error
+			 */
+			int recvv_from(basic_buffer_chain& chain, endpoint_type* ep, const socket_flags& socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Receive up to basic_dgram_batch::capacity datagrams with their endpoints.
+			 *
+			 * Waits (on a blocking socket) only for the first datagram, the others are taken when
+			 * they are already queued. The old content of the batch is removed.
+			 *
+			 * @param batch The batch to fill
+			 * @param socketFlags The options for recive
+			 * @return Returns the number of received datagrams, -1 on error
+			 */
+			int recive_batch(basic_dgram_batch& batch, const socket_flags& socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Send all pending datagrams of the batch, each to its endpoint.
+			 *
+			 * The sent datagrams are not pending any more, when not all are sent (non blocking socket)
+			 * the next send_batch sends the rest.
+			 *
+			 * @param batch The batch to send
+			 * @param socketFlags The options for send
+			 * @return Returns the number of sent datagrams, -1 on error when nothing was sent
+			 */
+			int send_batch(basic_dgram_batch& batch, const socket_flags& socketFlags = socket_flags::none);
+
 
 		protected:
 			basic_dgram_ip_socket(handle_type& hndl, endpoint_type* endp = nullptr)
@@ -176,6 +254,57 @@ namespace mofw {
 			 */
 			int send_to(char* buffer, int offset, int size, socket_flags socketFlags, endpoint_type* ep);
 
+			/**
+			 * @brief Recive a datagram direct in the packet, up to the capacity of the packet.
+			 * The length of the packet is set to the number of received bytes.
+			 *
+			 * @param pkt The packet for the data
+			 * @param[out] ep The endpoint from recive the data, can be NULL
+			 * @param socketFlags The options for recive
+			 * @return Returns the number of bytes received, -1 on error or when pkt is empty
+			 */
+			int recive_from(packet_ptr& pkt, endpoint_type* ep, socket_flags socketFlags  = socket_flags::none) {
+				if(!pkt) return -1;
+
+				int _iret = recive_from(pkt->data(), 0, pkt->capacity(), socketFlags, ep);
+				pkt->set_length( (_iret > 0) ? _iret : 0 );
+				return _iret;
+			}
+
+			/**
+			 * @brief Send the used bytes of the packet to the given endpoint
+			 *
+			 * @param pkt The packet to send
+			 * @param ep The endpoint to send the packet
+			 * @param socketFlags The options for send
+			 * @return Returns the number of bytes sent, -1 on error or when pkt is empty
+			 */
+			int send_to(const packet_ptr& pkt, endpoint_type* ep, socket_flags socketFlags  = socket_flags::none) {
+				if(!pkt) return -1;
+				return send_to(pkt->data(), 0, pkt->length(), socketFlags, ep);
+			}
+
+			/**
+			 * @brief Send the segments of the chain as one datagram to the given endpoint,
+			 * with lwip_sendmsg and without copy them together
+			 *
+			 * @param chain The chain to send, is not changed
+			 * @param ep The endpoint to send the datagram
+			 * @param socketFlags The options for send
+			 * @return Returns the number of bytes sent, -1 on error
+			 */
+			int sendv_to(basic_buffer_chain& chain, endpoint_type* ep, socket_flags socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Receive one datagram into the segments of the chain, with lwip_recvmsg
+			 *
+			 * @param chain The chain to fill, is not changed
+			 * @param[out] ep The endpoint from recive the data, can be NULL
+			 * @param socketFlags The options for recive
+			 * @return Returns the number of bytes received, -1 on error
+			 */
+			int recvv_from(basic_buffer_chain& chain, endpoint_type* ep, socket_flags socketFlags = socket_flags::none);
+
 
 		protected:
 			basic_dgram_ip6_socket(handle_type& hndl, endpoint_type* endp = nullptr)
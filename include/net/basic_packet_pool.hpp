@@ -0,0 +1,356 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_NET_BASIC_PACKET_POOL_H__
+#define __MINILIB_NET_BASIC_PACKET_POOL_H__
+
+#include "../config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <stddef.h>
+
+#include "../error.hpp"
+#include "../atomic.hpp"
+#include "../allocator.hpp"
+#include "../pointer/intrusive_ptr.hpp"
+#include "../queue/queue.hpp"
+
+namespace mofw {
+	namespace net {
+		class basic_packet_pool_base;
+
+		/**
+		 * @brief A packet buffer from a basic_packet_pool, with a atomic reference count.
+		 *
+		 * The data follows the header in the same block of the pool. Use it only over a
+		 * packet_ptr: when the last packet_ptr is gone the packet goes back to its pool.
+		 *
+		 * @ingroup socket
+		 */
+		class basic_packet {
+			friend class basic_packet_pool_base;
+		public:
+			using size_type = size_t;
+
+			basic_packet(const basic_packet&) = delete;
+			basic_packet& operator = (const basic_packet&) = delete;
+
+			/**
+			 * @brief Get the data of the packet
+			 */
+			char* data() noexcept;
+			const char* data() const noexcept;
+
+			/**
+			 * @brief Get the number of used bytes
+			 */
+			size_type length() const noexcept 		{ return m_szLength; }
+			/**
+			 * @brief Set the number of used bytes, max capacity()
+			 */
+			void set_length(size_type length) noexcept {
+				m_szLength = (length < capacity()) ? length : capacity();
+			}
+
+			/**
+			 * @brief Get the size of the data in bytes, the packet size of the pool
+			 */
+			size_type capacity() const noexcept;
+
+			/**
+			 * @brief Get the number of references
+			 */
+			uint32_t use_count() const noexcept 	{ return m_uiRefs.load(memory_order::Relaxed); }
+
+			/**
+			 * @brief Get the pool of the packet
+			 */
+			basic_packet_pool_base* get_pool() noexcept { return m_pPool; }
+
+			friend void intrusive_ptr_add_ref(basic_packet* p) noexcept {
+				p->m_uiRefs.fetch_add(1, memory_order::Relaxed);
+			}
+			friend void intrusive_ptr_release(basic_packet* p) noexcept;
+		private:
+			basic_packet(basic_packet_pool_base* pool) noexcept
+				: m_pPool(pool), m_pNext(NULL), m_uiRefs(0), m_szLength(0) { }
+		private:
+			basic_packet_pool_base* m_pPool;
+			/** The next free packet, only used in the pool */
+			basic_packet* m_pNext;
+			_atomic<uint32_t> m_uiRefs;
+			size_type m_szLength;
+		};
+
+		/**
+		 * @brief The size of the header of a packet in front of the data, aligned
+		 */
+		constexpr size_t packet_header_size = (sizeof(basic_packet) + MN_THREAD_CONFIG_BASIC_ALIGNMENT - 1)
+			& ~(size_t)(MN_THREAD_CONFIG_BASIC_ALIGNMENT - 1);
+
+		inline char* basic_packet::data() noexcept {
+			return reinterpret_cast<char*>(this) + packet_header_size;
+		}
+		inline const char* basic_packet::data() const noexcept {
+			return reinterpret_cast<const char*>(this) + packet_header_size;
+		}
+
+		/**
+		 * @brief The handle of a packet, a intrusive pointer
+		 */
+		using packet_ptr = pointer::basic_intrusive_ptr<basic_packet>;
+
+		/**
+		 * @brief The pool logic of basic_packet_pool, without the memory allocation.
+		 *
+		 * The free packets are in a single linked list, allocate and release take the first packet
+		 * in a critical section (portENTER_CRITICAL_SAFE), so both can be used from a ISR.
+		 *
+		 * @ingroup socket
+		 */
+		class basic_packet_pool_base {
+			friend class basic_packet;
+			friend void intrusive_ptr_release(basic_packet* p) noexcept;
+		public:
+			using size_type = size_t;
+
+			/**
+			 * @brief Construct a pool
+			 * @param uiPackets The number of packets
+			 * @param uiPacketSize The size of the data of a packet in bytes
+			 */
+			basic_packet_pool_base(size_type uiPackets, size_type uiPacketSize) noexcept;
+			~basic_packet_pool_base() { }
+
+			basic_packet_pool_base(const basic_packet_pool_base&) = delete;
+			basic_packet_pool_base& operator = (const basic_packet_pool_base&) = delete;
+
+			/**
+			 * @brief Get a free packet, with a length of 0
+			 * @return The packet, a empty packet_ptr when the pool is exhausted or not created
+			 */
+			packet_ptr allocate() noexcept;
+
+			/**
+			 * @brief Get the number of packets
+			 */
+			size_type get_num_packets() const noexcept 	{ return m_szPackets; }
+			/**
+			 * @brief Get the size of the data of a packet in bytes
+			 */
+			size_type get_packet_size() const noexcept 	{ return m_szPacketSize; }
+			/**
+			 * @brief Get the number of packets in use
+			 */
+			uint32_t get_num_used() const noexcept 		{ return m_uiUsed; }
+			/**
+			 * @brief Get the number of free packets
+			 */
+			uint32_t get_num_free() const noexcept 		{ return m_szPackets - m_uiUsed; }
+			/**
+			 * @brief Get the max number of packets, that was in use at the same time
+			 */
+			uint32_t get_high_water() const noexcept 	{ return m_uiHighWater; }
+			/**
+			 * @brief Get the number of allocate calls, that failed because the pool was exhausted
+			 */
+			uint32_t get_num_exhausted() const noexcept { return m_uiExhausted; }
+			/**
+			 * @brief Get the number of successful allocate calls
+			 */
+			uint32_t get_num_allocated() const noexcept { return m_uiAllocated; }
+
+			/**
+			 * @brief Reset the high-water mark to the current number of used packets and
+			 * the exhaustion and allocation counters to 0
+			 */
+			void reset_stats() noexcept;
+
+			bool is_created() const noexcept 			{ return m_pMemory != NULL; }
+		protected:
+			/**
+			 * @brief Get the size of a block (header and data) in bytes, aligned
+			 */
+			size_type get_block_size() const noexcept {
+				return packet_header_size + ((m_szPacketSize + MN_THREAD_CONFIG_BASIC_ALIGNMENT - 1)
+					& ~(size_type)(MN_THREAD_CONFIG_BASIC_ALIGNMENT - 1));
+			}
+			/**
+			 * @brief Get the size of the memory for all packets in bytes
+			 */
+			size_type get_memory_size() const noexcept 	{ return get_block_size() * m_szPackets; }
+
+			/**
+			 * @brief Build the free list in the given memory
+			 * @param pMemory The memory, get_memory_size() bytes
+			 */
+			void init(void* pMemory) noexcept;
+			/**
+			 * @brief Forget the memory
+			 * @return The memory, NULL when packets are in use
+			 */
+			void* release_memory() noexcept;
+			/**
+			 * @brief Log a error, the pool is destroyed with packets in use
+			 */
+			void log_in_use() const noexcept;
+		private:
+			/** Put the packet back in the free list */
+			void release(basic_packet* packet) noexcept;
+		protected:
+			void* m_pMemory;
+		private:
+			portMUX_TYPE m_muxPool;
+			basic_packet* m_pFree;
+
+			size_type m_szPackets;
+			size_type m_szPacketSize;
+
+			uint32_t m_uiUsed;
+			uint32_t m_uiHighWater;
+			uint32_t m_uiExhausted;
+			uint32_t m_uiAllocated;
+		};
+
+		inline basic_packet::size_type basic_packet::capacity() const noexcept {
+			return m_pPool->get_packet_size();
+		}
+
+		/**
+		 * @brief A pool of fixed size packet buffers for the sockets.
+		 *
+		 * All packets are allocated with create() in one block from TAllocator. A receive task
+		 * gets a packet with allocate(), receives direct in it (basic_dgram_ip_socket::recive_from,
+		 * basic_stream_ip_socket::recive) and passes the packet_ptr on without copy the data:
+		 * with enqueue_packet / dequeue_packet over a queue::basic_queue, or as message data of a
+		 * basic_message_task (post the pointer from detach() and adopt it in on_message with
+		 * packet_ptr(static_cast<basic_packet*>(message), false)). The packet goes back to the pool,
+		 * when the last packet_ptr is gone.
+		 *
+		 * @code{c}
+		 * net::packet_pool_t pool(16, 1472);
+		 * pool.create();
+		 *
+		 * net::packet_ptr pkt = pool.allocate();
+		 * if(pkt && socket.recive_from(pkt, &ep) > 0)
+		 *     net::enqueue_packet(queue, pkt);	// the queue is created with sizeof(net::basic_packet*)
+		 * @endcode
+		 *
+		 * @tparam TAllocator The allocator for the memory of the packets
+		 * @ingroup socket
+		 */
+		template <class TAllocator = memory::default_allocator>
+		class basic_packet_pool : public basic_packet_pool_base {
+		public:
+			using allocator_type = TAllocator;
+			using base_type = basic_packet_pool_base;
+
+			/**
+			 * @brief Construct a pool, the memory is allocated with create()
+			 * @param uiPackets The number of packets
+			 * @param uiPacketSize The size of the data of a packet in bytes
+			 */
+			basic_packet_pool(size_type uiPackets = MN_THREAD_CONFIG_NET_PACKET_POOL_PACKETS,
+				size_type uiPacketSize = MN_THREAD_CONFIG_NET_PACKET_POOL_PACKET_SIZE) noexcept
+				: base_type(uiPackets, uiPacketSize) { }
+
+			/**
+			 * @brief Destructor, frees the memory of all packets.
+			 *
+			 * The pool must outlive its packets. When packets are still in use, the memory is
+			 * not freed (leaked) and a error is logged, a later release of such a packet
+			 * accesses the destroyed pool.
+			 */
+			~basic_packet_pool() {
+				if(destroy() == ERR_MEMPOOL_INUSE && m_pMemory != NULL) log_in_use();
+			}
+
+			/**
+			 * @brief Allocate the memory of all packets
+			 * @return 'ERR_MEMPOOL_OK' the pool was created, 'ERR_MEMPOOL_ALREADYINIT' the pool is
+			 * allready created and 'ERR_MEMPOOL_CREATE' the memory can not allocate
+			 */
+			int create() {
+				if(m_pMemory != NULL) return ERR_MEMPOOL_ALREADYINIT;
+
+				void* _mem = m_alloCator.allocate(get_memory_size(), MN_THREAD_CONFIG_BASIC_ALIGNMENT);
+				if(_mem == NULL) return ERR_MEMPOOL_CREATE;
+
+				init(_mem);
+				return ERR_MEMPOOL_OK;
+			}
+
+			/**
+			 * @brief Free the memory of all packets
+			 * @return 'ERR_MEMPOOL_OK' the pool was destroyed and 'ERR_MEMPOOL_INUSE' when
+			 * packets are in use or the pool is not created
+			 */
+			int destroy() {
+				void* _mem = release_memory();
+				if(_mem == NULL) return ERR_MEMPOOL_INUSE;
+
+				m_alloCator.deallocate(_mem, get_memory_size(), MN_THREAD_CONFIG_BASIC_ALIGNMENT);
+				return ERR_MEMPOOL_OK;
+			}
+		private:
+			allocator_type m_alloCator;
+		};
+
+		using packet_pool_t = basic_packet_pool<>;
+
+		/**
+		 * @brief Add a packet to the back of the queue, without copy the data. On success the
+		 * queue holds the reference and pkt is empty.
+		 *
+		 * @param queue The queue, created with a item size of sizeof(basic_packet*)
+		 * @param pkt The packet
+		 * @param timeout How long to wait to add the packet to the queue
+		 * @return 'ERR_QUEUE_OK' the packet was added, else the error of queue::basic_queue::enqueue
+		 */
+		inline int enqueue_packet(queue::basic_queue& queue, packet_ptr& pkt,
+			unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+
+			basic_packet* _raw = pkt.get();
+
+			int _ret = queue.enqueue(&_raw, timeout);
+			if(_ret == ERR_QUEUE_OK) pkt.detach();
+
+			return _ret;
+		}
+
+		/**
+		 * @brief Remove a packet from the front of the queue, pkt takes the reference of the queue
+		 *
+		 * @param queue The queue, created with a item size of sizeof(basic_packet*)
+		 * @param[out] pkt The removed packet
+		 * @param timeout How long to wait to remove a packet from the queue
+		 * @return 'ERR_QUEUE_OK' a packet was removed, else the error of queue::basic_queue::dequeue
+		 */
+		inline int dequeue_packet(queue::basic_queue& queue, packet_ptr& pkt,
+			unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) {
+
+			basic_packet* _raw = NULL;
+
+			int _ret = queue.dequeue(&_raw, timeout);
+			if(_ret == ERR_QUEUE_OK) pkt = packet_ptr(_raw, false);
+
+			return _ret;
+		}
+	}
+}
+
+#endif // __MINILIB_NET_BASIC_PACKET_POOL_H__
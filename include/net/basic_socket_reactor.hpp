@@ -0,0 +1,297 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_BASIC_SOCKET_REACTOR_H__
+#define __MINILIB_BASIC_SOCKET_REACTOR_H__
+
+#include "../config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "basic_socket.hpp"
+#include "../container/timing_wheel.hpp"
+
+namespace mofw {
+	namespace net {
+		class basic_socket_reactor;
+
+		/**
+		 * @brief A socket in a basic_socket_reactor.
+		 *
+		 * Derive from this class and implement on_event, the reactor calls it from the reactor
+		 * task when the socket is ready. The socket should be non blocking.
+		 *
+		 * In the level mode on_event is called on each run of the reactor as long as the socket
+		 * is ready. In the edge mode a event is reported once: the handler reads or writes until
+		 * the socket would block and then calls rearm() to get the next event.
+		 *
+		 * With set_idle_timeout the reactor calls on_timeout when no event was reported for the
+		 * given ticks, this is the connection timeout without a extra timer.
+		 *
+		 * @note Call remove() before the handler is destroyed: remove() waits until a running
+		 * callback of this handler is finished, the destructor runs after the derived class is
+		 * destroyed and so asserts that the handler is not in a reactor. Do not delete the
+		 * handler in its own callback, call remove() there and delete it later.
+		 *
+		 * @ingroup socket
+		 */
+		class basic_reactor_handler : public container::timing_wheel_node {
+			friend class basic_socket_reactor;
+		public:
+			using handle_type = typename basic_ip_socket::handle_type;
+
+			/**
+			 * @brief The events of a socket, can be combined
+			 */
+			enum event_type : uint32_t {
+				event_none 		= 0x00, /*!< No event */
+				event_read 		= 0x01, /*!< The socket can read or accept without blocking */
+				event_write 	= 0x02, /*!< The socket can write without blocking */
+				event_error 	= 0x04, /*!< A error is pending on the socket, always reported */
+				event_hangup 	= 0x08, /*!< The peer has closed the connection, always reported (poll backend only) */
+			};
+
+			/**
+			 * @brief How often a ready socket is reported
+			 */
+			enum class trigger_mode {
+				level, /*!< On each run of the reactor, as long as the socket is ready */
+				edge   /*!< Once, the next event only after rearm() */
+			};
+
+			/**
+			 * @brief Construct a handler
+			 * @param socket 	The socket, must live as long as the handler is in a reactor
+			 * @param uiEvents 	The events of interest
+			 * @param mode 		The trigger mode
+			 */
+			explicit basic_reactor_handler(basic_ip_socket& socket, uint32_t uiEvents = event_read,
+				trigger_mode mode = trigger_mode::level);
+
+			/**
+			 * @brief Destructor, the handler must be removed from the reactor before
+			 */
+			virtual ~basic_reactor_handler();
+
+			basic_reactor_handler(const basic_reactor_handler&) = delete;
+			basic_reactor_handler& operator = (const basic_reactor_handler&) = delete;
+
+			/**
+			 * @brief Remove the handler from its reactor
+			 * @return False when the handler is not in a reactor
+			 */
+			bool remove();
+
+			/**
+			 * @brief Set the events of interest, the events are armed again
+			 * @return False when the handler is not in a reactor
+			 */
+			bool set_events(uint32_t uiEvents);
+			/**
+			 * @brief Arm all events of interest again, for the edge mode
+			 * @return False when the handler is not in a reactor
+			 */
+			bool rearm();
+
+			/**
+			 * @brief Set the idle timeout
+			 * @param uiTicks The ticks without a event before on_timeout is called, 0 disables the timeout
+			 */
+			void set_idle_timeout(unsigned int uiTicks);
+
+			basic_ip_socket& get_socket() 			{ return *m_pSocket; }
+			uint32_t get_events() 					{ return m_uiEvents; }
+			trigger_mode get_mode() 				{ return m_eMode; }
+			unsigned int get_idle_timeout() 		{ return m_uiTimeout; }
+			bool is_registered() 					{ return m_pReactor != NULL; }
+		protected:
+			/**
+			 * @brief Called from the reactor task when the socket is ready
+			 * @param uiEvents The ready events, a combination of event_type
+			 */
+			virtual void on_event(uint32_t uiEvents) = 0;
+			/**
+			 * @brief Called from the reactor task when the idle timeout expires,
+			 * the timeout is not started again
+			 */
+			virtual void on_timeout() { }
+		private:
+			basic_socket_reactor* m_pReactor;
+			basic_ip_socket* m_pSocket;
+
+			handle_type m_iHandle;
+			int m_iSlot;
+
+			uint32_t m_uiEvents;
+			/**
+			 * The events, that are reported on the next run (edge mode)
+			 */
+			uint32_t m_uiArmed;
+			trigger_mode m_eMode;
+			unsigned int m_uiTimeout;
+		};
+
+		/**
+		 * @brief A socket reactor, multiplex many sockets in one task.
+		 *
+		 * Instead of one task (and one stack) per socket, the sockets are added as
+		 * basic_reactor_handler to the reactor and one task runs the reactor: run_once waits
+		 * with lwip_select or lwip_poll until a socket is ready or a idle timeout is expired and
+		 * calls the handlers. The backend is set with MN_THREAD_CONFIG_NET_REACTOR_BACKEND.
+		 * run_once sleeps not longer as to the next tick, that can expire a idle timeout.
+		 *
+		 * add, remove and set_events can be called from any task, the reactor is woken up by a
+		 * datagram to a loopback socket. The handlers are hold in a fixed table of
+		 * MN_THREAD_CONFIG_NET_REACTOR_MAX_HANDLERS entrys, the reactor allocates nothing.
+		 *
+		 * @code{c}
+		 * class echo_handler : public net::basic_reactor_handler {
+		 * public:
+		 *     echo_handler(net::stream_ip4_socket* sock)
+		 *         : basic_reactor_handler(*sock), m_pSocket(sock) { set_idle_timeout(5000); }
+		 * protected:
+		 *     void on_event(uint32_t events) override {
+		 *         int n = m_pSocket->recive(m_buffer, sizeof(m_buffer));
+		 *         if(n > 0) m_pSocket->send_bytes(m_buffer, n);
+		 *         else remove();
+		 *     }
+		 *     void on_timeout() override { remove(); }
+		 * };
+		 *
+		 * // in the on_task of the network task
+		 * while(is_running()) reactor.run_once(portMAX_DELAY);
+		 * @endcode
+		 *
+		 * @ingroup socket
+		 */
+		class basic_socket_reactor {
+			friend class basic_reactor_handler;
+		public:
+			using handler_type = basic_reactor_handler;
+			using handle_type = typename handler_type::handle_type;
+			using wheel_type = container::basic_timing_wheel<handler_type,
+				MN_THREAD_CONFIG_NET_REACTOR_WHEEL_BITS, MN_THREAD_CONFIG_NET_REACTOR_WHEEL_LEVELS>;
+
+			static constexpr size_t capacity = MN_THREAD_CONFIG_NET_REACTOR_MAX_HANDLERS;
+
+			basic_socket_reactor();
+			/**
+			 * @brief Destructor, removes all handlers and closes the backend
+			 */
+			virtual ~basic_socket_reactor();
+
+			basic_socket_reactor(const basic_socket_reactor&) = delete;
+			basic_socket_reactor& operator = (const basic_socket_reactor&) = delete;
+
+			/**
+			 * @brief Create the backend and the wakeup socket, called from add and run_once
+			 * when not created
+			 * @return False on error
+			 */
+			bool create();
+
+			/**
+			 * @brief Add a handler
+			 * @return False when the handler is in a reactor, the socket is not initialized
+			 * or the reactor is full
+			 */
+			bool add(handler_type* handler);
+			/**
+			 * @brief Remove a handler.
+			 * When called from a other task, wait until a running callback of the handler is finished.
+			 * @return False when the handler is not in this reactor
+			 */
+			bool remove(handler_type* handler);
+
+			/**
+			 * @brief Wait for events and call the handlers, call this from one task only
+			 * @param uiTimeout The max time to wait, in ticks. portMAX_DELAY waits until a event
+			 * @return The number of called handlers, -1 on error
+			 */
+			int run_once(TickType_t uiTimeout = portMAX_DELAY);
+
+			/**
+			 * @brief Wake up a waiting run_once
+			 */
+			void wakeup();
+
+			/**
+			 * @brief Get the number of handlers in the reactor
+			 */
+			unsigned int get_num_handlers();
+			/**
+			 * @brief Get the number of on_event and on_timeout calls
+			 */
+			uint32_t get_num_dispatched();
+		private:
+			/** update the interest of the handler in the backend */
+			bool modify(handler_type* handler, uint32_t uiEvents, bool bRearm);
+			/** update the idle timeout of the handler */
+			void set_timeout(handler_type* handler, unsigned int uiTicks);
+			/** wait in the backend and call dispatch for each ready socket */
+			int wait(TickType_t uiTimeout);
+			/** call the handler of the slot, when the handle is not changed */
+			int dispatch(int slot, handle_type hndl, uint32_t uiEvents);
+			/** call on_timeout of all expired handlers */
+			int dispatch_timeouts();
+			/** read all pending wakeup datagrams */
+			void drain_wakeup();
+
+			bool is_reactor_task() { return xTaskGetCurrentTaskHandle() == m_hRunner; }
+
+			/** advance the wheel to the current tick, takes the critical section for each step */
+			void sync_time();
+			/** must call in the critical section */
+			void insert_timeout(handler_type* handler, unsigned int uiTicks);
+			/** must call in the critical section */
+			void erase_timeout(handler_type* handler);
+		private:
+			/** Guard the table and the wheel, use portENTER_CRITICAL_SAFE */
+			portMUX_TYPE m_muxTable;
+
+			handler_type* m_pHandlers[capacity];
+			unsigned int m_uiCount;
+
+			wheel_type m_wheelTimeouts;
+			TickType_t m_tLastTick;
+			/** The expired handlers of the current run, without holes. A handler is in the
+			 *  wheel or in this array, so capacity entrys are enough */
+			handler_type* m_pExpired[capacity];
+			unsigned int m_uiExpired;
+
+			/** The handler, that callback is running */
+			handler_type* volatile m_pCurrent;
+			/** The task, that runs run_once */
+			TaskHandle_t volatile m_hRunner;
+
+			handle_type m_iWakeup;
+			volatile bool m_bWakeupPending;
+			uint32_t m_uiDispatched;
+
+		#if MN_THREAD_CONFIG_NET_REACTOR_BACKEND == MN_THREAD_CONFIG_NET_REACTOR_POLL
+			struct pollfd m_aPoll[capacity + 1];
+			int m_aPollSlot[capacity + 1];
+		#endif
+		};
+
+		using reactor_handler_t = basic_reactor_handler;
+		using socket_reactor_t = basic_socket_reactor;
+	}
+}
+
+#endif // __MINILIB_BASIC_SOCKET_REACTOR_H__
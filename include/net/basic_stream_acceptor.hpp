@@ -0,0 +1,156 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef __MINILIB_NET_BASIC_STREAM_ACCEPTOR_H__
+#define __MINILIB_NET_BASIC_STREAM_ACCEPTOR_H__
+
+#include "../config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "basic_stream_ip_socket.hpp"
+
+namespace mofw {
+	namespace net {
+		/**
+		 * @brief Accepts the connections of a listening socket into a preallocated slab of sockets.
+		 *
+		 * basic_stream_ip_socket::accept() allocates a new socket (and endpoint) for each
+		 * connection. The acceptor holds MN_THREAD_CONFIG_NET_ACCEPTOR_SLOTS socket objects,
+		 * constructed once without a handle, and accepts into a free one. A connection is given
+		 * back with release(), that closes the socket and frees the slot.
+		 *
+		 * accept_all accepts all pending connections of one wakeup, until the listening socket
+		 * would block (EAGAIN). When the slab is full a pending connection is accepted and
+		 * closed at once, and counted as overflow, so the backlog is not filled up and a level
+		 * triggered reactor is not woken up again and again.
+		 *
+		 * @note The listening socket must be non blocking (set_blocking(false)). With a blocking
+		 * listener accept_all accepts only one connection per call, and a full slab leaves the
+		 * pending connections in the backlog, because each further accept could wait.
+		 *
+		 * @code{c}
+		 * // in on_event of the reactor handler of the listening socket
+		 * net::stream_acceptor_t::socket_type* clients[8];
+		 * int n = m_acceptor.accept_all(clients, 8);
+		 * for(int i = 0; i < n; i++) add_client(clients[i]);
+		 *
+		 * // when the connection is done
+		 * m_acceptor.release(client);
+		 * @endcode
+		 *
+		 * @ingroup socket
+		 */
+		class basic_stream_acceptor {
+		public:
+			using socket_type = basic_stream_ip_socket;
+			using handle_type = typename socket_type::handle_type;
+
+			static constexpr int capacity = MN_THREAD_CONFIG_NET_ACCEPTOR_SLOTS;
+
+			/**
+			 * @brief Construct the acceptor and all socket objects of the slab
+			 * @param listener The listening socket, must live as long as the acceptor
+			 */
+			explicit basic_stream_acceptor(socket_type& listener);
+			/**
+			 * @brief Destructor, closes all connections, that are not released
+			 */
+			virtual ~basic_stream_acceptor();
+
+			basic_stream_acceptor(const basic_stream_acceptor&) = delete;
+			basic_stream_acceptor& operator = (const basic_stream_acceptor&) = delete;
+
+			/**
+			 * @brief Accept the next pending connection into a free slot
+			 * @return The socket of the connection, NULL when no connection is pending, on error or
+			 * when the slab is full
+			 */
+			socket_type* accept();
+
+			/**
+			 * @brief Accept all pending connections, until the listening socket would block
+			 * @param ppClients The array for the accepted sockets
+			 * @param iMax The size of the array
+			 * @return The number of accepted connections
+			 */
+			int accept_all(socket_type** ppClients, int iMax);
+
+			/**
+			 * @brief Close the connection and free the slot
+			 * @return False when the socket is not from this acceptor
+			 */
+			bool release(socket_type* client);
+
+			/**
+			 * @brief Get the number of connections in use
+			 */
+			int get_num_used() 						{ return m_iUsed; }
+			/**
+			 * @brief Get the number of free slots
+			 */
+			int get_num_free() 						{ return capacity - m_iUsed; }
+			/**
+			 * @brief Get the number of all accepted connections
+			 */
+			uint32_t get_num_accepted() 			{ return m_uiAccepted; }
+			/**
+			 * @brief Get the number of connections, that are closed at once because the slab was full
+			 */
+			uint32_t get_num_overflow() 			{ return m_uiOverflow; }
+			/**
+			 * @brief Get the number of accepted connections in the last full second
+			 */
+			uint32_t get_accept_rate();
+
+			socket_type& get_listener() 			{ return *m_pListener; }
+		private:
+			socket_type* get_slot(int index) {
+				return reinterpret_cast<socket_type*>(m_aStorage[index]);
+			}
+			/** accept one connection, bPending is true when a connection was closed because the slab was full */
+			socket_type* accept_one(bool& bPending);
+			/** update the accept rate, must call in the critical section */
+			void update_rate(TickType_t tNow);
+		private:
+			/** Guard the free list and the counters, use portENTER_CRITICAL_SAFE */
+			portMUX_TYPE m_muxSlab;
+
+			socket_type* m_pListener;
+
+			/** The memory of the socket objects, constructed in the constructor */
+			alignas(socket_type) unsigned char m_aStorage[capacity][sizeof(socket_type)];
+			/** The next free slot of each free slot, -1 at the end */
+			int m_aNext[capacity];
+			/** The first free slot, -1 when the slab is full */
+			int m_iFree;
+			int m_iUsed;
+
+			uint32_t m_uiAccepted;
+			uint32_t m_uiOverflow;
+
+			TickType_t m_tRateStart;
+			uint32_t m_uiRateCount;
+			uint32_t m_uiRate;
+		};
+
+		using stream_acceptor_t = basic_stream_acceptor;
+	}
+}
+
+#endif // __MINILIB_NET_BASIC_STREAM_ACCEPTOR_H__
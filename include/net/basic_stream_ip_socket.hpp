@@ -22,6 +22,8 @@
 #include "basic_socket.hpp"
 #include "basic_ip4_socket.hpp"
 #include "basic_ip6_socket.hpp"
+#include "basic_buffer_chain.hpp"
+#include "basic_packet_pool.hpp"
 
 namespace mofw {
 	namespace net {
@@ -30,6 +32,7 @@ namespace mofw {
 		 * @ingroup socket
 		 */
 		class basic_stream_ip_socket : public basic_ip4_socket  {
+			friend class basic_stream_acceptor;
 		public:
 			using self_type = basic_stream_ip_socket;
 			using base_type = basic_ip4_socket;
@@ -63,10 +66,23 @@ namespace mofw {
 			 * @brief Gets the next completed connection from the socket's completed connection queue.
 			 * @note If the queue is empty, waits until a connection request completes.
 			 *
+			 * @note The socket and the endpoint are allocated with new, the caller must delete them.
+			 * accept(self_type&) and basic_stream_acceptor accept without allocation.
+			 *
 			 * @return A new basic_stream_ip_socket for the connection with the client.
 			 */
 			self_type* accept();
 
+			/**
+			 * @brief Gets the next completed connection into the given socket object, without allocation.
+			 * A open handle of client is closed and the endpoint of client is deleted before.
+			 * @note On a non blocking socket returns false when no connection is pending (EAGAIN).
+			 *
+			 * @param client The socket object for the connection with the client
+			 * @return True when a connection was accepted and false if not
+			 */
+			bool accept(self_type& client);
+
 			/**
 			 * @brief Receives data from the socket and stores it in buffer. Up to length bytes are received.
 			 * @return Returns the number of bytes received.
@@ -79,6 +95,28 @@ namespace mofw {
 			 */
 			int recive(char* buffer, int offset, int size, socket_flags socketFlags);
 
+			/**
+			 * @brief Receives data direct in the packet, up to the capacity of the packet.
+			 * The length of the packet is set to the number of received bytes.
+			 * @return Returns the number of bytes received, -1 on error or when pkt is empty
+			 */
+			int recive(packet_ptr& pkt, socket_flags socketFlags = socket_flags::none) {
+				if(!pkt) return -1;
+
+				int _iret = recive(pkt->data(), 0, pkt->capacity(), socketFlags);
+				pkt->set_length( (_iret > 0) ? _iret : 0 );
+				return _iret;
+			}
+
+			/**
+			 * @brief Sends the used bytes of the packet.
+			 * @return Returns the number of bytes sent, -1 on error or when pkt is empty
+			 */
+			int send_bytes(const packet_ptr& pkt, socket_flags socketFlags = socket_flags::none) {
+				if(!pkt) return -1;
+				return send_bytes(pkt->data(), 0, pkt->length(), socketFlags);
+			}
+
 			/**
 			 * @brief Sends the contents of the given buffer.
 			 * @return Returns the number of bytes sent, which may be less than the number of bytes specified.
@@ -100,6 +138,29 @@ namespace mofw {
 			 */
 			int send_bytes(const void* buffer, int offset, int size, socket_flags socketFlags = socket_flags::none);
 
+			/**
+			 * @brief Sends the segments of the chain with lwip_sendmsg, without copy them together.
+			 *
+			 * The sent bytes are consumed from the chain. On a partial send a blocking socket
+			 * yields and sends the rest, a non blocking socket returns and the next sendv
+			 * resumes in the middle of the chain.
+			 *
+			 * @param chain 		The chain to send
+			 * @param socketFlags	Socket sending optians
+			 * @return Returns the number of bytes sent, -1 on error when nothing was sent
+			 */
+			int sendv(basic_buffer_chain& chain, socket_flags socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Receives data into the segments of the chain with one lwip_recvmsg call.
+			 * The received bytes are consumed from the chain, so the next recvv fills the rest.
+			 *
+			 * @param chain 		The chain to fill
+			 * @param socketFlags	Socket receive optians
+			 * @return Returns the number of bytes received, 0 when the peer has closed and -1 on error
+			 */
+			int recvv(basic_buffer_chain& chain, socket_flags socketFlags = socket_flags::none);
+
 
 
 		protected:
@@ -164,6 +225,28 @@ namespace mofw {
 			 */
 			int recive(char* buffer, int offset, int size, socket_flags socketFlags);
 
+			/**
+			 * @brief Receives data direct in the packet, up to the capacity of the packet.
+			 * The length of the packet is set to the number of received bytes.
+			 * @return Returns the number of bytes received, -1 on error or when pkt is empty
+			 */
+			int recive(packet_ptr& pkt, socket_flags socketFlags = socket_flags::none) {
+				if(!pkt) return -1;
+
+				int _iret = recive(pkt->data(), 0, pkt->capacity(), socketFlags);
+				pkt->set_length( (_iret > 0) ? _iret : 0 );
+				return _iret;
+			}
+
+			/**
+			 * @brief Sends the used bytes of the packet.
+			 * @return Returns the number of bytes sent, -1 on error or when pkt is empty
+			 */
+			int send_bytes(const packet_ptr& pkt, socket_flags socketFlags = socket_flags::none) {
+				if(!pkt) return -1;
+				return send_bytes(pkt->data(), 0, pkt->length(), socketFlags);
+			}
+
 			/**
 			 * @brief Sends the contents of the given buffer.
 			 * @return Returns the number of bytes sent, which may be less than the number of bytes specified.
@@ -185,6 +268,29 @@ namespace mofw {
 			 */
 			int send_bytes(const void* buffer, int offset, int size, socket_flags socketFlags = socket_flags::none);
 
+			/**
+			 * @brief Sends the segments of the chain with lwip_sendmsg, without copy them together.
+			 *
+			 * The sent bytes are consumed from the chain. On a partial send a blocking socket
+			 * yields and sends the rest, a non blocking socket returns and the next sendv
+			 * resumes in the middle of the chain.
+			 *
+			 * @param chain 		The chain to send
+			 * @param socketFlags	Socket sending optians
+			 * @return Returns the number of bytes sent, -1 on error when nothing was sent
+			 */
+			int sendv(basic_buffer_chain& chain, socket_flags socketFlags = socket_flags::none);
+
+			/**
+			 * @brief Receives data into the segments of the chain with one lwip_recvmsg call.
+			 * The received bytes are consumed from the chain, so the next recvv fills the rest.
+			 *
+			 * @param chain 		The chain to fill
+			 * @param socketFlags	Socket receive optians
+			 * @return Returns the number of bytes received, 0 when the peer has closed and -1 on error
+			 */
+			int recvv(basic_buffer_chain& chain, socket_flags socketFlags = socket_flags::none);
+
 
 		protected:
 			basic_stream_ip6_socket(handle_type& hndl, endpoint_type* endp = nullptr)
@@ -22,7 +22,12 @@
 #include "basic_dgram_socket.hpp"
 #include "basic_multicast_ip_socket.hpp"
 #include "basic_stream_ip_socket.hpp"
+#include "basic_stream_acceptor.hpp"
 #include "basic_raw_ip_socket.hpp"
+#include "basic_buffer_chain.hpp"
+#include "basic_dgram_batch.hpp"
+#include "basic_packet_pool.hpp"
+#include "basic_socket_reactor.hpp"
 
 namespace mofw {
 	namespace net {
@@ -30,6 +30,7 @@
 #include "pointer/scoped_ptr.hpp"
 #include "pointer/lock_ptr.hpp"
 #include "pointer/weak_ptr.hpp"
+#include "pointer/intrusive_ptr.hpp"
 #include "pointer/linked_ptr.hpp"
 #include "pointer/any_ptr.hpp"
 #include "pointer/auto_ptr.hpp"
@@ -0,0 +1,197 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#ifndef _MINLIB_INTRUSIVE_PTR_H_
+#define _MINLIB_INTRUSIVE_PTR_H_
+
+#include "../config.hpp"
+
+#include "../def.hpp"
+#include "../functional.hpp"
+#include "../atomic.hpp"
+
+namespace mofw {
+    namespace pointer {
+        /**
+         * @brief A base class with a atomic reference count for basic_intrusive_ptr.
+         *
+         * The count is in the object, so a intrusive pointer is only one pointer big and
+         * needs no control block. The object is deleted with delete, when the last pointer
+         * is gone.
+         *
+         * @code{c}
+         * class packet : public pointer::basic_intrusive_ref_counter<packet> { ... };
+         *
+         * pointer::intrusive_ptr<packet> p(new packet());
+         * @endcode
+         *
+         * @tparam TDerived The class, that derives from this class
+         */
+        template <class TDerived>
+        class basic_intrusive_ref_counter {
+        public:
+            basic_intrusive_ref_counter() noexcept : m_uiRefs(0) { }
+            basic_intrusive_ref_counter(const basic_intrusive_ref_counter&) noexcept : m_uiRefs(0) { }
+
+            basic_intrusive_ref_counter& operator=(const basic_intrusive_ref_counter&) noexcept {
+                return *this;
+            }
+
+            /**
+             * @brief Get the number of references
+             */
+            size_t use_count() const noexcept {
+                return m_uiRefs.load(memory_order::Relaxed);
+            }
+
+            friend void intrusive_ptr_add_ref(const basic_intrusive_ref_counter* p) noexcept {
+                p->m_uiRefs.fetch_add(1, memory_order::Relaxed);
+            }
+
+            friend void intrusive_ptr_release(const basic_intrusive_ref_counter* p) noexcept {
+                if(p->m_uiRefs.fetch_sub(1, memory_order::Release) == 1) {
+                    mofw::atomic_thread_fence(memory_order::Acquire);
+                    delete static_cast<const TDerived*>(p);
+                }
+            }
+        protected:
+            ~basic_intrusive_ref_counter() { }
+        private:
+            mutable _atomic<size_t> m_uiRefs;
+        };
+
+        /**
+         * @brief A shared pointer with the reference count in the object.
+         *
+         * T must have the functions intrusive_ptr_add_ref(T*) and intrusive_ptr_release(T*),
+         * found by argument dependent lookup, basic_intrusive_ref_counter gives them.
+         *
+         * @tparam T The type of the object
+         */
+        template <typename T>
+        class basic_intrusive_ptr {
+            template <typename U> friend class basic_intrusive_ptr;
+        public:
+            using value_type = T;
+            using element_type = T;
+            using reference = T&;
+            using pointer = value_type*;
+
+            using self_type = basic_intrusive_ptr<value_type>;
+
+            constexpr basic_intrusive_ptr() noexcept : m_ptr(nullptr) { }
+
+            /**
+             * @brief Take a reference on the object
+             * @param ptr The object
+             * @param add_ref When false, adopt a reference that the caller owns
+             */
+            explicit basic_intrusive_ptr(pointer ptr, bool add_ref = true) noexcept : m_ptr(ptr) {
+                if(m_ptr != nullptr && add_ref) intrusive_ptr_add_ref(m_ptr);
+            }
+
+            basic_intrusive_ptr(const self_type& other) noexcept : m_ptr(other.m_ptr) {
+                if(m_ptr != nullptr) intrusive_ptr_add_ref(m_ptr);
+            }
+
+            template <typename U>
+            basic_intrusive_ptr(const basic_intrusive_ptr<U>& other) noexcept : m_ptr(other.m_ptr) {
+                if(m_ptr != nullptr) intrusive_ptr_add_ref(m_ptr);
+            }
+
+            basic_intrusive_ptr(self_type&& other) noexcept : m_ptr(other.m_ptr) {
+                other.m_ptr = nullptr;
+            }
+
+            ~basic_intrusive_ptr() {
+                if(m_ptr != nullptr) intrusive_ptr_release(m_ptr);
+            }
+
+            self_type& operator = (const self_type& other) noexcept {
+                self_type(other).swap(*this);
+                return *this;
+            }
+
+            self_type& operator = (self_type&& other) noexcept {
+                self_type(mofw::move(other)).swap(*this);
+                return *this;
+            }
+
+            self_type& operator = (pointer ptr) noexcept {
+                self_type(ptr).swap(*this);
+                return *this;
+            }
+
+            void reset() noexcept                   { self_type().swap(*this); }
+            void reset(pointer ptr) noexcept        { self_type(ptr).swap(*this); }
+
+            /**
+             * @brief Give up the pointer without release, the caller owns the reference
+             */
+            pointer detach() noexcept {
+                pointer _ptr = m_ptr;
+                m_ptr = nullptr;
+                return _ptr;
+            }
+
+            void swap(self_type& other) noexcept    { mofw::swap(m_ptr, other.m_ptr); }
+
+            pointer get() const noexcept            { return m_ptr; }
+
+            reference operator*() const noexcept {
+                assert(m_ptr != nullptr);
+                return *m_ptr;
+            }
+            pointer operator->() const noexcept {
+                assert(m_ptr != nullptr);
+                return m_ptr;
+            }
+            explicit operator bool() const noexcept { return m_ptr != nullptr; }
+        private:
+            pointer m_ptr;
+        };
+
+        template <typename T, typename U>
+        inline bool operator == (const basic_intrusive_ptr<T>& a, const basic_intrusive_ptr<U>& b) noexcept {
+            return a.get() == b.get();
+        }
+        template <typename T, typename U>
+        inline bool operator != (const basic_intrusive_ptr<T>& a, const basic_intrusive_ptr<U>& b) noexcept {
+            return a.get() != b.get();
+        }
+
+        template <typename T>
+        void swap(basic_intrusive_ptr<T>& a, basic_intrusive_ptr<T>& b) noexcept {
+        	a.swap(b);
+        }
+
+        template < typename T >
+		using intrusive_ptr = basic_intrusive_ptr<T>;
+
+		/**
+		 * @brief Make a intrusive pointer
+		 * @tparam T Value type of the pointer.
+		 * @tparam Args Argument for the object.
+		 */
+		template<typename T, typename... Args >
+		inline intrusive_ptr<T> make_intrusive(Args&&... args) {
+			return intrusive_ptr<T>(new T (mofw::forward<Args>(args)...) );
+		}
+    }
+}
+
+#endif
@@ -21,98 +21,444 @@
 #include "../config.hpp"
 
 #include "../def.hpp"
+#include "../functional.hpp"
+#include "../atomic.hpp"
+#include "../allocator.hpp"
+
+#include <new>
 
 namespace mofw {
     namespace pointer {
 
-        template < typename T, typename TRefType >
-        class basic_shared_ptr   {
+        /**
+         * @brief The control block of the shared pointers.
+         *
+         * Holds the atomic strong count (the number of basic_shared_ptr) and the weak count
+         * (the number of basic_weak_ptr, plus one while the strong count is not zero). The
+         * object is disposed, when the strong count becomes zero and the control block is
+         * destroyed, when the weak count becomes zero.
+         */
+        class basic_shared_control {
+        public:
+            basic_shared_control() noexcept
+                : m_uiUses(1), m_uiWeaks(1) { }
+
+            basic_shared_control(const basic_shared_control&) = delete;
+            basic_shared_control& operator=(const basic_shared_control&) = delete;
+
+            /**
+             * @brief Add a strong reference
+             */
+            void add_ref() noexcept {
+                m_uiUses.fetch_add(1, memory_order::Relaxed);
+            }
+
+            /**
+             * @brief Add a strong reference, when the object is alive (for weak_ptr::lock)
+             * @return True when the reference was added and false when the object is gone
+             */
+            bool add_ref_lock() noexcept {
+                size_t _uses = m_uiUses.load(memory_order::Relaxed);
+
+                while(_uses != 0) {
+                    if(m_uiUses.compare_exchange_weak(_uses, _uses + 1, memory_order::Relaxed))
+                        return true;
+                }
+                return false;
+            }
+
+            /**
+             * @brief Remove a strong reference, dispose the object on the last one
+             */
+            void release() noexcept {
+                if(m_uiUses.fetch_sub(1, memory_order::Release) == 1) {
+                    mofw::atomic_thread_fence(memory_order::Acquire);
+                    dispose();
+                    weak_release();
+                }
+            }
+
+            /**
+             * @brief Add a weak reference
+             */
+            void weak_add_ref() noexcept {
+                m_uiWeaks.fetch_add(1, memory_order::Relaxed);
+            }
+
+            /**
+             * @brief Remove a weak reference, destroy the control block on the last one
+             */
+            void weak_release() noexcept {
+                if(m_uiWeaks.fetch_sub(1, memory_order::Release) == 1) {
+                    mofw::atomic_thread_fence(memory_order::Acquire);
+                    destroy();
+                }
+            }
+
+            /**
+             * @brief Get the number of strong references
+             */
+            size_t use_count() const noexcept {
+                return m_uiUses.load(memory_order::Relaxed);
+            }
+        protected:
+            virtual ~basic_shared_control() { }
+
+            /**
+             * @brief Destroy the managed object
+             */
+            virtual void dispose() noexcept = 0;
+            /**
+             * @brief Free the control block
+             */
+            virtual void destroy() noexcept = 0;
+        private:
+            _atomic<size_t> m_uiUses;
+            _atomic<size_t> m_uiWeaks;
+        };
+
+        /**
+         * @brief The deleter for objects, that are created with new
+         */
+        struct shared_default_delete {
+            template <typename T>
+            void operator()(T* ptr) const noexcept { delete ptr; }
+        };
+
+        /**
+         * @brief Control block for a given pointer and deleter, created with new
+         */
+        template <typename T, class TDeleter>
+        class basic_shared_control_ptr : public basic_shared_control {
+        public:
+            basic_shared_control_ptr(T* ptr, TDeleter deleter) noexcept
+                : m_ptr(ptr), m_deleter(deleter) { }
+        protected:
+            virtual void dispose() noexcept { m_deleter(m_ptr); }
+            virtual void destroy() noexcept { delete this; }
+        private:
+            T* m_ptr;
+            TDeleter m_deleter;
+        };
+
+        /**
+         * @brief Control block with the object inside, one allocation from TAllocator.
+         * The block holds a reference to the allocator, that frees the block.
+         */
+        template <typename T, class TAllocator>
+        class basic_shared_control_inplace : public basic_shared_control {
+        public:
+            template <typename... Args>
+            basic_shared_control_inplace(TAllocator& alloc, Args&&... args)
+                : m_allocator(alloc) {
+                ::new (static_cast<void*>(&m_storage)) T(mofw::forward<Args>(args)...);
+            }
+
+            T* get() noexcept { return reinterpret_cast<T*>(&m_storage); }
+        protected:
+            virtual void dispose() noexcept { get()->~T(); }
+
+            virtual void destroy() noexcept {
+                TAllocator& _alloc = m_allocator;
+
+                this->~basic_shared_control_inplace();
+                _alloc.deallocate(this, sizeof(basic_shared_control_inplace),
+                                  alignof(basic_shared_control_inplace));
+            }
+        private:
+            TAllocator& m_allocator;
+            alignas(T) unsigned char m_storage[sizeof(T)];
+        };
+
+        template <typename T> class basic_weak_ptr;
+
+        /**
+         * @brief A shared pointer with a control block.
+         *
+         * All copies share the control block with the atomic counts, so the pointers can be
+         * copied and destroyed from many tasks at the same time. Use make_shared or
+         * allocate_shared to create the object and the control block in one allocation.
+         *
+         * @tparam T The type of the object
+         */
+        template <typename T>
+        class basic_shared_ptr {
+            template <typename U> friend class basic_shared_ptr;
+            template <typename U> friend class basic_weak_ptr;
+
+            template <typename U, class TAllocator, typename... Args>
+            friend basic_shared_ptr<U> allocate_shared(TAllocator& alloc, Args&&... args);
         public:
             using value_type = T;
             using element_type = T;
             using reference = T&;
-            using const_value_type = const value_type;
             using pointer = value_type*;
-            using ref_type = TRefType;
+            using control_type = basic_shared_control;
+
+            using self_type = basic_shared_ptr<value_type>;
+            using weak_type = basic_weak_ptr<value_type>;
 
-            using self_type = basic_shared_ptr<value_type, ref_type>;
+            constexpr basic_shared_ptr() noexcept
+                : m_ptr(nullptr), m_pControl(nullptr) { }
 
+            constexpr basic_shared_ptr(nullptr_t) noexcept
+                : m_ptr(nullptr), m_pControl(nullptr) { }
 
-            explicit basic_shared_ptr(pointer ptr )
-                : m_ref(1), m_ptr(ptr)  { }
+            /**
+             * @brief Take the ownership of a object, that is created with new.
+             * A nullptr allocates no control block. When the control block can not be
+             * allocated then the object is deleted and the pointer stay empty.
+             */
+            template <typename U>
+            explicit basic_shared_ptr(U* ptr)
+                : m_ptr(ptr), m_pControl(nullptr) {
+                if(ptr != nullptr) {
+                    m_pControl = new (std::nothrow) basic_shared_control_ptr<U, shared_default_delete>(
+                        ptr, shared_default_delete());
 
-            basic_shared_ptr(const self_type& sp) {
-                assert( (++m_ref != 0) );
-                m_ptr = sp.m_ptr;
+                    if(m_pControl == nullptr) {
+                        delete ptr;
+                        m_ptr = nullptr;
+                    }
+                }
             }
 
-            ~basic_shared_ptr() {
-                if (--m_ref == 0) delete m_ptr;
+            /**
+             * @brief Take the ownership of a object, the deleter destroys it.
+             * A nullptr allocates no control block. When the control block can not be
+             * allocated then the deleter destroys the object and the pointer stay empty.
+             */
+            template <typename U, class TDeleter>
+            basic_shared_ptr(U* ptr, TDeleter deleter)
+                : m_ptr(ptr), m_pControl(nullptr) {
+                if(ptr != nullptr) {
+                    m_pControl = new (std::nothrow) basic_shared_control_ptr<U, TDeleter>(ptr, deleter);
+
+                    if(m_pControl == nullptr) {
+                        deleter(ptr);
+                        m_ptr = nullptr;
+                    }
+                }
             }
 
-            pointer release() {
-                pointer __px = this->get();
-                if (--m_ref == 0) delete m_ptr;
+            basic_shared_ptr(const self_type& other) noexcept
+                : m_ptr(other.m_ptr), m_pControl(other.m_pControl) {
+                if(m_pControl) m_pControl->add_ref();
+            }
 
-                return __px;
+            template <typename U>
+            basic_shared_ptr(const basic_shared_ptr<U>& other) noexcept
+                : m_ptr(other.m_ptr), m_pControl(other.m_pControl) {
+                if(m_pControl) m_pControl->add_ref();
             }
-            void reset( pointer pValue = 0)
-                { self_type(pValue).swap(*this); }
 
-            ref_type ref() {
-                return m_ref;
+            basic_shared_ptr(self_type&& other) noexcept
+                : m_ptr(other.m_ptr), m_pControl(other.m_pControl) {
+                other.m_ptr = nullptr;
+                other.m_pControl = nullptr;
             }
-            void swap(self_type& b) {
-                mofw::swap<pointer>(m_ptr, b.m_ptr);
-                mofw::swap<ref_type >(m_ref, b.m_ref);
+
+            template <typename U>
+            basic_shared_ptr(basic_shared_ptr<U>&& other) noexcept
+                : m_ptr(other.m_ptr), m_pControl(other.m_pControl) {
+                other.m_ptr = nullptr;
+                other.m_pControl = nullptr;
             }
 
-            pointer get() const {
-		        return static_cast<T*>(m_ptr);
-	        }
+            /**
+             * @brief The aliasing constructor: share the ownership of other, but point to ptr
+             */
+            template <typename U>
+            basic_shared_ptr(const basic_shared_ptr<U>& other, pointer ptr) noexcept
+                : m_ptr(ptr), m_pControl(other.m_pControl) {
+                if(m_pControl) m_pControl->add_ref();
+            }
 
-            pointer operator->() const {
-                assert(get() != 0);
-                return this->get();
+            /**
+             * @brief Create from a weak pointer, empty when the object is gone
+             */
+            template <typename U>
+            explicit basic_shared_ptr(const basic_weak_ptr<U>& other) noexcept
+                : m_ptr(nullptr), m_pControl(nullptr) {
+                if(other.m_pControl && other.m_pControl->add_ref_lock()) {
+                    m_ptr = other.m_ptr;
+                    m_pControl = other.m_pControl;
+                }
             }
-            const_value_type& operator*() {
-                assert(get() != 0);
-                return *this->get();
+
+            ~basic_shared_ptr() {
+                if(m_pControl) m_pControl->release();
             }
-            operator bool() {
-                return m_ptr != 0;
+
+            self_type& operator = (const self_type& other) noexcept {
+                self_type(other).swap(*this);
+                return *this;
+            }
+
+            template <typename U>
+            self_type& operator = (const basic_shared_ptr<U>& other) noexcept {
+                self_type(other).swap(*this);
+                return *this;
+            }
+
+            self_type& operator = (self_type&& other) noexcept {
+                self_type(mofw::move(other)).swap(*this);
+                return *this;
             }
 
-            self_type& operator = (self_type& sp) {
-                release();
-                m_ptr = sp.m_ptr;
-                m_ref = sp.m_ref;
+            template <typename U>
+            self_type& operator = (basic_shared_ptr<U>&& other) noexcept {
+                self_type(mofw::move(other)).swap(*this);
                 return *this;
             }
+
+            /**
+             * @brief Release the ownership, the pointer is empty after
+             */
+            void reset() noexcept {
+                self_type().swap(*this);
+            }
+            template <typename U>
+            void reset(U* ptr) {
+                self_type(ptr).swap(*this);
+            }
+            template <typename U, class TDeleter>
+            void reset(U* ptr, TDeleter deleter) {
+                self_type(ptr, deleter).swap(*this);
+            }
+
+            void swap(self_type& other) noexcept {
+                mofw::swap(m_ptr, other.m_ptr);
+                mofw::swap(m_pControl, other.m_pControl);
+            }
+
+            pointer get() const noexcept            { return m_ptr; }
+
+            reference operator*() const noexcept {
+                assert(m_ptr != nullptr);
+                return *m_ptr;
+            }
+            pointer operator->() const noexcept {
+                assert(m_ptr != nullptr);
+                return m_ptr;
+            }
+            explicit operator bool() const noexcept { return m_ptr != nullptr; }
+
+            /**
+             * @brief Get the number of shared pointers, that own the object
+             */
+            size_t use_count() const noexcept {
+                return m_pControl ? m_pControl->use_count() : 0;
+            }
+            bool unique() const noexcept            { return use_count() == 1; }
+
+            template <typename U>
+            bool owner_before(const basic_shared_ptr<U>& other) const noexcept {
+                return m_pControl < other.m_pControl;
+            }
+            template <typename U>
+            bool owner_before(const basic_weak_ptr<U>& other) const noexcept {
+                return m_pControl < other.m_pControl;
+            }
+        private:
+            struct adopt_control_t { };
+
+            /**
+             * @brief Adopt the first strong reference of the control block
+             */
+            basic_shared_ptr(pointer ptr, control_type* control, adopt_control_t) noexcept
+                : m_ptr(ptr), m_pControl(control) { }
         private:
-            ref_type m_ref;
             pointer m_ptr;
+            control_type* m_pControl;
         };
 
-        template < typename T, typename TRefType >
-        void swap(basic_shared_ptr<T, TRefType>& a, basic_shared_ptr<T, TRefType>& b) {
+        template <typename T, typename U>
+        inline bool operator == (const basic_shared_ptr<T>& a, const basic_shared_ptr<U>& b) noexcept {
+            return a.get() == b.get();
+        }
+        template <typename T, typename U>
+        inline bool operator != (const basic_shared_ptr<T>& a, const basic_shared_ptr<U>& b) noexcept {
+            return a.get() != b.get();
+        }
+        template <typename T, typename U>
+        inline bool operator < (const basic_shared_ptr<T>& a, const basic_shared_ptr<U>& b) noexcept {
+            return a.get() < b.get();
+        }
+        template <typename T>
+        inline bool operator == (const basic_shared_ptr<T>& a, nullptr_t) noexcept {
+            return a.get() == nullptr;
+        }
+        template <typename T>
+        inline bool operator != (const basic_shared_ptr<T>& a, nullptr_t) noexcept {
+            return a.get() != nullptr;
+        }
+
+        template <typename T>
+        void swap(basic_shared_ptr<T>& a, basic_shared_ptr<T>& b) noexcept {
         	a.swap(b);
         }
 
+        template <typename T, typename U>
+        inline basic_shared_ptr<T> static_pointer_cast(const basic_shared_ptr<U>& other) noexcept {
+            return basic_shared_ptr<T>(other, static_cast<T*>(other.get()));
+        }
+        template <typename T, typename U>
+        inline basic_shared_ptr<T> const_pointer_cast(const basic_shared_ptr<U>& other) noexcept {
+            return basic_shared_ptr<T>(other, const_cast<T*>(other.get()));
+        }
+
         template < typename T >
-		using shared_ptr = basic_shared_ptr<T, size_t>;
+		using shared_ptr = basic_shared_ptr<T>;
+
+		namespace internal {
+			/**
+			 * @brief Get the memory::default_allocator of make_shared, it lives as long as
+			 * the program, so the control blocks can hold a reference to it
+			 */
+			inline memory::default_allocator& get_shared_allocator() noexcept {
+				static memory::default_allocator _alloc;
+				return _alloc;
+			}
+		}
 
+		/**
+		 * @brief The counts of all shared pointers are atomic, the same as shared_ptr
+		 */
 		template < typename T >
-		using shared_atomic_ptr = basic_shared_ptr<T, atomic_size_t>;
+		using shared_atomic_ptr = basic_shared_ptr<T>;
+
+		/**
+		 * @brief Make a shared pointer, the object and the control block in one allocation
+		 * @tparam T Value type of the pointer.
+		 * @tparam TAllocator The allocator for the allocation
+		 * @param alloc The allocator, the control block holds a reference to it, so it must
+		 * live as long as the last shared and weak pointer of the object
+		 * @param args Argument for the object.
+		 * @return The shared pointer, empty when the allocation failed
+		 */
+		template<typename T, class TAllocator, typename... Args >
+		inline basic_shared_ptr<T> allocate_shared(TAllocator& alloc, Args&&... args) {
+			using control_type = basic_shared_control_inplace<T, TAllocator>;
+
+			void* _mem = alloc.allocate(sizeof(control_type), alignof(control_type));
+
+			if(_mem == nullptr) return basic_shared_ptr<T>();
+
+			control_type* _control = ::new (_mem) control_type(alloc, mofw::forward<Args>(args)...);
+			return basic_shared_ptr<T>(_control->get(), _control,
+				typename basic_shared_ptr<T>::adopt_control_t());
+		}
 
 		/**
-		 * @brief Make a shared pointer
+		 * @brief Make a shared pointer, the object and the control block in one allocation
+		 * from the memory::default_allocator
 		 * @tparam T Value type of the pointer.
 		 * @tparam Args Argument for the object.
 		 */
 		template<typename T, typename... Args >
 		inline shared_ptr<T> make_shared(Args&&... args) {
-			return shared_ptr<T>(new T (mofw::forward<Args>(args)...) );
+			return allocate_shared<T>(internal::get_shared_allocator(), mofw::forward<Args>(args)...);
 		}
 
 		/**
@@ -122,7 +468,7 @@ namespace mofw {
 		 */
 		template<typename T, typename... Args >
 		inline shared_atomic_ptr<T> make_atomic_shared(Args&&... args) {
-			return shared_atomic_ptr<T>(new T (mofw::forward<Args>(args)...) );
+			return make_shared<T>(mofw::forward<Args>(args)...);
 		}
     }
 }
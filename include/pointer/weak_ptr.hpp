@@ -25,109 +25,122 @@
 
 namespace mofw {
     namespace pointer {
-        template <typename T, typename TRefType = atomic_size_t >
+        /**
+         * @brief A weak pointer to a object of basic_shared_ptr.
+         *
+         * Holds a weak reference on the control block, so the control block lives, but
+         * not the object. lock() gives a shared pointer, when the object is still alive.
+         *
+         * @tparam T The type of the object
+         */
+        template <typename T>
         class basic_weak_ptr {
+            template <typename U> friend class basic_shared_ptr;
+            template <typename U> friend class basic_weak_ptr;
         public:
             using value_type = T;
             using element_type = T;
             using reference = T&;
-            using const_value_type = const value_type;
             using pointer = value_type*;
-            using count_type = TRefType;
+            using control_type = basic_shared_control;
 
+            using self_type = basic_weak_ptr<value_type>;
+            using shared_type = basic_shared_ptr<value_type>;
 
-            using self_type = basic_weak_ptr<value_type, count_type>;
-            using shared_type = basic_shared_ptr<value_type, count_type>;
+            constexpr basic_weak_ptr() noexcept
+                : m_ptr(nullptr), m_pControl(nullptr)  { }
 
+            basic_weak_ptr( const self_type& r ) noexcept
+                : m_ptr(r.m_ptr), m_pControl(r.m_pControl)  {
+                if(m_pControl) m_pControl->weak_add_ref();
+            }
 
-            explicit basic_weak_ptr(value_type pValue = 0)
-                : m_ptr(pValue), m_ref(1)  { }
-
-            basic_weak_ptr( const self_type& r )
-                : m_ptr(r.m_ptr), m_ref(r.m_ref)  { }
-
-            basic_weak_ptr( shared_type& pShrd)
-                : m_ptr(pShrd.get()), m_ref( pShrd.ref() ) {}
-
-            template<class U, typename YRefType = count_type>
-            basic_weak_ptr( const basic_weak_ptr<U, YRefType>& r )
-                : m_ptr(r.m_ptr), m_ref(r.m_ref)  { }
-
-            template<class U, typename YRefType = count_type>
-            basic_weak_ptr( const basic_shared_ptr<U, YRefType>& pShrd)
-                : m_ptr(pShrd.get()), m_ref(pShrd.ref() ) {}
-
-            shared_type lock()                          { return shared_type(m_ptr); }
-            bool expired()                              { return m_ref.get() == 0; }
-            void reset()                                { self_type(0).swap(*this); }
-
-            count_type use_count()                  	{ return m_ref.get(); }
+            template<class U>
+            basic_weak_ptr( const basic_weak_ptr<U>& r ) noexcept
+                : m_ptr(r.m_ptr), m_pControl(r.m_pControl)  {
+                if(m_pControl) m_pControl->weak_add_ref();
+            }
 
-            void swap(self_type& other) {
-                mofw::swap<pointer>(m_ptr, other.m_ptr);
-                mofw::swap<count_type >(m_ref, other.m_ref);
+            template<class U>
+            basic_weak_ptr( const basic_shared_ptr<U>& pShrd) noexcept
+                : m_ptr(pShrd.m_ptr), m_pControl(pShrd.m_pControl) {
+                if(m_pControl) m_pControl->weak_add_ref();
             }
-            template<class Y, typename YRefType = atomic_size_t>
-            bool owner_before( const basic_weak_ptr<Y, YRefType> & rhs ) {
-                return m_ref < rhs.m_ref;
+
+            basic_weak_ptr( self_type&& r ) noexcept
+                : m_ptr(r.m_ptr), m_pControl(r.m_pControl)  {
+                r.m_ptr = nullptr;
+                r.m_pControl = nullptr;
             }
-            template<class Y, typename YRefType = atomic_size_t>
-            bool owner_before( const basic_shared_ptr<Y, YRefType> & rhs ) {
-                return m_ref < rhs.ref();
+
+            ~basic_weak_ptr() {
+                if(m_pControl) m_pControl->weak_release();
             }
 
-            pointer get() const {
-		        return static_cast<T*>(m_ptr);
-	        }
+            self_type& operator=( const self_type& r ) noexcept {
+                self_type(r).swap(*this);
+                return *this;
+            }
 
-            pointer operator->() const {
-                assert(get() != 0);
-                return this->get();
+            template<class U>
+            self_type& operator=( const basic_shared_ptr<U>& r ) noexcept {
+                self_type(r).swap(*this);
+                return *this;
             }
-            const_value_type& operator*() {
-                assert(get() != 0);
-                return *this->get();
+
+            self_type& operator=( self_type&& r ) noexcept {
+                self_type(mofw::move(r)).swap(*this);
+                return *this;
             }
 
-            operator bool() {
-                return m_ptr != 0;
+            /**
+             * @brief Get a shared pointer to the object
+             * @return The shared pointer, empty when the object is gone
+             */
+            shared_type lock() const noexcept           { return shared_type(*this); }
+            /**
+             * @brief Is the object gone?
+             */
+            bool expired() const noexcept               { return use_count() == 0; }
+            void reset() noexcept                       { self_type().swap(*this); }
+
+            /**
+             * @brief Get the number of shared pointers, that own the object
+             */
+            size_t use_count() const noexcept {
+                return m_pControl ? m_pControl->use_count() : 0;
             }
 
-            self_type& operator=( const self_type& r ) {
-                m_ptr = r.m_ptr;
-                m_ref = r.m_ref;
-                return *this;
+            void swap(self_type& other) noexcept {
+                mofw::swap(m_ptr, other.m_ptr);
+                mofw::swap(m_pControl, other.m_pControl);
+            }
+            template<class Y>
+            bool owner_before( const basic_weak_ptr<Y>& rhs ) const noexcept {
+                return m_pControl < rhs.m_pControl;
+            }
+            template<class Y>
+            bool owner_before( const basic_shared_ptr<Y>& rhs ) const noexcept {
+                return m_pControl < rhs.m_pControl;
             }
         private:
         	pointer m_ptr;
-            count_type m_ref;
+            control_type* m_pControl;
         };
 
-        template < typename T >
-		using weak_ptr = basic_weak_ptr<T, size_t>;
-
-		template < typename T >
-		using weak_atomic_ptr = basic_weak_ptr<T, atomic_size_t>;
+        template <typename T>
+        void swap(basic_weak_ptr<T>& a, basic_weak_ptr<T>& b) noexcept {
+        	a.swap(b);
+        }
 
-		/**
-		 * @brief Make a weak pointer
-		 * @tparam T Value type of the pointer.
-		 * @tparam Args Argument for the object.
-		 */
-		template<typename T, typename... Args >
-		inline weak_ptr<T>  make_weak(Args&&... args) {
-			return weak_ptr<T>(new T (mofw::forward<Args>(args)...) );
-		}
+        template < typename T >
+		using weak_ptr = basic_weak_ptr<T>;
 
 		/**
-		 * @brief Make a weak atomic pointer
-		 * @tparam T Value type of the pointer.
-		 * @tparam Args Argument for the object.
+		 * @brief The counts of all weak pointers are atomic, the same as weak_ptr
 		 */
-		template<typename T, typename... Args >
-		inline weak_atomic_ptr<T> make_atomic_weak(Args&&... args) {
-			return weak_atomic_ptr<T>(new T (mofw::forward<Args>(args)...) );
-		}
+		template < typename T >
+		using weak_atomic_ptr = basic_weak_ptr<T>;
     }
 }
 
@@ -107,6 +107,17 @@ namespace mofw {
              * @return true If workqueue is ready, false If not
              */ 
             bool is_ready();
+
+            /**
+             * Get the number of worker tasks of this workqueue
+             */
+            virtual uint8_t get_num_worker() const;
+            /**
+             * Is the calling task a worker task of this workqueue?
+             *
+             * @return true If the calling task is a worker, false If not
+             */
+            virtual bool is_worker();
         protected:
             /**
              * Get the next item / job from queue
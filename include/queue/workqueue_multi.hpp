@@ -52,7 +52,11 @@ namespace mofw {
              * Get the real num worker tasks for this workqueue engine
              * @return The real num worker threads for this workqueue engine
              */ 
-            uint8_t get_num_worker() const;
+            virtual uint8_t get_num_worker() const override;
+            /**
+             * Is the calling task a worker task of this workqueue?
+             */
+            virtual bool is_worker() override;
             /**
              * Get the num worker tasks for this workqueue engine
              * @return The num worker threads for this workqueue engine
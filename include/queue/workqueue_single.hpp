@@ -44,6 +44,11 @@ namespace mofw {
              * Our destructor.
              */
             ~basic_work_queue_single();
+
+            /**
+             * Is the calling task the worker task of this workqueue?
+             */
+            virtual bool is_worker() override;
         protected:
             /**
              * Create the work_queue_t.
@@ -0,0 +1,258 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify  
+*it under the terms of the GNU Lesser General Public License as published by  
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but 
+*WITHOUT ANY WARRANTY; without even the implied warranty of 
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.  
+*/
+#ifndef MINLIB_ESP32_WORK_QUEUE_STEALING_
+#define MINLIB_ESP32_WORK_QUEUE_STEALING_
+
+#include "workqueue.hpp"
+#include "../atomic.hpp"
+#include "../container/atomic_queue.hpp"
+#include "../container/stealing_deque.hpp"
+#include <vector>
+
+namespace mofw {
+    namespace queue {
+        class basic_work_queue_stealing;
+
+        /**
+         * The worker task for the work stealing workqueue engine.
+         *
+         * Each worker owns a local Chase-Lev deque and a lock free inbox for items from
+         * other tasks. The worker pop his deque, then move a batch from his inbox to the
+         * deque, then steal from his siblings and sleep on a task notification when all
+         * is empty.
+         *
+         * @ingroup queue
+         */
+        class work_queue_stealing_task : public basic_task {
+        public:
+            using deque_type = mofw::container::basic_stealing_deque<work_queue_item,
+                                    MN_THREAD_CONFIG_WORKQUEUE_STEALING_DEQUESIZE>;
+            using inbox_type = mofw::container::basic_atomic_queue<work_queue_item*,
+                                    MN_THREAD_CONFIG_WORKQUEUE_STEALING_INBOXSIZE>;
+
+            /**
+             * The counters of a worker
+             */
+            struct stats {
+                uint32_t executed;  /*!< The number of items that are run from this worker */
+                uint32_t errors;    /*!< The number of items that returns false */
+                uint32_t stolen;    /*!< The number of items that this worker steal from his siblings */
+            };
+
+            /**
+             * Constructor for this workqueue task.
+             *
+             * @param strName Name of the task. Only useful for debugging.
+             * @param uiPriority FreeRTOS priority of this Task.
+             * @param usStackDepth Number of "words" allocated for the Task stack.
+             * @param parent The work stealing work_queue for this worker Task
+             * @param uiIndex The index of this worker in the parent
+             */
+            work_queue_stealing_task(char const* strName, basic_task::priority uiPriority,
+                                    unsigned short  usStackDepth,
+                                    basic_work_queue_stealing* parent,
+                                    uint8_t uiIndex);
+
+            /**
+             * Push a item to the local deque, only call from this worker
+             * @return True when the item is pushed and false when the deque is full
+             */
+            bool push_local(work_queue_item* item);
+            /**
+             * Post a item to the inbox of this worker, can call from any task
+             * @return True when the item is posted and false when the inbox is full
+             */
+            bool post(work_queue_item* item);
+            /**
+             * Post many items to the inbox of this worker, can call from any task
+             * @return The number of posted items
+             */
+            size_t post_bulk(work_queue_item** items, size_t count);
+            /**
+             * Steal a item from the deque or the inbox of this worker, can call from any task
+             * @return True when a item was stolen
+             */
+            bool steal(work_queue_item*& item);
+            /**
+             * Wake up this worker when it sleeps
+             */
+            void wakeup();
+            /**
+             * Is this worker idle, it found no item and sleep or is about to sleep
+             */
+            bool is_idle() const;
+
+            /**
+             * Get a snapshot of the counters of this worker
+             */
+            stats get_stats() const;
+        protected:
+            virtual int on_task() override;
+        private:
+            /**
+             * Get the next item, from the deque, the inbox or from the siblings
+             */
+            work_queue_item* get_next_item();
+            /**
+             * Run the item and update the counters
+             */
+            void execute(work_queue_item* item);
+        private:
+            deque_type m_dqLocal;
+            inbox_type m_qInbox;
+
+            basic_work_queue_stealing* m_parentWorkQueue;
+            uint8_t m_uiIndex;
+
+            mofw::atomic_uint32_t m_uiExecuted;
+            mofw::atomic_uint32_t m_uiErrors;
+            mofw::atomic_uint32_t m_uiStolen;
+            /**
+             * True while the worker look a last time for a item and sleep
+             */
+            mofw::atomic_bool m_bIdle;
+        };
+
+        /**
+         * This class is the work stealing multi task "engine" for work_queue_items.
+         *
+         * Unlike basic_work_queue_multi there is no shared queue and no shared lock:
+         * queue() from a worker (a item that queue items) push to the local deque of the
+         * worker and queue() from any other task post the item round robin to the inbox of
+         * a worker. Idle workers steal from their siblings. The workers are pinned round
+         * robin to the cores.
+         *
+         * @note queue() never blocks, when all inboxes are full it returns ERR_WORKQUEUE_ADD.
+         * @note The counters of the base (get_num_items_worked) are not updated, use
+         * get_num_executed() and get_worker_stats().
+         *
+         * @ingroup queue
+         */
+        class basic_work_queue_stealing : public basic_work_queue {
+            friend class work_queue_stealing_task;
+        public:
+            /**
+             * Our constructor.
+             *
+             * @param uiPriority FreeRTOS priority of the worker tasks.
+             * @param usStackDepth Number of "words" allocated for the task stack.
+             * @param uiMaxWorkers How many Worker tasks run with this workqueue
+             */
+            basic_work_queue_stealing(basic_task::priority uiPriority = MN_THREAD_CONFIG_WORKQUEUE_STEALING_PRIORITY,
+                        uint16_t usStackDepth = MN_THREAD_CONFIG_WORKQUEUE_STEALING_STACKSIZE,
+                        uint8_t uiMaxWorkers = MN_THREAD_CONFIG_WORKQUEUE_STEALING_WORKER);
+
+            /**
+             * Our destructor.
+             */
+            ~basic_work_queue_stealing();
+
+            /**
+             * Send a work_queue_item_t off to be executed.
+             *
+             * @param work Pointer to a work_queue_item_t.
+             * @param timeout Not used, this function never blocks
+             *
+             * @return
+             *  - ERR_WORKQUEUE_OK The work_queue_item_t are added
+             *  - ERR_WORKQUEUE_ADD If The work_queue_item_t are not added
+             */
+            virtual int queue(work_queue_item_t *work,
+                            unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_QUEUE_DEFAULT) override;
+
+            /**
+             * Send many work_queue_item_t off to be executed, the items are split in
+             * batches over all workers. A worker is notified once for each batch that is
+             * posted to his inbox: once in the first pass, and once more when he takes a
+             * part of the rest that did not fit in the other inboxes.
+             *
+             * @param works Array of pointers to work_queue_item_t.
+             * @param count The number of items in works
+             * @return The number of added items
+             */
+            size_t queue_bulk(work_queue_item_t **works, size_t count);
+
+            /**
+             * Get the number of worker tasks for this workqueue engine
+             */
+            virtual uint8_t get_num_worker() const override;
+            /**
+             * Is the calling task a worker task of this workqueue?
+             */
+            virtual bool is_worker() override;
+            /**
+             * Get a snapshot of the counters of the given worker
+             * @param uiIndex The index of the worker
+             */
+            work_queue_stealing_task::stats get_worker_stats(uint8_t uiIndex) const;
+            /**
+             * Get the number of executed items of all workers
+             */
+            uint32_t get_num_executed() const;
+        protected:
+            /**
+             * Steal a item from any worker
+             */
+            virtual work_queue_item* get_next_item(unsigned int timeout) override;
+
+            /**
+             * Create and start all worker tasks, the worker n run on core (iCore + n) % portNUM_PROCESSORS
+             *
+             * @param iCore The core of the first worker
+             * @return
+             *   - ERR_WORKQUEUE_OK The engine is created
+             *   - ERR_WORKQUEUE_ALREADYINIT The engine is allready created
+             *   - ERR_WORKQUEUE_WARNING Not all worker tasks are created
+             *   - ERR_WORKQUEUE_CANTCREATE The engine can not created
+             */
+            int create_engine(int iCore);
+
+            /**
+             * Wake up, destroy and delete all worker tasks. The items that are left in
+             * the deques and inboxes are dropped, and deleted when can_delete() is true.
+             */
+            void destroy_engine();
+
+            /**
+             * Steal a item for the given worker from his siblings
+             */
+            bool steal_for(uint8_t uiThief, work_queue_item*& item);
+            /**
+             * Get the worker that is the current task, or NULL when the current task is not a worker
+             */
+            work_queue_stealing_task* get_current_worker();
+            /**
+             * Wake up one idle worker, that is not the given worker
+             */
+            void wakeup_idle(work_queue_stealing_task* self);
+        private:
+            /**
+             * Vector for all workqueue tasks
+             */
+            std::vector<work_queue_stealing_task*> m_Workers;
+            /**
+             * The next worker for round robin post
+             */
+            mofw::atomic_uint32_t m_uiNextWorker;
+        };
+
+        using stealing_engine_workqueue_t = basic_work_queue_stealing;
+    }
+}
+
+#endif
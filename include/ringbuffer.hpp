@@ -25,8 +25,10 @@
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 
+#include "atomic.hpp"
 #include "autolock.hpp"
 #include "allocator.hpp"
+#include "algorithm.hpp"
 
 
 namespace mofw {
@@ -333,9 +335,253 @@ namespace mofw {
             lock_type   m_lockObject;
         };
 
+        /**
+         * @brief Use as TLOCK for basic_ring_buffer to get the wait free single producer /
+         * single consumer version, without any lock object.
+         */
+        struct spsc_tag { };
+
+        /**
+         * @brief A contiguous region of a ring buffer, for zero copy access.
+         * @tparam T The type of the elements
+         */
+        template <class T>
+        struct basic_ring_buffer_span {
+            using value_type = T;
+            using pointer = T*;
+            using size_type = size_t;
+
+            basic_ring_buffer_span() noexcept : m_pData(nullptr), m_uiSize(0) { }
+            basic_ring_buffer_span(pointer data, size_type size) noexcept : m_pData(data), m_uiSize(size) { }
+
+            pointer data() const noexcept       { return m_pData; }
+            size_type size() const noexcept     { return m_uiSize; }
+            bool empty() const noexcept         { return m_uiSize == 0; }
+
+            pointer begin() const noexcept      { return m_pData; }
+            pointer end() const noexcept        { return m_pData + m_uiSize; }
+        private:
+            pointer     m_pData;
+            size_type   m_uiSize;
+        };
+
+        /**
+         * @brief A wait free single producer / single consumer ring buffer.
+         *
+         * The write position is only written from the producer and the read position only from
+         * the consumer, each lives on his own cache line. The producer publish the elements with
+         * a release store of the write position and the consumer gives the space back with a
+         * release store of the read position. The positions are free running and masked with
+         * TCAPACITY - 1. The producer can be a ISR.
+         *
+         * For zero copy (DMA like) access the producer can get the contiguous free region with
+         * write_region(), fill it and publish it with commit_write(), the consumer do the same
+         * with read_region() and commit_read().
+         *
+         * @note Unlike the locked version push_back not overwrite the oldest element when the
+         * buffer is full, it returns false.
+         * @note size() returns the number of stored elements and capacity() TCAPACITY.
+         *
+         * @tparam T          Type of element. Required to be a complete type.
+         * @tparam TCAPACITY  The maximal capacity of elements, must be a power of two
+         */
+        template <class T, size_t TCAPACITY>
+        class basic_ring_buffer<T, TCAPACITY, spsc_tag> {
+            static_assert(TCAPACITY >= 2, "TCAPACITY must be greater then one");
+            static_assert((TCAPACITY & (TCAPACITY - 1)) == 0, "TCAPACITY must be a power of two");
+        public:
+            using value_type = T;
+            using pointer = T*;
+            using const_pointer = const T*;
+            using reference = T&;
+            using const_reference = const T&;
+            using size_type = size_t;
+            using difference_type = ptrdiff_t;
+            using lock_type = spsc_tag;
+            using span_type = basic_ring_buffer_span<T>;
+            using const_span_type = basic_ring_buffer_span<const T>;
+            using self_type = basic_ring_buffer<T, TCAPACITY, spsc_tag>;
+
+            basic_ring_buffer() noexcept
+                : m_atWrite(0), m_uiCachedRead(0), m_atRead(0), m_uiCachedWrite(0) { }
+
+            basic_ring_buffer(const self_type& other) = delete;
+            self_type& operator = (const self_type& other) = delete;
+
+            /**
+             * @brief Push a value to the end of the buffer, only call from the producer
+             * @param value The value to add
+             * @return True when the value is added and false when the buffer is full
+             */
+            bool push_back(const value_type &value) noexcept {
+                span_type _region = write_region();
+
+                if(_region.empty()) return false;
+
+                *_region.data() = value;
+                commit_write(1);
+
+                return true;
+            }
+
+            /**
+             * @brief Pop the element from the front, only call from the consumer
+             * @param value The reference for the poped value
+             * @return True when a value is poped and false when the buffer is empty
+             */
+            bool pop_front(reference value) noexcept {
+                span_type _region = read_region();
+
+                if(_region.empty()) return false;
+
+                value = *_region.data();
+                commit_read(1);
+
+                return true;
+            }
+
+            /**
+             * @brief Write (copy) many elements in the buffer, only call from the producer
+             * @param values The elements to write
+             * @param count The number of elements
+             * @return The number of written elements, less then count when the buffer is full
+             */
+            size_type write(const_pointer values, size_type count) noexcept {
+                size_type _written = 0;
+
+                while(_written < count) {
+                    span_type _region = write_region();
+                    if(_region.empty()) break;
+
+                    size_type _n = mofw::min(_region.size(), count - _written);
+                    for(size_type i = 0; i < _n; i++)
+                        _region.data()[i] = values[_written + i];
+
+                    commit_write(_n);
+                    _written += _n;
+                }
+                return _written;
+            }
+            /**
+             * @brief Write (copy) a span of elements in the buffer, only call from the producer
+             * @return The number of written elements
+             */
+            size_type write(const const_span_type& values) noexcept {
+                return write(values.data(), values.size());
+            }
+
+            /**
+             * @brief Read (copy) many elements from the buffer, only call from the consumer
+             * @param values The buffer for the elements
+             * @param count The maximal number of elements to read
+             * @return The number of read elements
+             */
+            size_type read(pointer values, size_type count) noexcept {
+                size_type _read = 0;
+
+                while(_read < count) {
+                    span_type _region = read_region();
+                    if(_region.empty()) break;
+
+                    size_type _n = mofw::min(_region.size(), count - _read);
+                    for(size_type i = 0; i < _n; i++)
+                        values[_read + i] = _region.data()[i];
+
+                    commit_read(_n);
+                    _read += _n;
+                }
+                return _read;
+            }
+            /**
+             * @brief Read (copy) elements from the buffer into a span, only call from the consumer
+             * @return The number of read elements
+             */
+            size_type read(const span_type& values) noexcept {
+                return read(values.data(), values.size());
+            }
+
+            /**
+             * @brief Get the contiguous free region to write, only call from the producer.
+             * The region ends at the end of the storage, call again after commit_write to get
+             * the wrapped part.
+             * @return The free region, empty when the buffer is full
+             */
+            span_type write_region() noexcept {
+                size_type _write = m_atWrite.load(memory_order::Relaxed);
+
+                if(_write - m_uiCachedRead == TCAPACITY)
+                    m_uiCachedRead = m_atRead.load(memory_order::Acquire);
+
+                size_type _free = TCAPACITY - (_write - m_uiCachedRead);
+                size_type _index = _write & (TCAPACITY - 1);
+
+                return span_type(&m_aStorage[_index], mofw::min(_free, TCAPACITY - _index));
+            }
+            /**
+             * @brief Publish count elements of the write region to the consumer
+             * @param count The number of written elements, must not greater then the region
+             */
+            void commit_write(size_type count) noexcept {
+                m_atWrite.store(m_atWrite.load(memory_order::Relaxed) + count, memory_order::Release);
+            }
+
+            /**
+             * @brief Get the contiguous region to read, only call from the consumer.
+             * The region ends at the end of the storage, call again after commit_read to get
+             * the wrapped part.
+             * @return The readable region, empty when the buffer is empty
+             */
+            span_type read_region() noexcept {
+                size_type _read = m_atRead.load(memory_order::Relaxed);
+
+                if(_read == m_uiCachedWrite)
+                    m_uiCachedWrite = m_atWrite.load(memory_order::Acquire);
+
+                size_type _used = m_uiCachedWrite - _read;
+                size_type _index = _read & (TCAPACITY - 1);
+
+                return span_type(&m_aStorage[_index], mofw::min(_used, TCAPACITY - _index));
+            }
+            /**
+             * @brief Give count read elements back to the producer
+             * @param count The number of read elements, must not greater then the region
+             */
+            void commit_read(size_type count) noexcept {
+                m_atRead.store(m_atRead.load(memory_order::Relaxed) + count, memory_order::Release);
+            }
+
+            /**
+             * @brief Get the number of stored elements in the buffer
+             * @note Only a snapshot when the producer or the consumer are running
+             */
+            size_type size() const noexcept {
+                return m_atWrite.load(memory_order::Acquire) - m_atRead.load(memory_order::Acquire);
+            }
+            /**
+             * @brief Get the maximal number of elements
+             */
+            constexpr size_type capacity() const noexcept { return TCAPACITY; }
+
+            bool empty() const noexcept { return size() == 0; }
+            bool full() const noexcept  { return size() == TCAPACITY; }
+        private:
+            T                       m_aStorage[TCAPACITY];
+
+            alignas(mofw::cache_line_size)
+            mofw::atomic_size_t     m_atWrite;
+            size_type               m_uiCachedRead;     ///< Producer copy of the read position
+
+            alignas(mofw::cache_line_size)
+            mofw::atomic_size_t     m_atRead;
+            size_type               m_uiCachedWrite;    ///< Consumer copy of the write position
+        };
+
         template <class T, size_t TCAPACITY = 100, typename TLOCK = LockType_t >
         using ringbuffer_t = basic_ring_buffer<T, TCAPACITY, TLOCK>;
 
+        template <class T, size_t TCAPACITY = 128>
+        using spsc_ringbuffer_t = basic_ring_buffer<T, TCAPACITY, spsc_tag>;
+
 #ifdef __EXPERT
         template<class TRingBuffer, class TARRAY >
         inline int write(TRingBuffer& rng, TARRAY& _array) {
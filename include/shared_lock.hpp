@@ -19,41 +19,156 @@
 #ifndef _MINLIB_SHARED_LOCK_H_
 #define _MINLIB_SHARED_LOCK_H_
 
-#include "shared.hpp"
-#include "Mutex.hpp"
-#include "lock.hpp"
+#include "config.hpp"
+#include "algorithm.hpp"
+#include "mutex.hpp"
+#include "shared_mutex.hpp"
 
 namespace mofw {
+    /**
+     * A movable shared ownership wrapper, the shared counterpart of unique_lock.
+     *
+     * @tparam Mutex The shared mutex type, with lock_shared, try_lock_shared and unlock_shared
+     */
+    template <class Mutex>
+    class shared_lock {
+    public:
+        using mutex_type = Mutex;
+
+        shared_lock() noexcept : m_mut(nullptr), m_owns(false) { }
+        explicit shared_lock(mutex_type& m, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT)
+            : m_mut(&m), m_owns(m.lock_shared(timeout) == ERR_MUTEX_OK) { }
+
+        shared_lock(mutex_type& m, defer_lock_t) noexcept
+            : m_mut(&m), m_owns(false) { }
+        shared_lock(mutex_type& m, try_to_lock_t)
+            : m_mut(&m), m_owns(m.try_lock_shared()) { }
+        shared_lock(mutex_type& m, adopt_lock_t)
+            : m_mut(&m), m_owns(true) { }
+
+        ~shared_lock() { if (m_owns) m_mut->unlock_shared(); }
+
+        shared_lock(shared_lock const&) = delete;
+        shared_lock& operator=(shared_lock const&) = delete;
+
+        shared_lock(shared_lock&& u) noexcept
+            : m_mut(u.m_mut), m_owns(u.m_owns) { u.m_mut = nullptr; u.m_owns = false; }
+
+        shared_lock& operator=(shared_lock&& u) noexcept {
+            if (m_owns) m_mut->unlock_shared();
+            m_mut = u.m_mut; m_owns = u.m_owns;
+            u.m_mut = nullptr; u.m_owns = false;
+            return *this;
+        }
+
+        void lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if (m_mut == nullptr) return;
+            if (m_owns) return;
+
+            m_owns = m_mut->lock_shared(timeout) == ERR_MUTEX_OK;
+        }
+        bool try_lock() {
+            if (m_mut == nullptr) return false;
+            if (m_owns) return true;
+
+            m_owns = m_mut->try_lock_shared();
+            return m_owns;
+        }
+        void unlock() {
+            if (!m_owns) return;
+            m_mut->unlock_shared();
+            m_owns = false;
+        }
+
+        void swap(shared_lock& u) noexcept {
+            mofw::swap(m_mut, u.m_mut);
+            mofw::swap(m_owns, u.m_owns);
+        }
+        mutex_type* release() noexcept {
+            mutex_type* _mut = m_mut;
+            m_mut = nullptr;
+            m_owns = false;
+            return _mut;
+        }
 
-    class shared_mutex {
+        bool owns_lock() const noexcept             { return m_owns; }
+        explicit operator bool () const noexcept    { return m_owns; }
+        mutex_type* mutex() const noexcept          { return m_mut; }
+    private:
+        mutex_type* m_mut;
+        bool        m_owns;
+    };
+
+    template <class _Mutex>
+    inline void swap(shared_lock<_Mutex>& a, shared_lock<_Mutex>& b) noexcept
+        { a.swap(b); }
+
+    /**
+     * A scoped upgrade lock: reads with the other readers, and can become the writer
+     * with upgrade() without a other writer between.
+     *
+     * @code{c}
+     * upgrade_lock<shared_mutex_t> lock(route_lock);
+     * if(needs_update(...)) {
+     *     lock.upgrade();     // waits for the readers
+     *     update(...);
+     * }
+     * @endcode
+     *
+     * @tparam Mutex The shared mutex type, basic_shared_mutex
+     */
+    template <class Mutex>
+    class upgrade_lock {
     public:
+        using mutex_type = Mutex;
+
+        explicit upgrade_lock(mutex_type& m, unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT)
+            : m_ref_lock(m), m_owns(m.lock_upgrade(timeout) == ERR_MUTEX_OK), m_bUnique(false) { }
+
+        ~upgrade_lock() { unlock(); }
+
+        upgrade_lock(upgrade_lock const&) = delete;
+        upgrade_lock& operator=(upgrade_lock const&) = delete;
+
         /**
-         * Resource constructor.
-         * @param value sets the initial value of the resource.
-         */
-        shared_mutex () { }
-        /**
-         * Get the value of the shared resource.
-         * @return The value of the shared resource.
+         * Convert the upgrade lock to the exclusive lock
+         * @return True when the task is now the writer
          */
-        void lock () const {
-            m_pReadWriteLock.lock();
-        }
+        bool upgrade(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if (!m_owns) return false;
+            if (m_bUnique) return true;
 
-    protected:
+            m_bUnique = m_ref_lock.unlock_upgrade_and_lock(timeout) == ERR_MUTEX_OK;
+            return m_bUnique;
+        }
         /**
-         * the controll mutex
+         * Convert the exclusive lock back to the upgrade lock
          */
-        mutex_t m_pReadWriteLock;
-    };
+        void downgrade() {
+            if (!m_bUnique) return;
+
+            m_ref_lock.unlock_and_lock_upgrade();
+            m_bUnique = false;
+        }
+        void unlock() {
+            if (!m_owns) return;
 
+            if (m_bUnique) m_ref_lock.unlock();
+            else m_ref_lock.unlock_upgrade();
 
-    template<typename TLOCK>
-    class shared_lock {
+            m_owns = false;
+            m_bUnique = false;
+        }
 
+        bool owns_lock() const noexcept             { return m_owns; }
+        bool is_unique() const noexcept             { return m_bUnique; }
+        explicit operator bool () const noexcept    { return m_owns; }
+    private:
+        mutex_type& m_ref_lock;
+        bool        m_owns;
+        bool        m_bUnique;
     };
-
 }
 
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,350 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef _MINLIB_SHARED_MUTEX_H_
+#define _MINLIB_SHARED_MUTEX_H_
+
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+
+#include "lock.hpp"
+#include "error.hpp"
+#include "atomic.hpp"
+#include "excp/lock_exptions.hpp"
+
+namespace mofw {
+    /**
+     * A reader writer lock: many readers or one writer.
+     *
+     * The lock state is one atomic word with the number of readers and the writer, upgrade
+     * and waiting flags. lock_shared and unlock_shared are a single compare exchange, while
+     * no writer holds or waits for the lock.
+     *
+     * Writers have preference: a waiting writer blocks new readers, so a steady stream of
+     * readers can not starve a writer. A task that holds a shared lock and locks it shared
+     * again may therefore block, the shared lock is not recursive.
+     *
+     * The upgrade lock is a shared lock, that only one task can hold at a time. It can be
+     * converted to the exclusive lock without a gap, in that a other writer takes the lock.
+     *
+     * Blocked tasks wait on two counting semaphores (readers and writers), the bookkeeping
+     * for the waiters is guarded by an internal FreeRTOS mutex. All functions are not for
+     * use in an ISR.
+     *
+     * @code{c}
+     * shared_mutex_t table_lock;
+     * ...
+     * { shared_lock<shared_mutex_t> lock(table_lock);   // many readers
+     *   lookup(...); }
+     * { unique_lock<shared_mutex_t> lock(table_lock);   // one writer
+     *   update(...); }
+     * @endcode
+     *
+     * @ingroup mutex
+     * @ingroup lock
+     */
+    class basic_shared_mutex : public ILockObject {
+        enum : uint32_t {
+            state_writer = 0x80000000u,         /*!< A writer holds the lock */
+            state_writer_waiting = 0x40000000u, /*!< Writers wait, new readers must wait too */
+            state_upgrade = 0x20000000u,        /*!< A task holds the upgrade lock */
+            state_readers_waiting = 0x10000000u,/*!< Readers wait */
+            state_readers = 0x0fffffffu         /*!< The mask for the number of readers */
+        };
+    public:
+        /**
+         * Create the shared mutex
+         *
+         * @note When enabled the config item MN_THREAD_CONFIG_USE_LOCK_CREATE then throw on error
+         * the lockcreate_exception exceptions.
+         */
+        basic_shared_mutex();
+        virtual ~basic_shared_mutex();
+
+        basic_shared_mutex(const basic_shared_mutex&) = delete;
+        basic_shared_mutex& operator=(const basic_shared_mutex&) = delete;
+
+        /**
+         * Lock the mutex exclusive (write lock)
+         *
+         * @param timeout How long to wait to get the Lock until giving up, in ticks.
+         * @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+         */
+        virtual int lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if(try_acquire_write()) return ERR_MUTEX_OK;
+
+            return (timeout == 0) ? ERR_MUTEX_LOCK : lock_slow(mode_write, timeout);
+        }
+        /**
+         * Lock the mutex exclusive (write lock)
+         *
+         * @param timeout The absolute time, how long to wait to get the Lock until giving up.
+         * @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+         */
+        virtual int time_lock(const struct timespec *timeout);
+        /**
+         * Unlock the exclusive lock
+         *
+         * @return ERR_MUTEX_OK if the Lock was released, ERR_MUTEX_UNLOCK if it was not locked.
+         */
+        virtual int unlock() {
+            uint32_t _state = m_uiState.fetch_and(~state_writer, memory_order::Release);
+
+            if( (_state & state_writer) == 0) return ERR_MUTEX_UNLOCK;
+            if(_state & (state_writer_waiting | state_readers_waiting)) wake();
+
+            return ERR_MUTEX_OK;
+        }
+        /**
+         * Try to lock the mutex exclusive, without waiting
+         *
+         * @return true if the Lock was acquired, false when not
+         */
+        virtual bool try_lock() { return try_acquire_write(); }
+
+        /**
+         * Lock the mutex shared (read lock)
+         *
+         * @param timeout How long to wait to get the Lock until giving up, in ticks.
+         * @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+         */
+        int lock_shared(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if(try_acquire_read()) return ERR_MUTEX_OK;
+
+            return (timeout == 0) ? ERR_MUTEX_LOCK : lock_slow(mode_read, timeout);
+        }
+        /**
+         * Lock the mutex shared (read lock)
+         *
+         * @param timeout The absolute time, how long to wait to get the Lock until giving up.
+         * @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+         */
+        int time_lock_shared(const struct timespec *timeout);
+        /**
+         * Unlock a shared lock
+         *
+         * @return ERR_MUTEX_OK if the Lock was released, ERR_MUTEX_UNLOCK if it was not locked.
+         */
+        int unlock_shared() {
+            uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+            do {
+                if( (_state & state_readers) == 0) return ERR_MUTEX_UNLOCK;
+            } while(!m_uiState.compare_exchange_weak(_state, _state - 1, memory_order::Release));
+
+            if( (_state & state_readers) == 1 &&
+                (_state & (state_writer_waiting | state_readers_waiting)) ) wake();
+
+            return ERR_MUTEX_OK;
+        }
+        /**
+         * Try to lock the mutex shared, without waiting
+         *
+         * @return true if the Lock was acquired, false when not
+         */
+        bool try_lock_shared() { return try_acquire_read(); }
+
+        /**
+         * Lock the upgrade lock: a shared lock, that can be converted to the exclusive lock
+         *
+         * @param timeout How long to wait to get the Lock until giving up, in ticks.
+         * @return ERR_MUTEX_OK if the Lock was acquired, ERR_MUTEX_LOCK if it timed out.
+         */
+        int lock_upgrade(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if(try_acquire_upgrade()) return ERR_MUTEX_OK;
+
+            return (timeout == 0) ? ERR_MUTEX_LOCK : lock_slow(mode_upgrade, timeout);
+        }
+        /**
+         * Try to lock the upgrade lock, without waiting
+         *
+         * @return true if the Lock was acquired, false when not
+         */
+        bool try_lock_upgrade() { return try_acquire_upgrade(); }
+        /**
+         * Unlock the upgrade lock
+         *
+         * @return ERR_MUTEX_OK if the Lock was released, ERR_MUTEX_UNLOCK if it was not locked.
+         */
+        int unlock_upgrade() {
+            uint32_t _state = m_uiState.fetch_and(~state_upgrade, memory_order::Release);
+
+            if( (_state & state_upgrade) == 0) return ERR_MUTEX_UNLOCK;
+            if(_state & (state_writer_waiting | state_readers_waiting)) wake();
+
+            return ERR_MUTEX_OK;
+        }
+        /**
+         * Convert the upgrade lock to the exclusive lock, wait until the readers are gone
+         *
+         * @param timeout How long to wait for the readers, in ticks.
+         * @return ERR_MUTEX_OK if the exclusive lock was acquired, ERR_MUTEX_LOCK if it timed
+         * out, the task holds then the upgrade lock.
+         */
+        int unlock_upgrade_and_lock(unsigned int timeout = MN_THREAD_CONFIG_TIMEOUT_MUTEX_DEFAULT) {
+            if(try_convert_upgrade()) return ERR_MUTEX_OK;
+
+            return (timeout == 0) ? ERR_MUTEX_LOCK : lock_slow(mode_convert, timeout);
+        }
+        /**
+         * Convert the exclusive lock to a shared lock, without a gap
+         */
+        int unlock_and_lock_shared() { return downgrade(state_writer, 1); }
+        /**
+         * Convert the exclusive lock to the upgrade lock, without a gap
+         */
+        int unlock_and_lock_upgrade() { return downgrade(state_writer, state_upgrade); }
+        /**
+         * Convert the upgrade lock to a shared lock, without a gap
+         */
+        int unlock_upgrade_and_lock_shared() { return downgrade(state_upgrade, 1); }
+
+        virtual bool is_initialized() const {
+            return (m_pGuard != NULL) && (m_pReadGate != NULL) && (m_pWriteGate != NULL);
+        }
+        /**
+         * @brief Is exclusive locked?
+         * @return True if a writer holds the lock and false when not.
+         */
+        virtual bool is_locked() const {
+            return (m_uiState.load(memory_order::Relaxed) & state_writer) != 0;
+        }
+        /**
+         * Get the number of readers, that hold the lock
+         */
+        uint32_t get_num_readers() const {
+            return m_uiState.load(memory_order::Relaxed) & state_readers;
+        }
+        /**
+         * Get the error code on creating
+         * @return The error code, ERR_MUTEX_OK when no error
+         */
+        int   get_error()                       { return m_iCreateErrorCode; }
+    protected:
+        /** Set the error codes @param error The error code */
+        void  set_error(int error)              { m_iCreateErrorCode = error; }
+    private:
+        enum lock_mode {
+            mode_read,
+            mode_write,
+            mode_upgrade,
+            mode_convert
+        };
+
+        bool try_acquire_read() {
+            uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+            while( (_state & (state_writer | state_writer_waiting)) == 0 &&
+                   (_state & state_readers) != state_readers) {
+                if(m_uiState.compare_exchange_weak(_state, _state + 1, memory_order::Acquire))
+                    return true;
+            }
+            return false;
+        }
+        bool try_acquire_write() {
+            uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+            while( (_state & (state_writer | state_upgrade | state_readers)) == 0) {
+                if(m_uiState.compare_exchange_weak(_state, _state | state_writer, memory_order::Acquire))
+                    return true;
+            }
+            return false;
+        }
+        bool try_acquire_upgrade() {
+            uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+            while( (_state & (state_writer | state_writer_waiting | state_upgrade)) == 0) {
+                if(m_uiState.compare_exchange_weak(_state, _state | state_upgrade, memory_order::Acquire))
+                    return true;
+            }
+            return false;
+        }
+        bool try_convert_upgrade() {
+            uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+            while( (_state & state_readers) == 0) {
+                if(m_uiState.compare_exchange_weak(_state, (_state & ~state_upgrade) | state_writer,
+                                                   memory_order::Acquire))
+                    return true;
+            }
+            return false;
+        }
+        bool try_acquire(lock_mode mode);
+
+        /**
+         * Register as waiter, block until the lock is acquired or the timeout is over
+         */
+        int lock_slow(lock_mode mode, unsigned int timeout);
+        /**
+         * Take the guard and wake the waiters
+         */
+        void wake();
+        /**
+         * Wake the waiting writers, or the readers when no writer waits. Call with the guard.
+         */
+        void notify();
+        /**
+         * Replace the flag with the new lock, and wake the waiting readers
+         */
+        int downgrade(uint32_t from, uint32_t to);
+        /**
+         * Set or clear the waiting flags, by the waiter counters. Call with the guard.
+         */
+        void update_waiting();
+    private:
+        atomic_uint32_t m_uiState;
+        /**
+         * Guard for the waiter counters, only on the slow path
+         */
+        void* m_pGuard;
+        /**
+         * The blocked readers and upgraders wait on this counting semaphore
+         */
+        void* m_pReadGate;
+        /**
+         * The blocked writers and converting upgraders wait on this counting semaphore
+         */
+        void* m_pWriteGate;
+        /**
+         * The number of blocked readers and upgraders, guarded by m_pGuard
+         */
+        uint32_t m_uiReadWaiters;
+        /**
+         * The number of blocked writers and converting upgraders, guarded by m_pGuard
+         */
+        uint32_t m_uiWriteWaiters;
+
+        #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+            StaticSemaphore_t m_GuardBuffer;
+            StaticSemaphore_t m_ReadGateBuffer;
+            StaticSemaphore_t m_WriteGateBuffer;
+        #endif
+
+        /**
+         * A saved / cached copy of error code on creating
+         */
+        int m_iCreateErrorCode;
+    };
+
+    using shared_mutex_t = basic_shared_mutex;
+    using shared_mutex = basic_shared_mutex;
+}
+
+#endif // _MINLIB_SHARED_MUTEX_H_
@@ -0,0 +1,415 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_STRING_H__
+#define __MINILIB_BASIC_STRING_H__
+
+#include "config.hpp"
+
+#include <string.h>
+
+#include "def.hpp"
+#include "algorithm.hpp"
+#include "allocator.hpp"
+#include "string_view.hpp"
+
+namespace mofw {
+	/**
+	 * @brief A null terminated string with small string optimization.
+	 *
+	 * Strings with up to TSSO chars are stored in the object itself and never touch the
+	 * heap, longer strings are allocated with TAllocator. The inline buffer shares the
+	 * memory with the capacity field, so the default string needs only a pointer, a size,
+	 * 16 chars and the (empty) allocator.
+	 *
+	 * To place the long strings in the SPIRAM use the caps allocator:
+	 * @code
+	 * using spiram_string = mofw::basic_string<char,
+	 * 		mofw::memory::caps_allocator<mofw::memory::cap_allocator_map::SpiRam,
+	 * 									 mofw::memory::cap_allocator_size::Size8Bit> >;
+	 * @endcode
+	 *
+	 * The functions that grow the string return false (or leave the string unchanged)
+	 * when the allocator fails, they do not throw.
+	 *
+	 * @tparam TChar The char type
+	 * @tparam TAllocator The allocator for strings longer then TSSO
+	 * @tparam TSSO The max number of chars in the inline buffer
+	 */
+	template <typename TChar, class TAllocator = memory::default_allocator, size_t TSSO = 15>
+	class basic_string {
+		static_assert(TSSO * sizeof(TChar) >= sizeof(size_t), "TSSO is to small for the capacity field");
+	public:
+		using value_type = TChar;
+		using pointer = TChar*;
+		using const_pointer = const TChar*;
+		using reference = TChar&;
+		using const_reference = const TChar&;
+		using iterator = TChar*;
+		using const_iterator = const TChar*;
+		using size_type = size_t;
+		using allocator_type = TAllocator;
+		using view_type = basic_string_view<TChar>;
+		using self_type = basic_string<TChar, TAllocator, TSSO>;
+
+		static constexpr size_type npos = view_type::npos;
+		static constexpr size_type sso_capacity = TSSO;
+
+		basic_string() noexcept
+			: m_pData(m_aLocal), m_szLength(0), m_alloCator() { m_aLocal[0] = TChar(0); }
+
+		basic_string(const TChar* str)
+			: basic_string() { assign(view_type(str)); }
+
+		basic_string(const TChar* str, size_type len)
+			: basic_string() { assign(view_type(str, len)); }
+
+		explicit basic_string(view_type str)
+			: basic_string() { assign(str); }
+
+		basic_string(size_type count, TChar ch)
+			: basic_string() { resize(count, ch); }
+
+		basic_string(const self_type& other)
+			: m_pData(m_aLocal), m_szLength(0), m_alloCator(other.m_alloCator) {
+			m_aLocal[0] = TChar(0);
+			assign(other.view());
+		}
+
+		basic_string(self_type&& other) noexcept
+			: m_pData(m_aLocal), m_szLength(0), m_alloCator(other.m_alloCator) {
+			m_aLocal[0] = TChar(0);
+			steal(other);
+		}
+
+		~basic_string() { release(); }
+
+		self_type& operator = (const self_type& other) {
+			if(this != &other) assign(other.view());
+			return *this;
+		}
+		self_type& operator = (self_type&& other) noexcept {
+			if(this != &other) {
+				release();
+				m_alloCator = other.m_alloCator;
+				steal(other);
+			}
+			return *this;
+		}
+		self_type& operator = (view_type str) 		{ assign(str); return *this; }
+		self_type& operator = (const TChar* str) 	{ assign(view_type(str)); return *this; }
+
+		/**
+		 * @brief Replace the content with str.
+		 * str can be a part of this string.
+		 * @return False when the allocator fails, the string is unchanged then
+		 */
+		bool assign(view_type str) {
+			if(!reserve(str.size())) return false;
+
+			::memmove(m_pData, str.data(), str.size() * sizeof(TChar));
+			set_length(str.size());
+			return true;
+		}
+
+		iterator begin() noexcept 				{ return m_pData; }
+		iterator end() noexcept 				{ return m_pData + m_szLength; }
+		const_iterator begin() const noexcept 	{ return m_pData; }
+		const_iterator end() const noexcept 	{ return m_pData + m_szLength; }
+
+		const TChar* c_str() const noexcept 	{ return m_pData; }
+		const TChar* data() const noexcept 		{ return m_pData; }
+		TChar* data() noexcept 					{ return m_pData; }
+
+		size_type size() const noexcept 		{ return m_szLength; }
+		size_type length() const noexcept 		{ return m_szLength; }
+		bool empty() const noexcept 			{ return m_szLength == 0; }
+
+		/**
+		 * @brief Get the number of chars, that can be stored without allocation
+		 */
+		size_type capacity() const noexcept 	{ return is_inline() ? TSSO : m_szCapacity; }
+
+		/**
+		 * @brief Is the string stored in the inline buffer?
+		 */
+		bool is_inline() const noexcept 		{ return m_pData == m_aLocal; }
+
+		reference operator [] (size_type pos) noexcept 				{ return m_pData[pos]; }
+		const_reference operator [] (size_type pos) const noexcept 	{ return m_pData[pos]; }
+		reference front() noexcept 				{ return m_pData[0]; }
+		reference back() noexcept 				{ return m_pData[m_szLength - 1]; }
+		const_reference front() const noexcept 	{ return m_pData[0]; }
+		const_reference back() const noexcept 	{ return m_pData[m_szLength - 1]; }
+
+		/**
+		 * @brief Get a view of the string
+		 */
+		view_type view() const noexcept 		{ return view_type(m_pData, m_szLength); }
+		operator view_type() const noexcept 	{ return view(); }
+
+		/**
+		 * @brief Make sure that the string can hold count chars without allocation.
+		 * Grows by at least the half of the current capacity.
+		 * @return False when the allocator fails
+		 */
+		bool reserve(size_type count) {
+			size_type _cap = capacity();
+			if(count <= _cap) return true;
+
+			size_type _grow = _cap + _cap / 2;
+			if(count < _grow) count = _grow;
+
+			TChar* _mem = static_cast<TChar*>(m_alloCator.allocate((count + 1) * sizeof(TChar), alignof(TChar)));
+			if(_mem == nullptr) return false;
+
+			::memcpy(_mem, m_pData, (m_szLength + 1) * sizeof(TChar));
+			release();
+
+			m_pData = _mem;
+			m_szCapacity = count;
+			return true;
+		}
+
+		/**
+		 * @brief Resize the string, new chars are set to ch
+		 * @return False when the allocator fails
+		 */
+		bool resize(size_type count, TChar ch = TChar(0)) {
+			if(!reserve(count)) return false;
+
+			for(size_type i = m_szLength; i < count; i++) m_pData[i] = ch;
+			set_length(count);
+			return true;
+		}
+
+		/**
+		 * @brief Remove all chars, the memory is not freed
+		 */
+		void clear() noexcept { set_length(0); }
+
+		/**
+		 * @brief Append str to the string.
+		 * str can be a part of this string.
+		 * @return False when the allocator fails, the string is unchanged then
+		 */
+		bool append(view_type str) {
+			if(str.empty()) return true;
+
+			size_type _len = m_szLength;
+			size_type _offset = size_type(str.data() - m_pData);
+			bool _self = str.data() >= m_pData && str.data() < m_pData + _len;
+
+			if(!reserve(_len + str.size())) return false;
+			const TChar* _src = _self ? m_pData + _offset : str.data();
+
+			::memmove(m_pData + _len, _src, str.size() * sizeof(TChar));
+			set_length(_len + str.size());
+			return true;
+		}
+		bool append(const TChar* str, size_type len) 	{ return append(view_type(str, len)); }
+		bool append(size_type count, TChar ch) 			{ return resize(m_szLength + count, ch); }
+
+		bool push_back(TChar ch) {
+			if(!reserve(m_szLength + 1)) return false;
+
+			m_pData[m_szLength] = ch;
+			set_length(m_szLength + 1);
+			return true;
+		}
+		void pop_back() noexcept { if(m_szLength > 0) set_length(m_szLength - 1); }
+
+		self_type& operator += (view_type str) 		{ append(str); return *this; }
+		self_type& operator += (const self_type& str) { append(str.view()); return *this; }
+		self_type& operator += (const TChar* str) 	{ append(view_type(str)); return *this; }
+		self_type& operator += (TChar ch) 			{ push_back(ch); return *this; }
+
+		/**
+		 * @brief Insert str at pos
+		 * @return False when pos is behind the end or the allocator fails
+		 */
+		bool insert(size_type pos, view_type str) {
+			if(pos > m_szLength) return false;
+			if(pos == m_szLength) return append(str);
+
+			self_type _tmp(m_alloCator);
+			if(!_tmp.reserve(m_szLength + str.size())) return false;
+
+			_tmp.append(view().substr(0, pos));
+			_tmp.append(str);
+			_tmp.append(view().substr(pos));
+
+			swap(_tmp);
+			return true;
+		}
+
+		/**
+		 * @brief Remove count chars, starting at pos
+		 */
+		self_type& erase(size_type pos = 0, size_type count = npos) noexcept {
+			if(pos >= m_szLength) return *this;
+			if(count > m_szLength - pos) count = m_szLength - pos;
+
+			::memmove(m_pData + pos, m_pData + pos + count, (m_szLength - pos - count) * sizeof(TChar));
+			set_length(m_szLength - count);
+			return *this;
+		}
+
+		self_type substr(size_type pos = 0, size_type count = npos) const {
+			return self_type(view().substr(pos, count));
+		}
+
+		int compare(view_type str) const noexcept 			{ return view().compare(str); }
+		bool starts_with(view_type str) const noexcept 		{ return view().starts_with(str); }
+		bool ends_with(view_type str) const noexcept 		{ return view().ends_with(str); }
+		bool contains(view_type str) const noexcept 		{ return view().find(str) != npos; }
+		bool contains(TChar ch) const noexcept 				{ return view().find(ch) != npos; }
+
+		size_type find(view_type str, size_type pos = 0) const noexcept 	{ return view().find(str, pos); }
+		size_type find(TChar ch, size_type pos = 0) const noexcept 		{ return view().find(ch, pos); }
+		size_type rfind(view_type str, size_type pos = npos) const noexcept { return view().rfind(str, pos); }
+		size_type rfind(TChar ch, size_type pos = npos) const noexcept 	{ return view().rfind(ch, pos); }
+
+		result_type hash() const noexcept { return view().hash(); }
+
+		/**
+		 * @brief Swap the content of two strings, inline strings are copied
+		 */
+		void swap(self_type& other) noexcept {
+			if(this == &other) return;
+
+			self_type _tmp(mofw::move(other));
+			other = mofw::move(*this);
+			*this = mofw::move(_tmp);
+		}
+
+		allocator_type get_allocator() const { return m_alloCator; }
+	private:
+		explicit basic_string(const allocator_type& alloc) noexcept
+			: m_pData(m_aLocal), m_szLength(0), m_alloCator(alloc) { m_aLocal[0] = TChar(0); }
+
+		void set_length(size_type len) noexcept {
+			m_szLength = len;
+			m_pData[len] = TChar(0);
+		}
+
+		/**
+		 * @brief Free the heap buffer, the string is in a undefined state after this
+		 */
+		void release() noexcept {
+			if(!is_inline())
+				m_alloCator.deallocate(m_pData, (m_szCapacity + 1) * sizeof(TChar), alignof(TChar));
+			m_pData = m_aLocal;
+		}
+
+		/**
+		 * @brief Take the content of other, other is the empty string after this
+		 */
+		void steal(self_type& other) noexcept {
+			if(other.is_inline()) {
+				::memcpy(m_aLocal, other.m_aLocal, (other.m_szLength + 1) * sizeof(TChar));
+				m_pData = m_aLocal;
+			} else {
+				m_pData = other.m_pData;
+				m_szCapacity = other.m_szCapacity;
+			}
+			m_szLength = other.m_szLength;
+
+			other.m_pData = other.m_aLocal;
+			other.set_length(0);
+		}
+	private:
+		TChar* m_pData;
+		size_type m_szLength;
+		union {
+			size_type m_szCapacity;
+			TChar m_aLocal[TSSO + 1];
+		};
+		allocator_type m_alloCator;
+	};
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	constexpr typename basic_string<TChar, TAllocator, TSSO>::size_type basic_string<TChar, TAllocator, TSSO>::npos;
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	constexpr typename basic_string<TChar, TAllocator, TSSO>::size_type basic_string<TChar, TAllocator, TSSO>::sso_capacity;
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator == (const basic_string<TChar, TAllocator, TSSO>& a, const basic_string<TChar, TAllocator, TSSO>& b) noexcept {
+		return a.view().equals(b.view());
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator == (const basic_string<TChar, TAllocator, TSSO>& a, basic_string_view<TChar> b) noexcept {
+		return a.view().equals(b);
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator == (const basic_string<TChar, TAllocator, TSSO>& a, const TChar* b) noexcept {
+		return a.view().equals(basic_string_view<TChar>(b));
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator != (const basic_string<TChar, TAllocator, TSSO>& a, const basic_string<TChar, TAllocator, TSSO>& b) noexcept {
+		return !a.view().equals(b.view());
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator != (const basic_string<TChar, TAllocator, TSSO>& a, basic_string_view<TChar> b) noexcept {
+		return !a.view().equals(b);
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator != (const basic_string<TChar, TAllocator, TSSO>& a, const TChar* b) noexcept {
+		return !a.view().equals(basic_string_view<TChar>(b));
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline bool operator < (const basic_string<TChar, TAllocator, TSSO>& a, const basic_string<TChar, TAllocator, TSSO>& b) noexcept {
+		return a.view().compare(b.view()) < 0;
+	}
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline basic_string<TChar, TAllocator, TSSO> operator + (const basic_string<TChar, TAllocator, TSSO>& a, basic_string_view<TChar> b) {
+		basic_string<TChar, TAllocator, TSSO> _ret;
+
+		if(_ret.reserve(a.size() + b.size())) {
+			_ret.append(a.view());
+			_ret.append(b);
+		}
+		return _ret;
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline basic_string<TChar, TAllocator, TSSO> operator + (const basic_string<TChar, TAllocator, TSSO>& a, const basic_string<TChar, TAllocator, TSSO>& b) {
+		return a + b.view();
+	}
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline basic_string<TChar, TAllocator, TSSO> operator + (const basic_string<TChar, TAllocator, TSSO>& a, const TChar* b) {
+		return a + basic_string_view<TChar>(b);
+	}
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	inline void swap(basic_string<TChar, TAllocator, TSSO>& a, basic_string<TChar, TAllocator, TSSO>& b) noexcept {
+		a.swap(b);
+	}
+
+	template <typename TChar, class TAllocator, size_t TSSO>
+	struct hash<basic_string<TChar, TAllocator, TSSO> > {
+		result_type operator()(const basic_string<TChar, TAllocator, TSSO>& str) const noexcept {
+			return str.hash();
+		}
+	};
+
+	using string = basic_string<char>;
+}
+
+#endif // __MINILIB_BASIC_STRING_H__
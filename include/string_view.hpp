@@ -0,0 +1,314 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef __MINILIB_BASIC_STRING_VIEW_H__
+#define __MINILIB_BASIC_STRING_VIEW_H__
+
+#include "config.hpp"
+
+#include <string.h>
+#include <stdint.h>
+
+#include "def.hpp"
+#include "hash.hpp"
+
+namespace mofw {
+	namespace internal {
+		/**
+		 * @brief The char operations for the string classes.
+		 * The char version use the (on esp32 optimized) mem* functions of the libc.
+		 */
+		template <typename TChar>
+		struct char_ops {
+			static size_t length(const TChar* str) noexcept {
+				size_t _len = 0;
+				while(str[_len] != TChar(0)) _len++;
+				return _len;
+			}
+			static int compare(const TChar* a, const TChar* b, size_t n) noexcept {
+				for(size_t i = 0; i < n; i++) {
+					if(a[i] != b[i]) return (a[i] < b[i]) ? -1 : 1;
+				}
+				return 0;
+			}
+			static const TChar* find(const TChar* str, size_t n, TChar ch) noexcept {
+				for(size_t i = 0; i < n; i++) {
+					if(str[i] == ch) return str + i;
+				}
+				return nullptr;
+			}
+		};
+
+		template <>
+		struct char_ops<char> {
+			static size_t length(const char* str) noexcept {
+				return ::strlen(str);
+			}
+			static int compare(const char* a, const char* b, size_t n) noexcept {
+				return (n == 0) ? 0 : ::memcmp(a, b, n);
+			}
+			static const char* find(const char* str, size_t n, char ch) noexcept {
+				return (n == 0) ? nullptr : static_cast<const char*>(::memchr(str, ch, n));
+			}
+		};
+	}
+
+	/**
+	 * @brief A non-owning view of a char array.
+	 *
+	 * The view is a pointer and a length, it allocates nothing and is cheap to copy, so
+	 * pass it by value. The viewed chars are not null terminated (use basic_string when a
+	 * c string is needed) and must live longer as the view.
+	 *
+	 * @tparam TChar The char type
+	 */
+	template <typename TChar>
+	class basic_string_view {
+	public:
+		using value_type = TChar;
+		using pointer = const TChar*;
+		using const_pointer = const TChar*;
+		using reference = const TChar&;
+		using const_reference = const TChar&;
+		using iterator = const TChar*;
+		using const_iterator = const TChar*;
+		using size_type = size_t;
+		using self_type = basic_string_view<TChar>;
+		using ops_type = internal::char_ops<TChar>;
+
+		static constexpr size_type npos = size_type(-1);
+
+		constexpr basic_string_view() noexcept
+			: m_pData(nullptr), m_szLength(0) { }
+
+		constexpr basic_string_view(const TChar* str, size_type len) noexcept
+			: m_pData(str), m_szLength(len) { }
+
+		/**
+		 * @brief Create a view of a null terminated string, NULL is the empty view
+		 */
+		basic_string_view(const TChar* str) noexcept
+			: m_pData(str), m_szLength(str ? ops_type::length(str) : 0) { }
+
+		constexpr basic_string_view(const self_type& other) noexcept = default;
+		self_type& operator = (const self_type& other) noexcept = default;
+
+		const_iterator begin() const noexcept 	{ return m_pData; }
+		const_iterator end() const noexcept 	{ return m_pData + m_szLength; }
+
+		constexpr const_pointer data() const noexcept 	{ return m_pData; }
+		constexpr size_type size() const noexcept 		{ return m_szLength; }
+		constexpr size_type length() const noexcept 	{ return m_szLength; }
+		constexpr bool empty() const noexcept 			{ return m_szLength == 0; }
+
+		const_reference operator [] (size_type pos) const noexcept { return m_pData[pos]; }
+		const_reference front() const noexcept 	{ return m_pData[0]; }
+		const_reference back() const noexcept 	{ return m_pData[m_szLength - 1]; }
+
+		/**
+		 * @brief Shrink the view, remove n chars from the front
+		 */
+		void remove_prefix(size_type n) noexcept {
+			if(n > m_szLength) n = m_szLength;
+			m_pData += n; m_szLength -= n;
+		}
+		/**
+		 * @brief Shrink the view, remove n chars from the back
+		 */
+		void remove_suffix(size_type n) noexcept {
+			m_szLength -= (n > m_szLength) ? m_szLength : n;
+		}
+
+		/**
+		 * @brief Get a view of a part of this view
+		 * @param pos The first char, the empty view when pos is behind the end
+		 * @param count The max number of chars
+		 */
+		self_type substr(size_type pos, size_type count = npos) const noexcept {
+			if(pos > m_szLength) return self_type();
+			size_type _rest = m_szLength - pos;
+
+			return self_type(m_pData + pos, (count < _rest) ? count : _rest);
+		}
+
+		/**
+		 * @brief Compare two views
+		 * @return <0 when this view less then other, 0 when equal and >0 when greater
+		 */
+		int compare(self_type other) const noexcept {
+			size_type _len = (m_szLength < other.m_szLength) ? m_szLength : other.m_szLength;
+			int _ret = ops_type::compare(m_pData, other.m_pData, _len);
+
+			if(_ret != 0) return _ret;
+			return (m_szLength == other.m_szLength) ? 0 : ((m_szLength < other.m_szLength) ? -1 : 1);
+		}
+
+		/**
+		 * @brief Is the view equal to other? Compares the length first.
+		 */
+		bool equals(self_type other) const noexcept {
+			return m_szLength == other.m_szLength &&
+				ops_type::compare(m_pData, other.m_pData, m_szLength) == 0;
+		}
+
+		bool starts_with(self_type other) const noexcept {
+			return m_szLength >= other.m_szLength &&
+				ops_type::compare(m_pData, other.m_pData, other.m_szLength) == 0;
+		}
+		bool ends_with(self_type other) const noexcept {
+			return m_szLength >= other.m_szLength &&
+				ops_type::compare(end() - other.m_szLength, other.m_pData, other.m_szLength) == 0;
+		}
+
+		/**
+		 * @brief Find the first char ch, starting at pos
+		 * @return The position or npos when not found
+		 */
+		size_type find(TChar ch, size_type pos = 0) const noexcept {
+			if(pos >= m_szLength) return npos;
+
+			const TChar* _ptr = ops_type::find(m_pData + pos, m_szLength - pos, ch);
+			return (_ptr == nullptr) ? npos : size_type(_ptr - m_pData);
+		}
+
+		/**
+		 * @brief Find the first sub string, starting at pos.
+		 *
+		 * Search the first char with memchr and compare only on the hits.
+		 * @return The position or npos when not found
+		 */
+		size_type find(self_type str, size_type pos = 0) const noexcept {
+			if(str.m_szLength == 0) return (pos <= m_szLength) ? pos : npos;
+			if(pos >= m_szLength || str.m_szLength > m_szLength - pos) return npos;
+
+			const TChar* _cur = m_pData + pos;
+			const TChar* _last = end() - str.m_szLength;
+
+			while(_cur <= _last) {
+				_cur = ops_type::find(_cur, size_type(_last - _cur) + 1, str.m_pData[0]);
+				if(_cur == nullptr) break;
+
+				if(ops_type::compare(_cur + 1, str.m_pData + 1, str.m_szLength - 1) == 0)
+					return size_type(_cur - m_pData);
+				_cur++;
+			}
+			return npos;
+		}
+
+		/**
+		 * @brief Find the last char ch, at or before pos
+		 * @return The position or npos when not found
+		 */
+		size_type rfind(TChar ch, size_type pos = npos) const noexcept {
+			if(m_szLength == 0) return npos;
+			if(pos >= m_szLength) pos = m_szLength - 1;
+
+			for(size_type i = pos + 1; i > 0; i--) {
+				if(m_pData[i - 1] == ch) return i - 1;
+			}
+			return npos;
+		}
+
+		/**
+		 * @brief Find the last sub string, starting at or before pos
+		 * @return The position or npos when not found
+		 */
+		size_type rfind(self_type str, size_type pos = npos) const noexcept {
+			if(str.m_szLength > m_szLength) return npos;
+
+			size_type _start = m_szLength - str.m_szLength;
+			if(pos < _start) _start = pos;
+
+			for(size_type i = _start + 1; i > 0; i--) {
+				if(ops_type::compare(m_pData + i - 1, str.m_pData, str.m_szLength) == 0)
+					return i - 1;
+			}
+			return npos;
+		}
+
+		bool contains(self_type str) const noexcept { return find(str) != npos; }
+		bool contains(TChar ch) const noexcept { return find(ch) != npos; }
+
+		/**
+		 * @brief Get the FNV-1a hash of the view, the same as hash_string on the chars
+		 */
+		result_type hash() const noexcept {
+			uint32_t _h = 2166136261U;
+
+			for(size_type i = 0; i < m_szLength; i++) {
+				_h ^= static_cast<uint32_t>(m_pData[i]) & 0xffU;
+				_h *= 16777619U;
+			}
+			return static_cast<result_type>(_h);
+		}
+	private:
+		const TChar* m_pData;
+		size_type m_szLength;
+	};
+
+	template <typename TChar>
+	constexpr typename basic_string_view<TChar>::size_type basic_string_view<TChar>::npos;
+
+	template <typename TChar>
+	inline bool operator == (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return a.equals(b);
+	}
+	template <typename TChar>
+	inline bool operator == (basic_string_view<TChar> a, const TChar* b) noexcept {
+		return a.equals(basic_string_view<TChar>(b));
+	}
+	template <typename TChar>
+	inline bool operator == (const TChar* a, basic_string_view<TChar> b) noexcept {
+		return b.equals(basic_string_view<TChar>(a));
+	}
+	template <typename TChar>
+	inline bool operator != (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return !a.equals(b);
+	}
+	template <typename TChar>
+	inline bool operator != (basic_string_view<TChar> a, const TChar* b) noexcept {
+		return !a.equals(basic_string_view<TChar>(b));
+	}
+	template <typename TChar>
+	inline bool operator < (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return a.compare(b) < 0;
+	}
+	template <typename TChar>
+	inline bool operator > (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return a.compare(b) > 0;
+	}
+	template <typename TChar>
+	inline bool operator <= (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return a.compare(b) <= 0;
+	}
+	template <typename TChar>
+	inline bool operator >= (basic_string_view<TChar> a, basic_string_view<TChar> b) noexcept {
+		return a.compare(b) >= 0;
+	}
+
+	template <typename TChar>
+	struct hash<basic_string_view<TChar> > {
+		result_type operator()(basic_string_view<TChar> str) const noexcept {
+			return str.hash();
+		}
+	};
+
+	using string_view = basic_string_view<char>;
+}
+
+#endif // __MINILIB_BASIC_STRING_VIEW_H__
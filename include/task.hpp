@@ -31,7 +31,7 @@
 #include "config.hpp"
 
 
-#include <string>
+#include "string.hpp"
 
 #include "autolock.hpp"
 #include "error.hpp"
@@ -41,6 +41,7 @@
 #include "eventgroup.hpp"
 
 #include "convar.hpp"
+#include "task_profile.hpp"
 
 namespace mofw {
 
@@ -101,6 +102,10 @@ namespace mofw {
 		 *  good thing.
 		 */
 		friend class basic_condition_variable;
+    /**
+     *  The task list reads the name and the hash of the name without a copy
+     */
+    friend class basic_task_list;
   public:
     /**
      * @brief Task priority
@@ -152,7 +157,7 @@ namespace mofw {
      * @param uiPriority FreeRTOS priority of this Task.
      * @param usStackDepth Number of "words" allocated for the Task stack. default MN_THREAD_CONFIG_MINIMAL_STACK_SIZE
      */
-    explicit basic_task(std::string strName, basic_task::priority uiPriority = basic_task::priority::Normal,
+    explicit basic_task(string_view strName, basic_task::priority uiPriority = basic_task::priority::Normal,
         unsigned short  usStackDepth = MN_THREAD_CONFIG_MINIMAL_STACK_SIZE) noexcept;
 
 
@@ -204,9 +209,9 @@ namespace mofw {
     /**
      * @brief Get the debug name of this task
      *
-     * @return The name of this task
+     * @return A view of the name of this task, valid as long as the task lives
      */
-    std::string          get_name();
+    string_view          get_name();
     /**
      * @brief Get the priority of this task
      *
@@ -493,6 +498,20 @@ namespace mofw {
     bool have_message();
     void get_message(task_message *msg, TickType_t timeOut = portMAX_DELAY);
 
+  #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+    /**
+     * @brief Get a snapshot of the profile counters of this task.
+     *
+     * The snapshot takes no lock and does not stop the task. When an other task can
+     * delete this task, read the profile with basic_task_list::get_profile, that needs
+     * the task in the basic_task_list (MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST or add_task).
+     *
+     * @param[out] profile The snapshot
+     * @return False when the task is not started
+     */
+    bool get_profile(task_profile& profile);
+  #endif
+
   protected:
     /**
      * @brief Adapter function that allows you to write a class
@@ -506,9 +525,9 @@ namespace mofw {
     mutable LockType_t m_runningMutex, m_contextMutext, m_continuemutex;
   protected:
     /**
-     * @brief The name of this task.
+     * @brief The name of this task, short names are stored inline.
      */
-    std::string m_strName;
+    mofw::string m_strName;
     /**
      * @brief A saved / cached copy of what the task's priority is.
      */
@@ -538,6 +557,18 @@ namespace mofw {
      * @note Can be obtained from get_handle().
      */
     native_handle_type m_pHandle;
+    /**
+     * @brief The slot of this task in the basic_task_list, -1 when the task is not listed.
+     * @note Guarded by the writer critical section of the list
+     */
+    int16_t m_iListSlot;
+  #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+    /**
+     * @brief The number of basic_task_list::get_profile calls, that read this task.
+     * @note Guarded by the writer critical section of the list, remove_task waits until 0
+     */
+    uint16_t m_uiListPins;
+  #endif
 
     event_group_t m_eventGroup;
 
@@ -556,6 +587,13 @@ namespace mofw {
     mutex_t m_ltMessageQueueLock;
     queue::queue_t m_qeMessageQueue;
     convar_t m_cvMessage;
+
+  #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+    /**
+     * @brief The profile counters, written from the trace hooks
+     */
+    task_profile_counters m_profCounters;
+  #endif
   };
   /**
    * @brief using the basic_task as task_t type
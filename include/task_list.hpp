@@ -21,22 +21,55 @@
 
 #include "config.hpp"
 
-class basic_task;
-
-#include <list>
-#include <map>
+#include <freertos/FreeRTOS.h>
+#include <freertos/portmacro.h>
 
 #include "copyable.hpp"
+#include "string_view.hpp"
+#include "atomic.hpp"
+#include "task_profile.hpp"
 
 namespace mofw {
+    class basic_task;
 
     /**
-     * A simple task list
+     * A task registry
+     *
+     * The tasks are hold in a flat array with MN_THREAD_CONFIG_TASK_LIST_MAX entrys. A entry
+     * never moves, the task holds the index of his entry. Two open addressing indices map
+     * the task id and the hash of the name to the entry, so a lookup by id or by name and
+     * the remove of a task are O(1) and never touch the task object or copy a string.
+     *
+     * Add and remove are guarded by a short critical section and allocate nothing. The
+     * readers take no lock: they use a sequence counter (seqlock) and retry when a
+     * writer was active while they read. A started task gets a new id, so a restarted
+     * task replaces his old entry.
      *
      * @note If MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST activated then automatic added new basic_tasks
      * to this list. On default is MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST deactivated
      */
     class basic_task_list : MN_ONSIGLETN_CLASS {
+        static_assert((MN_THREAD_CONFIG_TASK_LIST_MAX & (MN_THREAD_CONFIG_TASK_LIST_MAX - 1)) == 0,
+            "MN_THREAD_CONFIG_TASK_LIST_MAX must be a power of two");
+        static_assert(MN_THREAD_CONFIG_TASK_LIST_MAX <= 0x4000,
+            "MN_THREAD_CONFIG_TASK_LIST_MAX must fit in the int16_t index");
+    public:
+        /**
+         * A entry of the registry, the snapshot type
+         */
+        struct entry {
+            basic_task* task;                               /*!< The task, NULL for a free entry */
+            int32_t id;                                     /*!< The id of the task */
+            int32_t core;                                   /*!< The core of the task */
+            uint32_t name_hash;                             /*!< The hash of the full name */
+            char name[MN_THREAD_CONFIG_TASK_LIST_NAMELEN];  /*!< The (maybe truncated) name */
+        };
+        static constexpr size_t capacity = MN_THREAD_CONFIG_TASK_LIST_MAX;
+        /**
+         * The size of a index, twice the capacity so a probe is short and ends on a free index
+         */
+        static constexpr size_t index_size = capacity * 2;
+    private:
         /**
          * Construtor
          * @note This is a signleton class, only one object
@@ -54,13 +87,15 @@ namespace mofw {
         static mutex_t  m_staticInstanceMux;
     public:
         /**
-         * Add a task to list
+         * Add a task to list, a listed task (restarted with a new id) replaces his old entry
          *
          * @param task The task to add
+         * @return False when the task is NULL, a other task has the id or the list is full
          */
-        void add_task(basic_task* task);
+        bool add_task(basic_task* task);
         /**
-         * Remove a task from the list
+         * Remove a task from the list. With MN_THREAD_CONFIG_TASK_PROFILING wait until
+         * no get_profile reads the task.
          *
          * @param task The task to remove
          */
@@ -79,24 +114,95 @@ namespace mofw {
          * @param name The name to search
          * @return The finded task, by name. NULL when not finded a task
          */
-        basic_task* get_task(std::string name);
-    private:
+        basic_task* get_task(const char* name) { return (name == NULL) ? NULL : get_task(string_view(name)); }
         /**
-         * Get a task from the list by id on a specific core
+         * Get a task from the list by name, without copy the name.
+         * Names longer then MN_THREAD_CONFIG_TASK_LIST_NAMELEN - 1 chars are compared truncated.
          *
-         * @param id The id to search
-         * @param core The core
-         * @return The finded task, by id. NULL when not finded a task
+         * @param name The name to search
+         * @return The finded task, by name. NULL when not finded a task
          */
-        basic_task* get_task(int core, int id);
+        basic_task* get_task(string_view name);
+
+        /**
+         * Get the number of tasks in the list
+         */
+        size_t get_num_tasks();
+
         /**
-         * Get a task from the list by name on a specific core
+         * Copy a consistent snapshot of the list
          *
-         * @param name The name to search
-         * @param core The core
-         * @return The finded task, by name. NULL when not finded a task
+         * @param pEntrys The array for the snapshot
+         * @param maxEntrys The size of the array
+         * @param core Only the tasks on this core, -1 for all tasks
+         * @return The number of copied entrys
+         */
+        size_t snapshot(entry* pEntrys, size_t maxEntrys, int core = -1);
+
+    #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+        /**
+         * Read the profile of the task with the given id.
+         *
+         * The task is pinned in the writer critical section and the profile is read
+         * after it, remove_task (and so the destructor of the task) waits until the
+         * task is unpinned. Only listed tasks can be read: activate
+         * MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST or add the tasks with add_task.
+         *
+         * @param id The id of the task
+         * @param[out] profile The profile
+         * @return False when the task is not in the list or not started
+         */
+        bool get_profile(int32_t id, task_profile& profile);
+    #endif
+    private:
+        /**
+         * Get the index of the task by id, only call in a read or write section
+         * @return The index or -1 when not finded
          */
-        basic_task* get_task(int core, std::string name);
+        int find_index(int32_t id) const;
+        /**
+         * Get the index of the task by name, only call in a read or write section
+         * @return The index or -1 when not finded
+         */
+        int find_index(string_view name, uint32_t hash) const;
+
+        /**
+         * Remove the entry from the indices and free it, only call in the write section
+         */
+        void erase_entry(int slot);
+        /**
+         * Add the entry to a index, only call in the write section
+         * @param pIndex m_aIdIndex or m_aNameIndex
+         */
+        void index_insert(int16_t* pIndex, uint32_t key, int slot);
+        /**
+         * Remove the entry from a index (backward shift), only call in the write section
+         * @param pIndex m_aIdIndex or m_aNameIndex
+         */
+        void index_erase(int16_t* pIndex, uint32_t key, int slot);
+        /**
+         * Get the key of the entry for the given index
+         */
+        uint32_t index_key(const int16_t* pIndex, int slot) const {
+            return (pIndex == m_aIdIndex) ? (uint32_t)m_aEntrys[slot].id : m_aEntrys[slot].name_hash;
+        }
+
+        /**
+         * Make the sequence odd, only call in the writer critical section
+         */
+        void begin_write();
+        /**
+         * Make the sequence even, only call in the writer critical section
+         */
+        void end_write();
+        /**
+         * Wait until no writer is active and get the sequence
+         */
+        uint32_t begin_read() const;
+        /**
+         * @return True when no writer was active since begin_read, else the read must retry
+         */
+        bool end_read(uint32_t seq) const;
     public:
         /**
          * Get the singleton instance
@@ -104,19 +210,35 @@ namespace mofw {
          */
         static basic_task_list& instance() {
             automutx_t lock(m_staticInstanceMux);
-            if(m_pInstance != NULL)
+            if(m_pInstance == NULL)
                 m_pInstance = new basic_task_list();
             return *m_pInstance;
         }
     private:
         /**
-         * Lock Object for this
+         * Guard for the writers, use portENTER_CRITICAL_SAFE so that a writer is never
+         * preempted while the sequence is odd
+         */
+        portMUX_TYPE m_muxWriter;
+        /**
+         * The sequence counter, odd while a writer change the entrys
+         */
+        mofw::atomic_uint32_t m_uiSequence;
+        size_t m_szCount;
+        /**
+         * The flat entry table, a entry never moves while the task is listed
+         */
+        entry m_aEntrys[MN_THREAD_CONFIG_TASK_LIST_MAX];
+        /**
+         * The free entrys, a stack of m_szFree indices
          */
-        LockType_t               m_pLock;
+        int16_t m_aFree[MN_THREAD_CONFIG_TASK_LIST_MAX];
+        size_t m_szFree;
         /**
-         * The map for this Task list holder
+         * The index by task id and the index by name hash, the entry or -1 for a free index
          */
-        std::map<int, std::list<basic_task*> > m_mapTaskOnCore;
+        int16_t m_aIdIndex[index_size];
+        int16_t m_aNameIndex[index_size];
     };
 
     using task_list_t = basic_task_list;
@@ -0,0 +1,106 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_TASK_PROFILE_
+#define MINLIB_ESP32_TASK_PROFILE_
+
+#include "config.hpp"
+
+#include <stdint.h>
+
+/**
+ * The task profiling needs three FreeRTOS trace hooks, add this to the FreeRTOSConfig.h
+ * (or a header that is included from there) to get the switch counters, the cpu time
+ * and the wake latency:
+ *
+ * @code{c}
+ * void mn_profile_task_switched_in(void);
+ * void mn_profile_task_switched_out(void);
+ * void mn_profile_task_ready(void* pxTCB);
+ *
+ * #define traceTASK_SWITCHED_IN()                  mn_profile_task_switched_in()
+ * #define traceTASK_SWITCHED_OUT()                 mn_profile_task_switched_out()
+ * #define traceMOVED_TASK_TO_READY_STATE(pxTCB)    mn_profile_task_ready(pxTCB)
+ * @endcode
+ *
+ * Without the hooks only the stack high water mark and the message queue depth are
+ * recorded.
+ */
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+
+MN_EXTERNC_BEGINN
+    /**
+     * Call from traceTASK_SWITCHED_IN, the current task is the switched in task
+     */
+    void mn_profile_task_switched_in(void);
+    /**
+     * Call from traceTASK_SWITCHED_OUT, the current task is the switched out task
+     */
+    void mn_profile_task_switched_out(void);
+    /**
+     * Call from traceMOVED_TASK_TO_READY_STATE
+     * @param pxTCB The task that is woken up
+     */
+    void mn_profile_task_ready(void* pxTCB);
+MN_EXTERNC_END
+
+namespace mofw {
+    /**
+     * The raw profile counters of a basic_task.
+     *
+     * The counters are written only from the trace hooks: switched in and switched out
+     * run on the core of the task and update the counters in a sequence section (odd
+     * while writing), the reader retries when the sequence was changed. The ready hook
+     * writes only the wake timestamp.
+     */
+    struct task_profile_counters {
+        volatile uint32_t seq;              /*!< The sequence, odd while a hook writes */
+        volatile uint64_t cpu_us;           /*!< The cpu time in micro seconds */
+        volatile uint32_t switch_in_us;     /*!< The timestamp of the last switch in */
+        volatile uint32_t switches;         /*!< The number of switch ins */
+        volatile uint32_t ready_us;         /*!< The wake timestamp, 0 when not woken */
+        volatile uint32_t latency_sum_us;   /*!< The sum of all wake to run latencys */
+        volatile uint32_t latency_max_us;   /*!< The max wake to run latency */
+        volatile uint32_t wakeups;          /*!< The number of measured wake ups */
+        volatile uint32_t queue_max;        /*!< The max message queue depth */
+
+        task_profile_counters()
+            : seq(0), cpu_us(0), switch_in_us(0), switches(0), ready_us(0),
+              latency_sum_us(0), latency_max_us(0), wakeups(0), queue_max(0) { }
+    };
+
+    /**
+     * A snapshot of the profile of a basic_task
+     */
+    struct task_profile {
+        int32_t  id;                        /*!< The id of the task */
+        int32_t  core;                      /*!< The core of the task */
+        uint64_t cpu_us;                    /*!< The cpu time in micro seconds */
+        uint32_t switches;                  /*!< The number of context switches to the task */
+        uint32_t stack_free;                /*!< The stack high water mark, the min free stack in bytes (ESP-IDF stacks are counted in bytes) */
+        uint32_t latency_avg_us;            /*!< The average wake to run latency in micro seconds */
+        uint32_t latency_max_us;            /*!< The max wake to run latency in micro seconds */
+        uint32_t queue_depth;               /*!< The current number of messages in the message queue */
+        uint32_t queue_max;                 /*!< The max number of messages in the message queue */
+        char     name[MN_THREAD_CONFIG_TASK_LIST_NAMELEN]; /*!< The (maybe truncated) name of the task */
+    };
+}
+
+#endif // MN_THREAD_CONFIG_TASK_PROFILING
+
+#endif
@@ -0,0 +1,145 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_ESP32_TASK_PROFILER_
+#define MINLIB_ESP32_TASK_PROFILER_
+
+#include "config.hpp"
+
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <stddef.h>
+
+#include "task.hpp"
+#include "task_list.hpp"
+#include "task_profile.hpp"
+
+namespace mofw {
+
+    /**
+     * A task that reports the profiles of all tasks in the basic_task_list every period.
+     *
+     * The report is written with the output function, in CSV one line per task (and a
+     * header line at the start) or binary one frame per period: a frame_header and then
+     * frame_header::count task_profile records (little endian, the memory layout of
+     * task_profile).
+     *
+     * @note Only the tasks in the basic_task_list are reported, so activate
+     * MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST or add the tasks self.
+     *
+     * @code{c}
+     * task_profiler_t profiler(pdMS_TO_TICKS(5000));
+     * profiler.start();
+     * // time_ms,id,name,core,cpu_us,switches,stack_free,latency_avg_us,latency_max_us,queue_depth,queue_max
+     * // 5000,0,main,1,12044,310,1220,14,92,0,2
+     * @endcode
+     *
+     * @ingroup task
+     */
+    class basic_task_profiler : public basic_task {
+    public:
+        /**
+         * The format of the report
+         */
+        enum class format {
+            CSV,        /*!< One text line per task */
+            Binary      /*!< One frame per period */
+        };
+
+        /**
+         * The header of a binary frame
+         */
+        struct frame_header {
+            uint32_t magic;             /*!< Always frame_magic */
+            uint8_t  version;           /*!< The version of the frame, 1 */
+            uint8_t  count;             /*!< The number of task_profile records */
+            uint16_t record_size;       /*!< sizeof(task_profile) */
+            uint32_t time_ms;           /*!< The time of the snapshot, in milliseconds since boot */
+        };
+        static_assert(sizeof(frame_header) == 12, "the frame header has no padding");
+
+        static constexpr uint32_t frame_magic = 0x50544E4D; // "MNTP"
+
+        /**
+         * The output function
+         * @param data The data to write
+         * @param size The size of the data in bytes
+         * @param user The user pointer, given by the constructor
+         */
+        using output_fn = void (*)(const void* data, size_t size, void* user);
+
+        /**
+         * Constructor for the profiler task.
+         *
+         * @param uiPeriod The report period in ticks.
+         * @param eFormat The format of the report
+         * @param fnOutput The output function, NULL writes to stdout
+         * @param pUser The user pointer for the output function
+         */
+        explicit basic_task_profiler(unsigned int uiPeriod = pdMS_TO_TICKS(1000),
+            format eFormat = format::CSV, output_fn fnOutput = NULL, void* pUser = NULL);
+
+        /**
+         * Take a snapshot of all tasks in the basic_task_list
+         *
+         * @param[out] pProfiles The array for the snapshot
+         * @param maxProfiles The size of the array
+         * @param core Only the tasks on this core, -1 for all tasks
+         * @return The number of profiles in the snapshot
+         */
+        size_t snapshot(task_profile* pProfiles, size_t maxProfiles, int core = -1);
+
+        /**
+         * Take a snapshot and write it with the output function
+         */
+        void report();
+
+        format get_format() const           { return m_eFormat; }
+        unsigned int get_period() const     { return m_uiPeriod; }
+    protected:
+        virtual int on_task() override;
+    private:
+        /** must call with the locked m_mtxSnapshot */
+        size_t take_snapshot(task_profile* pProfiles, size_t maxProfiles, int core);
+
+        void write(const void* data, size_t size);
+        void write_csv_header();
+        void write_csv(size_t count, uint32_t time_ms);
+        void write_binary(size_t count, uint32_t time_ms);
+    private:
+        unsigned int m_uiPeriod;
+        format m_eFormat;
+        output_fn m_fnOutput;
+        void* m_pUser;
+        /**
+         * Guard the buffers, snapshot and report can call from other tasks
+         */
+        mutex_t m_mtxSnapshot;
+        basic_task_list::entry m_aEntrys[basic_task_list::capacity];
+        task_profile m_aProfiles[basic_task_list::capacity];
+    };
+
+    using task_profiler_t = basic_task_profiler;
+}
+
+#endif // MN_THREAD_CONFIG_TASK_PROFILING
+
+#endif
@@ -23,13 +23,13 @@
 
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
+#include <freertos/portmacro.h>
 
 #if ( configUSE_TICK_HOOK == 1 )
 
 #include "error.hpp"
-#include "queue/queue.hpp"
-#include "task.hpp"
 #include "tickhook_entry.hpp"
+#include "container/timing_wheel.hpp"
 
 
 /**
@@ -43,14 +43,22 @@ namespace mofw {
     /**
      * Wrapper class for Tick hooks, functions you want to run within the tick ISR.
      *
-     * You can register multiple hooks (base_tickhook_entry) with this class.
+     * You can register multiple hooks (base_tickhook_entry) with this class. The
+     * hooks are hold in a hierarchical timing wheel, so add and remove are O(1), a
+     * tick touches only the hooks that are due in this tick and the number of hooks
+     * is not limited.
      *
      * \ingroup hook
      */
     class base_tickhook {
+        friend void ::vApplicationTickHook(void);
+    public:
+        /** The timing wheel type, config with MN_THREAD_CONFIG_TICKHOOK_WHEEL_BITS and _LEVELS */
+        using wheel_type = container::basic_timing_wheel<base_tickhook_entry,
+            MN_THREAD_CONFIG_TICKHOOK_WHEEL_BITS, MN_THREAD_CONFIG_TICKHOOK_WHEEL_LEVELS>;
     private:
         /**
-         * @brief Creates a tick hook %list with default constructed elements.
+         * @brief Creates a empty tick hook wheel.
          *
          * @note This is a signleton class, only one object
          * plaese use base_tickhook::instance()
@@ -73,60 +81,57 @@ namespace mofw {
         static base_tickhook& instance();
 
         /**
-         * Add a new tickhook to the list
+         * Add a new tickhook to the wheel, the first call is get_ticks() ticks after this
          * @param entry The new tick hook entry
+         * @param timeout Not used, the wheel is guarded by a critical section
          *
          * @return
          *  - ERR_TICKHOOK_OK The entry was added
          *  - ERR_TICKHOOK_ADD The entry already added
          *  - ERR_TICKHOOK_ENTRY_NULL The entry is null
-         *  - ERR_MNTHREAD_TIMEOUT TimeOut
          */
         int enqueue(base_tickhook_entry* entry,
             unsigned int timeout = (unsigned int) 0xffffffffUL);
         /**
-         *  Remove an item from the front of the queue.
+         *  Remove a tickhook from the wheel. A hook, that runs now, is not added again.
          *
-         *  @param item Where the item you are removing will be returned to.
-         *  @param timeout How long to wait to remove an item to the queue.
-         *  @return  - 'ERR_QUEUE_OK' the item was removed
-         *           - 'ERR_QUEUE_REMOVE' on an error
-         *           - 'ERR_QUEUE_NOTCREATED' when the queue not created
-         *           - 'ERR_MNTHREAD_TIMEOUT' TimeOut
+         *  @param entry The entry to remove
+         *  @param timeout Not used, the wheel is guarded by a critical section
+         *  @return  - ERR_TICKHOOK_OK The entry was removed
+         *           - ERR_TICKHOOK_REMOVE The entry is not in the wheel
+         *           - ERR_TICKHOOK_ENTRY_NULL The entry is null
          */
         int dequeue(base_tickhook_entry* entry,
             unsigned int timeout = (unsigned int) 0xffffffffUL);
         /**
-         * Clear the list
+         * Remove all entrys
          */
         void clear();
 
         /**
-         * Reset
+         * Remove all entrys and set the tick counter to 0
          */
         void reset();
         /**
-         * How many entrys are in the list
-         * @return The number of entrys in the list
+         * How many entrys are in the wheel
+         * @return The number of entrys in the wheel
          */
         unsigned int count();
         /**
          * The tick hook logic - call from vApplicationTickHook.
-         * All not oneshotted entrys enqueue after run to m_listToAdd.
-         *
+         * Call all due and ready entrys, the not oneshotted and the not ready entrys are
+         * add again with get_ticks() ticks. Each critical section takes one entry and the
+         * hooks are called outside of it, so the interrupts are not disabled for the hooks.
          */
         void onApplicationTickHook();
     private:
-
-        /**
-         * Swapped all entrys in m_listToAdd to m_listHooks back
-         *
-         */
-        void swap();
-    private:
-        mutex_t m_mutexAdd;
-        queue::queue_t m_listHooks, m_listToAdd;
+        /** Guard the wheel against the tick ISR, use portENTER_CRITICAL_SAFE */
+        portMUX_TYPE m_muxWheel;
+        wheel_type m_wheelHooks;
         unsigned int m_iCurrent;
+        /** The entry, that is called now, and was it removed while it runs */
+        base_tickhook_entry* volatile m_pCurrent;
+        volatile bool m_bCurrentRemoved;
     };
 
     using tickhook_t = base_tickhook;
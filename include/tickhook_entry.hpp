@@ -25,6 +25,7 @@
 
 #include "error.hpp"
 #include "task.hpp"
+#include "container/timing_wheel.hpp"
 
 
 namespace mofw {
@@ -37,9 +38,12 @@ namespace mofw {
      * be derived from the base_tickhook_entry class. Then implement the virtual on_hook
      * function.
      *
+     * The entry is a intrusive element of the tick hook wheel, the tick hook allocate
+     * nothing for a entry.
+     *
      * \ingroup hook
      */
-    class base_tickhook_entry {
+    class base_tickhook_entry : public container::timing_wheel_node {
         friend class base_tickhook;
         public:
             /**
@@ -0,0 +1,237 @@
+/**
+ * @file
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * @author Copyright (c) 2021 Amber-Sophia Schroeck
+ * @par License
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+ *
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+ */
+#ifndef MINLIB_TIMER_SERVICE_
+#define MINLIB_TIMER_SERVICE_
+
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/portmacro.h>
+
+#include "error.hpp"
+#include "task.hpp"
+#include "container/timing_wheel.hpp"
+
+namespace mofw {
+    class basic_timer_service;
+
+    /**
+     * A light weight timer, run from a basic_timer_service.
+     *
+     * Unlike basic_timer this timer has no FreeRTOS timer and sends no command to the
+     * timer daemon: the timer is a intrusive element of the timing wheel of the service,
+     * so active, inactive, reset and set_period are O(1) and never block.
+     *
+     * @note on_timer is called from the service task. The destructor waits until a
+     * running on_timer of this timer is finished, but a derived class should call
+     * inactive() in its own destructor. Do not delete the timer in its own on_timer.
+     *
+     * @ingroup base
+     */
+    class basic_service_timer : public container::timing_wheel_node {
+        friend class basic_timer_service;
+    public:
+        /**
+         * Construct a timer.
+         *
+         * @param service The timer service that run this timer
+         * @param uiPeriod When does the timer expire and run your on_timer() method, in ticks.
+         * @param bIsOneShot true if this is a one shot timer.
+         *  false if the timer expires every uiPeriod.
+         */
+        basic_service_timer(basic_timer_service& service,
+            unsigned int uiPeriod, bool bIsOneShot = true);
+
+        virtual ~basic_service_timer();
+
+        basic_service_timer(const basic_service_timer&) = delete;
+        basic_service_timer& operator = (const basic_service_timer&) = delete;
+
+        /**
+         * Start the timer, a running timer is started again with the full period.
+         *
+         * @returns ERR_TIMER_OK
+         */
+        int active();
+
+        /**
+         * Stop the timer
+         *
+         * @returns ERR_TIMER_OK
+         */
+        int inactive();
+
+        /**
+         * Reset the timer, start the timer again with the full period
+         *
+         * @returns ERR_TIMER_OK
+         */
+        int reset();
+
+        /**
+         *  Change a timer's period, a running timer is started again with the new period.
+         *
+         *  @param uiNewPeriod The new period in ticks.
+         *  @returns true
+         */
+        bool set_period(unsigned int uiNewPeriod);
+
+        /**
+         * Get the timer's period
+         *
+         * @return The timer's period
+         */
+        unsigned int get_period()   { return m_uiPeriod; }
+
+        /**
+         * Is the timer is one shotted?
+         *
+         * @return true The timer is one shotted and false when not
+         */
+        bool is_oneshot()           { return m_bIsOneShot; }
+
+        /**
+         * Queries a timer to see if it is active or dormant.
+         *
+         * @return false will be returned if the timer is dormant.
+         * And true will be returned if the timer is active.
+         */
+        bool is_running()           { return m_bActive; }
+
+        operator bool() { return is_running(); }
+    protected:
+        /**
+         * Implementation of your actual timer code.
+         * You must override this function.
+         */
+        virtual void on_timer() = 0;
+
+        /**
+         * You can override this functions, call befor on_timer
+         */
+        virtual void on_enter() { }
+        /**
+         * You can override this functions, call after on_timer
+         */
+        virtual void on_exit() { }
+    private:
+        basic_timer_service* m_pService;
+        /**
+         * The link in the list of expired timers of the current tick
+         */
+        basic_service_timer* m_pBatchNext;
+        basic_service_timer** m_ppBatchPrev;
+
+        unsigned int m_uiPeriod;
+        bool m_bIsOneShot;
+        volatile bool m_bActive;
+    };
+
+    /**
+     * A timer service task for many basic_service_timer.
+     *
+     * One task drives a hierarchical timing wheel: schedule and cancel are O(1) under a
+     * short critical section. The task moves the expired timers one by one out of the
+     * wheel, each in his own short critical section, and then calls them without holding
+     * the lock. The task sleeps until the next tick that can expire a timer, and without
+     * timeout when no timer is active.
+     *
+     * @code{c}
+     * class my_timeout : public basic_service_timer {
+     * public:
+     *     my_timeout(timer_service_t& service) : basic_service_timer(service, 500) { }
+     * protected:
+     *     void on_timer() override { // close the connection }
+     * };
+     *
+     * timer_service_t service;
+     * service.start();
+     *
+     * my_timeout timeout(service);
+     * timeout.active();
+     * @endcode
+     *
+     * @ingroup base
+     */
+    class basic_timer_service : public basic_task {
+        friend class basic_service_timer;
+    public:
+        using wheel_type = container::basic_timing_wheel<basic_service_timer,
+            MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_BITS, MN_THREAD_CONFIG_TIMER_SERVICE_WHEEL_LEVELS>;
+
+        /**
+         * Constructor for the timer service.
+         *
+         * @param strName Name of the Task. Only useful for debugging.
+         * @param uiPriority FreeRTOS priority of this Task.
+         * @param usStackDepth Number of "words" allocated for the Task stack.
+         */
+        explicit basic_timer_service(const char* strName = "timer_service",
+            basic_task::priority uiPriority = MN_THREAD_CONFIG_TIMER_SERVICE_PRIORITY,
+            unsigned short usStackDepth = MN_THREAD_CONFIG_TIMER_SERVICE_STACKSIZE);
+
+        /**
+         * Get the number of active timers in the wheel
+         */
+        unsigned int get_num_timers();
+        /**
+         * Get the number of on_timer calls since the start
+         */
+        uint32_t get_num_fired();
+    protected:
+        virtual int on_task() override;
+    private:
+        /**
+         * Schedule the timer in uiTicks ticks, a scheduled timer is moved
+         */
+        void schedule(basic_service_timer* timer, unsigned int uiTicks);
+        /**
+         * Remove the timer from the wheel and the current batch
+         * @param bWait Wait until a running on_timer of this timer is finished
+         */
+        void cancel(basic_service_timer* timer, bool bWait);
+        /**
+         * Call all timers in the current batch
+         */
+        void run_batch();
+
+        /** must call in the critical section */
+        void unlink_batch(basic_service_timer* timer);
+        /** advance the wheel to the current tick and move the expired timers to the batch,
+         *  take the critical section for each step */
+        void sync_time();
+    private:
+        /** Guard the wheel and the batch, use portENTER_CRITICAL_SAFE */
+        portMUX_TYPE m_muxWheel;
+        wheel_type m_wheelTimers;
+
+        TickType_t m_tLastTick;
+        /** The tick on that the task wakes up */
+        TickType_t m_tWakeup;
+        basic_service_timer* m_pBatch;
+        basic_service_timer* volatile m_pCurrent;
+        uint32_t m_uiFired;
+    };
+
+    using service_timer_t = basic_service_timer;
+    using timer_service_t = basic_timer_service;
+}
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+ * Copyright (c) 2021 Amber-Sophia Schroeck
+ *
+ * The Mini Thread Library is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, version 3, or (at your option) any later version.
+
+ * The Mini Thread Library is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with the Mini Thread  Library; if not, see
+ * <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef MINLIB_STL_PARALLEL_SORT_H_
+#define MINLIB_STL_PARALLEL_SORT_H_
+
+#include "../config.hpp"
+
+#include "sort.hpp"
+#include "../atomic.hpp"
+#include "../binary_semaphore.hpp"
+#include "../queue/workqueue.hpp"
+
+namespace mofw {
+    namespace internal {
+		/**
+		 * The completion block of parallel_sort. The block is allocated from TAllocator and
+		 * owned by the calling task and all queued parts, the last owner that release it
+		 * destroy it. So a worker can give the semaphore while the calling task has
+		 * already returned.
+		 */
+		template <class TAllocator>
+		class parallel_sort_state {
+		public:
+			using self_type = parallel_sort_state<TAllocator>;
+
+			/**
+			 * Create a completion block for the given number of queued parts.
+			 * @return The block or nullptr when the allocation failed.
+			 */
+			static self_type* create(int parts) {
+				void* _mem = TAllocator().allocate(sizeof(self_type), mofw::alignment_for(sizeof(self_type)));
+				return (_mem != nullptr) ? new (_mem) self_type(parts) : nullptr;
+			}
+
+			/**
+			 * A part is sorted, the last part give the semaphore. Release the reference of the part.
+			 */
+			void finish() {
+				if (m_iPending.fetch_sub(1, memory_order::AcqRel) == 1)
+					m_Done.unlock();
+				release();
+			}
+
+			/**
+			 * Wait until all parts are sorted and release the reference of the calling task.
+			 */
+			void wait() {
+				m_Done.lock(portMAX_DELAY);
+				release();
+			}
+		private:
+			explicit parallel_sort_state(int parts)
+				: m_iPending(parts), m_iRefs(parts + 1) {
+				m_Done.lock(portMAX_DELAY);
+			}
+
+			void release() {
+				if (m_iRefs.fetch_sub(1, memory_order::AcqRel) == 1) {
+					this->~parallel_sort_state();
+					TAllocator().deallocate(this, sizeof(self_type), mofw::alignment_for(sizeof(self_type)));
+				}
+			}
+		private:
+			atomic_int m_iPending;
+			atomic_int m_iRefs;
+			basic_binary_semaphore m_Done;
+		};
+
+		/**
+		 * The work queue item of parallel_sort, sort one part of the range. The items live in
+		 * the call frame of parallel_sort, after finish() the item is not touched again.
+		 */
+		MN_TEMPLATE_FULL_DECL_THREE(typename, TIter, class, TPredicate, class, TAllocator)
+		class parallel_sort_item : public queue::work_queue_item {
+		public:
+			using state_type = parallel_sort_state<TAllocator>;
+
+			parallel_sort_item(TIter begin, TIter end, const TPredicate& pred, state_type* state)
+				: queue::work_queue_item(false), m_begin(begin), m_end(end), m_pred(pred),
+				  m_pState(state) { }
+
+			bool on_work() override {
+				mofw::sort(m_begin, m_end, m_pred);
+				m_pState->finish();
+
+				return true;
+			}
+		private:
+			TIter m_begin;
+			TIter m_end;
+			TPredicate m_pred;
+			state_type* m_pState;
+		};
+	}
+
+	/**
+	 * @brief Sort the range with the worker tasks of a work queue.
+	 *
+	 * The range is split in up to TMAXPARTS parts, the parts are sorted with mofw::sort by
+	 * the work queue and the calling task sort the first part. Then the calling task
+	 * merge the sorted parts with a buffer from TAllocator (in place with rotations when
+	 * the allocation failed). Parts that the work queue not accept are sorted by the
+	 * calling task. The sort is not stable.
+	 *
+	 * The work queue items are in the call frame, only the small completion block is
+	 * allocated from TAllocator. When this allocation failed the range is sorted by the
+	 * calling task.
+	 *
+	 * The calling task wait for the queued parts. So the range is sorted by the calling
+	 * task when the work queue is not created, or when the calling task is a worker of
+	 * the work queue and there is no other worker that can run the parts.
+	 *
+	 * @param begin The begin of the range, a random access iterator.
+	 * @param end The end of the range.
+	 * @param pred Return true when the first argument is ordered before the second (less).
+	 * @param workqueue The created work queue for the parts, best a multi or stealing engine.
+	 * @param parts The wanted number of parts, ranges smaller as 2048 elements per part
+	 * use less parts.
+	 */
+	template <typename TIter, class TPredicate, size_t TMAXPARTS = 8,
+			  class TAllocator = memory::default_allocator>
+	void parallel_sort(TIter begin, TIter end, TPredicate pred,
+					   queue::basic_work_queue& workqueue,
+					   size_t parts = portNUM_PROCESSORS) {
+		using value_type = typename iterator_traits<TIter>::value_type;
+		using item_type = internal::parallel_sort_item<TIter, TPredicate, TAllocator>;
+		using state_type = internal::parallel_sort_state<TAllocator>;
+
+		long size = end - begin;
+		long max_parts = size / internal::sort_parallel_threshold;
+
+		if (parts > TMAXPARTS) parts = TMAXPARTS;
+		if (static_cast<long>(parts) > max_parts) parts = static_cast<size_t>(max_parts);
+
+		// no worker that can run the parts while we wait
+		if (!workqueue.running() || (workqueue.is_worker() && workqueue.get_num_worker() < 2))
+			parts = 1;
+
+		state_type* _state = (parts < 2) ? nullptr : state_type::create(static_cast<int>(parts - 1));
+
+		if (_state == nullptr) {
+			mofw::sort(begin, end, pred);
+			return;
+		}
+
+		TIter bounds[TMAXPARTS + 1];
+		alignas(item_type) unsigned char _items[TMAXPARTS][sizeof(item_type)];
+
+		for (size_t i = 0; i <= parts; i++)
+			bounds[i] = begin + static_cast<long>((size * i) / parts);
+
+		for (size_t i = 1; i < parts; i++) {
+			item_type* _item = new (_items[i - 1]) item_type(bounds[i], bounds[i + 1], pred, _state);
+
+			if (workqueue.queue(_item) != ERR_WORKQUEUE_OK) {
+				mofw::sort(bounds[i], bounds[i + 1], pred);
+				_state->finish();
+			}
+		}
+		mofw::sort(bounds[0], bounds[1], pred);
+
+		// wait for the last part, the block is freed by his last owner
+		_state->wait();
+
+		for (size_t i = 1; i < parts; i++)
+			reinterpret_cast<item_type*>(_items[i - 1])->~item_type();
+
+		TAllocator _allocator;
+		size_t _bytes = sizeof(value_type) * static_cast<size_t>(size);
+		value_type* _buffer = static_cast<value_type*>(
+			_allocator.allocate(_bytes, mofw::alignment_for(sizeof(value_type))) );
+
+		// merge neighbour parts until one is left
+		for (size_t width = 1; width < parts; width *= 2) {
+			for (size_t i = 0; i + width < parts; i += 2 * width) {
+				TIter first = bounds[i];
+				TIter middle = bounds[i + width];
+				TIter last = bounds[mofw::min(i + 2 * width, parts)];
+
+				if (!pred(*middle, *(middle - 1))) continue;
+
+				if (_buffer != nullptr)
+					internal::merge_buffered(first, middle, last, _buffer, pred);
+				else
+					internal::merge_inplace(first, middle, last, pred);
+			}
+		}
+
+		if (_buffer != nullptr)
+			_allocator.deallocate(_buffer, _bytes, mofw::alignment_for(sizeof(value_type)));
+	}
+
+	MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+	void parallel_sort(TIter begin, TIter end, queue::basic_work_queue& workqueue) {
+		parallel_sort(begin, end, mofw::less<typename iterator_traits<TIter>::value_type>(), workqueue);
+	}
+}
+
+#endif
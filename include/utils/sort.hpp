@@ -19,67 +19,426 @@
 #ifndef MINLIB_STL_SORT_H_
 #define MINLIB_STL_SORT_H_
 
+#include <new>
+
 #include "utils.hpp"
+#include "../functional.hpp"
+#include "../iterator.hpp"
+#include "../algorithm.hpp"
+#include "../allocator.hpp"
 
 
 namespace mofw {
     namespace internal {
+		/// Ranges smaller as this are sorted with insertion sort
+		constexpr long sort_insertion_threshold = 24;
+		/// Ranges bigger as this use the ninther as pivot
+		constexpr long sort_ninther_threshold = 128;
+		/// The maximal moved elements in a partial insertion sort
+		constexpr long sort_partial_insertion_limit = 8;
+		/// Ranges smaller as this are not split by parallel_sort
+		constexpr long sort_parallel_threshold = 2048;
+
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void insertion_sort(TIter begin, TIter end, TPredicate pred) {
+			using value_type = typename iterator_traits<TIter>::value_type;
+
+			if (begin == end) return;
+
+			for (TIter cur = begin + 1; cur != end; ++cur) {
+				TIter sift = cur;
+				TIter sift_1 = cur - 1;
+
+				if (pred(*sift, *sift_1)) {
+					value_type tmp = mofw::move(*sift);
+
+					do { *sift-- = mofw::move(*sift_1); }
+					while (sift != begin && pred(tmp, *--sift_1));
+
+					*sift = mofw::move(tmp);
+				}
+			}
+		}
+
+		/**
+		 * Insertion sort without the begin check, the element before begin must be
+		 * not greater as all elements in the range.
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void unguarded_insertion_sort(TIter begin, TIter end, TPredicate pred) {
+			using value_type = typename iterator_traits<TIter>::value_type;
+
+			if (begin == end) return;
+
+			for (TIter cur = begin + 1; cur != end; ++cur) {
+				TIter sift = cur;
+				TIter sift_1 = cur - 1;
+
+				if (pred(*sift, *sift_1)) {
+					value_type tmp = mofw::move(*sift);
+
+					do { *sift-- = mofw::move(*sift_1); }
+					while (pred(tmp, *--sift_1));
+
+					*sift = mofw::move(tmp);
+				}
+			}
+		}
+
+		/**
+		 * Insertion sort that give up after sort_partial_insertion_limit moves.
+		 * @return True when the range is sorted.
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		bool partial_insertion_sort(TIter begin, TIter end, TPredicate pred) {
+			using value_type = typename iterator_traits<TIter>::value_type;
+
+			if (begin == end) return true;
+
+			long limit = 0;
+
+			for (TIter cur = begin + 1; cur != end; ++cur) {
+				TIter sift = cur;
+				TIter sift_1 = cur - 1;
+
+				if (pred(*sift, *sift_1)) {
+					value_type tmp = mofw::move(*sift);
+
+					do { *sift-- = mofw::move(*sift_1); }
+					while (sift != begin && pred(tmp, *--sift_1));
+
+					*sift = mofw::move(tmp);
+					limit += cur - sift;
+				}
+				if (limit > sort_partial_insertion_limit) return false;
+			}
+			return true;
+		}
+
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		inline void sort2(TIter a, TIter b, TPredicate pred) {
+			if (pred(*b, *a)) mofw::iter_swap(a, b);
+		}
+
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		inline void sort3(TIter a, TIter b, TIter c, TPredicate pred) {
+			internal::sort2(a, b, pred);
+			internal::sort2(b, c, pred);
+			internal::sort2(a, b, pred);
+		}
+
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void sift_down(TIter begin, long k, long n, TPredicate pred) {
+			using value_type = typename iterator_traits<TIter>::value_type;
 
-        MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
-        void quick_sort(T* data, long low, long high, TPredicate pred) {
+			value_type temp = mofw::move(begin[k]);
+
+			while (2 * k + 1 < n) {
+				long child = 2 * k + 1;
+
+				if (child + 1 < n && pred(begin[child], begin[child + 1]))
+					++child;
+				if (!pred(temp, begin[child])) break;
+
+				begin[k] = mofw::move(begin[child]);
+				k = child;
+			}
+			begin[k] = mofw::move(temp);
+		}
+
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void heap_sort(TIter begin, TIter end, TPredicate pred) {
+			long n = end - begin;
+
+			for (long k = n / 2; k > 0; --k)
+				internal::sift_down(begin, k - 1, n, pred);
+
+			while (n > 1) {
+				--n;
+				mofw::iter_swap(begin, begin + n);
+				internal::sift_down(begin, 0, n, pred);
+			}
+		}
+
+		/**
+		 * Partition around the pivot *begin, the elements equal to the pivot go to the right.
+		 * pivot_pos get the new position of the pivot, already_partitioned is true when
+		 * no element was swapped.
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void partition_right(TIter begin, TIter end, TPredicate pred, TIter& pivot_pos, bool& already_partitioned) {
+			using value_type = typename iterator_traits<TIter>::value_type;
+
+			value_type pivot = mofw::move(*begin);
+			TIter first = begin;
+			TIter last = end;
+
+			// the median of three guard that the loops stop
+			while (pred(*++first, pivot));
+
+			if (first - 1 == begin) while (first < last && !pred(*--last, pivot));
+			else 					while (!pred(*--last, pivot));
+
+			already_partitioned = first >= last;
+
+			while (first < last) {
+				mofw::iter_swap(first, last);
+				while (pred(*++first, pivot));
+				while (!pred(*--last, pivot));
+			}
+
+			pivot_pos = first - 1;
+			*begin = mofw::move(*pivot_pos);
+			*pivot_pos = mofw::move(pivot);
+		}
+
+		/**
+		 * Partition around the pivot *begin, the elements equal to the pivot go to the left.
+		 * Used when the pivot is equal to the element before the range, then the
+		 * left part is all equal and need no more sorting.
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		TIter partition_left(TIter begin, TIter end, TPredicate pred) {
+			using value_type = typename iterator_traits<TIter>::value_type;
+
+			value_type pivot = mofw::move(*begin);
+			TIter first = begin;
+			TIter last = end;
+
+			while (pred(pivot, *--last));
+
+			if (last + 1 == end) 	while (first < last && !pred(pivot, *++first));
+			else 					while (!pred(pivot, *++first));
+
+			while (first < last) {
+				mofw::iter_swap(first, last);
+				while (pred(pivot, *--last));
+				while (!pred(pivot, *++first));
+			}
+
+			TIter pivot_pos = last;
+			*begin = mofw::move(*pivot_pos);
+			*pivot_pos = mofw::move(pivot);
+
+			return pivot_pos;
+		}
+
+		/**
+		 * The pattern defeating quicksort loop (Orson Peters). The smaller part is sorted
+		 * recursive and the bigger in the loop, so the stack depth is O(log n). After
+		 * bad_allowed unbalanced partitions the range is heap sorted, so the worst case
+		 * is O(n log n).
+		 *
+		 * @param leftmost Is the range the left most part, when not then the element before
+		 * begin is not greater as all elements in the range.
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void pdq_sort(TIter begin, TIter end, TPredicate pred, int bad_allowed, bool leftmost) {
 			while (true) {
-				long i = low;
-				long j = high;
-				const T pivot = data[(low + high) >> 1];
-
-				do {
-					while (pred(data[i], pivot)) ++i;
-					while (pred(pivot, data[j])) --j;
-
-					// Anything to swap?
-					if (j >= i) {
-						if (i != j) {
-					    	// Swap
-					    	T tmp(data[i]);
-					    	data[i] = data[j];
-					    	data[j] = tmp;
+				long size = end - begin;
+
+				if (size < sort_insertion_threshold) {
+					if (leftmost) internal::insertion_sort(begin, end, pred);
+					else internal::unguarded_insertion_sort(begin, end, pred);
+					return;
+				}
+
+				long s2 = size / 2;
+
+				if (size > sort_ninther_threshold) {
+					internal::sort3(begin, begin + s2, end - 1, pred);
+					internal::sort3(begin + 1, begin + (s2 - 1), end - 2, pred);
+					internal::sort3(begin + 2, begin + (s2 + 1), end - 3, pred);
+					internal::sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), pred);
+					mofw::iter_swap(begin, begin + s2);
+				} else {
+					internal::sort3(begin + s2, begin, end - 1, pred);
+				}
+
+				// many equal elements: the pivot is equal to the element before the range
+				if (!leftmost && !pred(*(begin - 1), *begin)) {
+					begin = internal::partition_left(begin, end, pred) + 1;
+					continue;
+				}
+
+				TIter pivot_pos;
+				bool already_partitioned;
+
+				internal::partition_right(begin, end, pred, pivot_pos, already_partitioned);
+
+				long l_size = pivot_pos - begin;
+				long r_size = end - (pivot_pos + 1);
+
+				if (l_size < size / 8 || r_size < size / 8) {
+					if (--bad_allowed == 0) {
+						internal::heap_sort(begin, end, pred);
+						return;
+					}
+					// break patterns that are bad for the pivot selection
+					if (l_size >= sort_insertion_threshold) {
+						mofw::iter_swap(begin, begin + l_size / 4);
+						mofw::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+
+						if (l_size > sort_ninther_threshold) {
+							mofw::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+							mofw::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+							mofw::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+							mofw::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
 						}
-					    ++i;
-					    --j;
 					}
-				} while (i <= j);
+					if (r_size >= sort_insertion_threshold) {
+						mofw::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+						mofw::iter_swap(end - 1, end - r_size / 4);
+
+						if (r_size > sort_ninther_threshold) {
+							mofw::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+							mofw::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+							mofw::iter_swap(end - 2, end - (1 + r_size / 4));
+							mofw::iter_swap(end - 3, end - (2 + r_size / 4));
+						}
+					}
+				} else if (already_partitioned &&
+						   internal::partial_insertion_sort(begin, pivot_pos, pred) &&
+						   internal::partial_insertion_sort(pivot_pos + 1, end, pred)) {
+					// the range was (nearly) sorted
+					return;
+				}
 
-                if (low < j) quick_sort(data, low, j, pred);
-                if (i < high) low = i;
-                else break;
+				if (l_size < r_size) {
+					internal::pdq_sort(begin, pivot_pos, pred, bad_allowed, leftmost);
+					begin = pivot_pos + 1;
+					leftmost = false;
+				} else {
+					internal::pdq_sort(pivot_pos + 1, end, pred, bad_allowed, false);
+					end = pivot_pos;
+				}
 			}
 		}
 
-		MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
-        void down_heap(T* data, size_t k, size_t n, TPredicate pred) {
-			const T temp = data[k - 1];
+		MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+		void reverse(TIter first, TIter last) {
+			while (first < --last) {
+				mofw::iter_swap(first, last);
+				++first;
+			}
+		}
 
-			while (k <= n / 2) {
-				size_t child = 2 * k;
-				if (child < n && pred(data[child - 1], data[child]))
-					++child;
-				if (pred(temp, data[child - 1])) {
-					data[k - 1] = data[child - 1];
-					k = child;
-				} else break;
+		MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+		TIter rotate(TIter first, TIter middle, TIter last) {
+			internal::reverse(first, middle);
+			internal::reverse(middle, last);
+			internal::reverse(first, last);
+			return first + (last - middle);
+		}
+
+		/**
+		 * Merge two sorted ranges without a buffer, with rotations (O(n log n)).
+		 */
+		MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+		void merge_inplace(TIter first, TIter middle, TIter last, TPredicate pred) {
+			long len1 = middle - first;
+			long len2 = last - middle;
+
+			if (len1 == 0 || len2 == 0) return;
+
+			if (len1 + len2 == 2) {
+				if (pred(*middle, *first)) mofw::iter_swap(first, middle);
+				return;
 			}
-			data[k - 1] = temp;
+
+			TIter cut1, cut2;
+
+			if (len1 > len2) {
+				cut1 = first + len1 / 2;
+				cut2 = middle;
+				for (long n = len2; n > 0; ) { // lower bound of *cut1 in the right range
+					long half = n / 2;
+					if (pred(*(cut2 + half), *cut1)) { cut2 += half + 1; n -= half + 1; }
+					else n = half;
+				}
+			} else {
+				cut2 = middle + len2 / 2;
+				cut1 = first;
+				for (long n = len1; n > 0; ) { // upper bound of *cut2 in the left range
+					long half = n / 2;
+					if (!pred(*cut2, *(cut1 + half))) { cut1 += half + 1; n -= half + 1; }
+					else n = half;
+				}
+			}
+			TIter new_middle = internal::rotate(cut1, middle, cut2);
+
+			internal::merge_inplace(first, cut1, new_middle, pred);
+			internal::merge_inplace(new_middle, cut2, last, pred);
+		}
+
+		/**
+		 * Merge two sorted neighbour ranges, the left range is moved to the buffer.
+		 * The buffer must hold (middle - first) elements.
+		 */
+		MN_TEMPLATE_FULL_DECL_THREE(typename, TIter, typename, T, class, TPredicate)
+		void merge_buffered(TIter first, TIter middle, TIter last, T* buffer, TPredicate pred) {
+			long len1 = middle - first;
+
+			for (long i = 0; i < len1; i++)
+				new (&buffer[i]) T(mofw::move(first[i]));
+
+			T* left = buffer;
+			T* left_end = buffer + len1;
+			TIter out = first;
+
+			// take from the left on equal, so the merge is stable
+			while (left != left_end && middle != last) {
+				if (pred(*middle, *left)) *out++ = mofw::move(*middle++);
+				else *out++ = mofw::move(*left++);
+			}
+			while (left != left_end) *out++ = mofw::move(*left++);
+
+			for (long i = 0; i < len1; i++)
+				buffer[i].~T();
+		}
+
+		/**
+		 * Top down merge sort, the buffer must hold (last - first + 1) / 2 elements.
+		 */
+		MN_TEMPLATE_FULL_DECL_THREE(typename, TIter, typename, T, class, TPredicate)
+		void merge_sort(TIter first, TIter last, T* buffer, TPredicate pred) {
+			long size = last - first;
+
+			if (size < sort_insertion_threshold) {
+				internal::insertion_sort(first, last, pred);
+				return;
+			}
+			TIter middle = first + (size + 1) / 2;
+
+			internal::merge_sort(first, middle, buffer, pred);
+			internal::merge_sort(middle, last, buffer, pred);
+
+			// allready in order
+			if (!pred(*middle, *(middle - 1))) return;
+
+			if (buffer == nullptr) {
+				internal::merge_inplace(first, middle, last, pred);
+				return;
+			}
+
+			internal::merge_buffered(first, middle, last, buffer, pred);
+		}
+
+		inline int sort_depth_limit(long n) {
+			int depth = 0;
+			while (n > 1) { n >>= 1; depth++; }
+			return depth;
 		}
 
 		MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
 		void shell_sort(T* data, size_t n, TPredicate pred) {
-			size_t temp, j;
+			size_t j;
 
 			for (size_t gap = n/2; gap > 0; gap /= 2) {
 				for (size_t i = gap; i < n; i += 1) {
-					temp = data[i];
+					T temp = data[i];
 
-					for (j = i; j >= gap && pred(arr[j - gap], temp); j -= gap) {
+					for (j = i; j >= gap && pred(data[j - gap], temp); j -= gap) {
 						data[j] = data[j - gap];
 					}
 					data[j] = temp;
@@ -90,22 +449,11 @@ namespace mofw {
 
 	MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
     void insertion_sort(T* begin, T* end, TPredicate pred) {
-		const size_t num = end - begin;
-
-		for (size_t i = 0; i < num; ++i) {
-			const T t = begin[i];
-			size_t j = i;
-
-			while (j > 0 && pred(t, begin[j - 1])) {
-				begin[j] = begin[j - 1];
-				--j;
-			}
-			begin[j] = t;
-		}
+		internal::insertion_sort(begin, end, pred);
 	}
 	MN_TEMPLATE_FULL_DECL_ONE(typename, T)
     void insertion_sort(T* begin, T* end) {
-		insertion_sort(begin, end, less<T>());
+		mofw::insertion_sort(begin, end, less<T>());
 	}
 
 	MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
@@ -116,41 +464,17 @@ namespace mofw {
 
 	MN_TEMPLATE_FULL_DECL_ONE(typename, T)
     void shell_sort(T* begin, T* end) {
-		shell_sort(begin, end, mofw::greater<T>());
+		mofw::shell_sort(begin, end, mofw::greater<T>());
 	}
 
-
-	MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
-    void quick_sort(T* begin, T* end, TPredicate pred) {
-		if (end - begin > 1)
-			internal::quick_sort(begin, 0, (size_t)(end - begin - 1), pred);
+	MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+    void heap_sort(TIter begin, TIter end, TPredicate pred) {
+		internal::heap_sort(begin, end, pred);
 	}
 
-	MN_TEMPLATE_FULL_DECL_ONE(typename, T)
-    void quick_sort(T* begin, T* end) {
-		quick_sort(begin, end, less<T>());
-	}
-
-	MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
-    void heap_sort(T* begin, T* end, TPredicate pred) {
-
-		size_t n = end - begin;
-		for (size_t k = n / 2; k != 0; --k)
-			internal::down_heap(begin, k, n, pred);
-
-		while (n >= 1) {
-			const T temp = begin[0];
-			begin[0] = begin[n - 1];
-			begin[n - 1] = temp;
-
-			--n;
-			internal::down_heap(begin, 1, n, pred);
-		}
-	}
-
-    MN_TEMPLATE_FULL_DECL_ONE(typename, T)
-    void heap_sort(T* begin, T* end) {
-		heap_sort(begin, end, mofw::less<T>());
+    MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+    void heap_sort(TIter begin, TIter end) {
+		mofw::heap_sort(begin, end, mofw::less<typename iterator_traits<TIter>::value_type>());
 	}
 
     MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, typename, TPredicate)
@@ -172,17 +496,74 @@ namespace mofw {
 		return is_sorted;
 	}
 
-	MN_TEMPLATE_FULL_DECL_TWO(typename, T, class, TPredicate)
-    void sort(T* begin, T* end, TPredicate pred) {
-		shell_sort(begin, end, pred);
+	/**
+	 * @brief Sort the range with pattern defeating quicksort (introsort).
+	 *
+	 * O(n log n) in the worst case, O(n) for sorted, reversed and nearly sorted ranges and for
+	 * ranges with many equal elements. The stack depth is O(log n). The sort is not stable.
+	 *
+	 * @param begin The begin of the range, a random access iterator.
+	 * @param end The end of the range.
+	 * @param pred Return true when the first argument is ordered before the second (less).
+	 */
+	MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+    void sort(TIter begin, TIter end, TPredicate pred) {
+		if (end - begin > 1)
+			internal::pdq_sort(begin, end, pred, internal::sort_depth_limit(end - begin), true);
 	}
 
-	MN_TEMPLATE_FULL_DECL_ONE(typename, T)
-    void sort(T* begin, T* end) {
-		shell_sort(begin, end, mofw::greater<T>());
+	MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+    void sort(TIter begin, TIter end) {
+		mofw::sort(begin, end, mofw::less<typename iterator_traits<TIter>::value_type>());
+	}
+
+	/**
+	 * @brief Sort the range, @see mofw::sort
+	 */
+	MN_TEMPLATE_FULL_DECL_TWO(typename, TIter, class, TPredicate)
+    void quick_sort(TIter begin, TIter end, TPredicate pred) {
+		mofw::sort(begin, end, pred);
 	}
 
+	MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+    void quick_sort(TIter begin, TIter end) {
+		mofw::sort(begin, end);
+	}
+
+	/**
+	 * @brief Stable sort the range with merge sort.
+	 *
+	 * Equal elements keep their order. A buffer for the half range is taken from
+	 * TAllocator, O(n log n). When the allocation failed the merges are in place with
+	 * rotations, O(n log² n).
+	 *
+	 * @param begin The begin of the range, a random access iterator.
+	 * @param end The end of the range.
+	 * @param pred Return true when the first argument is ordered before the second (less).
+	 */
+	template <typename TIter, class TPredicate, class TAllocator = memory::default_allocator>
+    void stable_sort(TIter begin, TIter end, TPredicate pred) {
+		using value_type = typename iterator_traits<TIter>::value_type;
+
+		long size = end - begin;
+		if (size < 2) return;
+
+		TAllocator _allocator;
+		size_t _bytes = sizeof(value_type) * ((size + 1) / 2);
+
+		value_type* _buffer = static_cast<value_type*>(
+			_allocator.allocate(_bytes, mofw::alignment_for(sizeof(value_type))) );
+
+		internal::merge_sort(begin, end, _buffer, pred);
+
+		if (_buffer != nullptr)
+			_allocator.deallocate(_buffer, _bytes, mofw::alignment_for(sizeof(value_type)));
+	}
 
+	MN_TEMPLATE_FULL_DECL_ONE(typename, TIter)
+    void stable_sort(TIter begin, TIter end) {
+		mofw::stable_sort(begin, end, mofw::less<typename iterator_traits<TIter>::value_type>());
+	}
 }
 
 #endif
@@ -0,0 +1,137 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <esp_attr.h>
+#include <time.h>
+
+#include "adaptive_mutex.hpp"
+#include "atomic/backoff.hpp"
+
+namespace mofw {
+  //-----------------------------------
+  //  construtor
+  //-----------------------------------
+  basic_adaptive_mutex::basic_adaptive_mutex()
+    : m_uiState(state_unlocked), m_uiSpinAverage(0), m_iCreateErrorCode(ERR_MUTEX_OK) {
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+      m_pSemaphore = xSemaphoreCreateBinaryStatic(&m_SemaphoreBasicBuffer);
+    #else
+      m_pSemaphore = xSemaphoreCreateBinary();
+    #endif
+
+    if (m_pSemaphore == NULL) {
+      MN_THROW_LOCK_EXP(ERR_MUTEX_CANTCREATEMUTEX);
+    }
+  }
+
+  //-----------------------------------
+  //  deconstrutor
+  //-----------------------------------
+  basic_adaptive_mutex::~basic_adaptive_mutex() {
+    if (m_pSemaphore != NULL)
+      vSemaphoreDelete(m_pSemaphore);
+  }
+
+  //-----------------------------------
+  //  time_lock
+  //-----------------------------------
+  int basic_adaptive_mutex::time_lock(const struct timespec *timeout) {
+    struct timespec currtime;
+    clock_gettime(CLOCK_REALTIME, &currtime);
+
+    TickType_t _time = ((timeout->tv_sec - currtime.tv_sec)*1000 +
+                      (timeout->tv_nsec - currtime.tv_nsec)/1000000)/portTICK_PERIOD_MS;
+
+    return lock(_time);
+  }
+
+  //-----------------------------------
+  //  get_spin_limit
+  //-----------------------------------
+  uint32_t basic_adaptive_mutex::get_spin_limit() const {
+    uint32_t _limit = m_uiSpinAverage * 2 + 10;
+
+    return (_limit < MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN_MAX) ?
+      _limit : MN_THREAD_CONFIG_ADAPTIVE_MUTEX_SPIN_MAX;
+  }
+
+  //-----------------------------------
+  //  lock_slow
+  //-----------------------------------
+  int basic_adaptive_mutex::lock_slow(unsigned int timeout) {
+    // A ISR can not spin for a task or block
+    if (xPortInIsrContext()) return ERR_MUTEX_LOCK;
+
+  #if portNUM_PROCESSORS > 1
+    basic_backoff<MN_THREAD_CONFIG_ADAPTIVE_MUTEX_BACKOFF_MAX> _backoff;
+    uint32_t _limit = get_spin_limit();
+    uint32_t _spun = 0;
+
+    while(_spun < _limit) {
+      uint32_t _expected = state_unlocked;
+
+      if(m_uiState.load(memory_order::Relaxed) == state_unlocked &&
+         m_uiState.compare_exchange_strong(_expected, state_locked, memory_order::Acquire)) {
+        break;
+      }
+      _spun += _backoff.pause();
+    }
+
+    // The average moves 1/8 to the last spin time
+    int32_t _average = (int32_t)m_uiSpinAverage;
+    m_uiSpinAverage = (uint32_t)(_average + ((int32_t)_spun - _average) / 8);
+
+    if(_spun < _limit) return ERR_MUTEX_OK;
+  #endif
+
+    // Mark the mutex as contended, so the unlock wakes us
+    TickType_t _start = xTaskGetTickCount();
+    TickType_t _wait = timeout;
+
+    while(m_uiState.exchange(state_contended, memory_order::Acquire) != state_unlocked) {
+      if(xSemaphoreTake((QueueHandle_t)m_pSemaphore, _wait) != pdTRUE)
+        return ERR_MUTEX_LOCK;
+
+      if(timeout != portMAX_DELAY) {
+        TickType_t _elapsed = xTaskGetTickCount() - _start;
+        if(_elapsed >= timeout) _wait = 0;
+        else _wait = timeout - _elapsed;
+      }
+    }
+    return ERR_MUTEX_OK;
+  }
+
+  //-----------------------------------
+  //  wake
+  //-----------------------------------
+  void basic_adaptive_mutex::wake() {
+    if (xPortInIsrContext()) {
+        BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+        xSemaphoreGiveFromISR( m_pSemaphore, &xHigherPriorityTaskWoken );
+        if(xHigherPriorityTaskWoken)
+          _frxt_setup_switch();
+    } else {
+        xSemaphoreGive(m_pSemaphore);
+    }
+  }
+}
@@ -45,18 +45,31 @@ namespace mofw {
   //  construtor
   //-----------------------------------
   basic_semaphore::basic_semaphore()
-    : m_pSpinlock(NULL) { m_isLocked = false; }
+    : m_pSpinlock(NULL) {
+    m_isLocked = false;
+  #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+    m_bProfiled = false;
+  #endif
+  }
 
 #if( configSUPPORT_STATIC_ALLOCATION == 0 )
   basic_semaphore::basic_semaphore(const basic_semaphore& other)
   	: m_pSpinlock(other.m_pSpinlock),
 	  m_iCreateErrorCode(other.m_iCreateErrorCode),
-	  m_isLocked(other.m_isLocked) { }
+	  m_isLocked(other.m_isLocked) {
+  #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+    m_bProfiled = other.m_bProfiled;
+  #endif
+  }
 
   basic_semaphore::basic_semaphore(basic_semaphore&& other)
   	: m_pSpinlock( mofw::move(other.m_pSpinlock)),
 	  m_iCreateErrorCode( mofw::move(other.m_iCreateErrorCode)),
-	  m_isLocked( mofw::move(other.m_isLocked)) { }
+	  m_isLocked( mofw::move(other.m_isLocked)) {
+  #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+    m_bProfiled = other.m_bProfiled;
+  #endif
+  }
 
 
 #endif
@@ -72,8 +85,21 @@ namespace mofw {
         success = xSemaphoreTakeFromISR( (QueueHandle_t)m_pSpinlock, &xHigherPriorityTaskWoken );
         if(xHigherPriorityTaskWoken)
           _frxt_setup_switch();
+
+      #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+        if(success == pdTRUE && m_bProfiled) m_lockProbe.acquired(this);
+      #endif
     } else {
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      if(m_bProfiled) {
+        success = m_lockProbe.take(this, timeout, [this](TickType_t ticks) {
+          return xSemaphoreTake((QueueHandle_t)m_pSpinlock, ticks); });
+      } else {
+        success = xSemaphoreTake((QueueHandle_t)m_pSpinlock, timeout);
+      }
+    #else
       success = xSemaphoreTake((QueueHandle_t)m_pSpinlock, timeout);
+    #endif
     }
     if(success != pdTRUE) {
       return ERR_SPINLOCK_LOCK;
@@ -99,6 +125,9 @@ namespace mofw {
     if(success != pdTRUE) {
       return ERR_SPINLOCK_UNLOCK;
     }
+  #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+    m_lockProbe.released();
+  #endif
 	m_isLocked = false;
     return ERR_SPINLOCK_OK;
   }
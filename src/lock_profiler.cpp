@@ -0,0 +1,386 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include "lock_profiler.hpp"
+
+namespace mofw {
+    //-----------------------------------
+    //  basic_lock_profiler::basic_lock_profiler
+    //-----------------------------------
+    basic_lock_profiler::basic_lock_profiler() {
+        m_muxSlots = portMUX_INITIALIZER_UNLOCKED;
+
+        for(size_t i = 0; i < capacity; i++) {
+            memset(&m_aSlots[i], 0, sizeof(slot));
+            m_aSlots[i].mux = portMUX_INITIALIZER_UNLOCKED;
+        }
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::instance
+    //-----------------------------------
+    basic_lock_profiler& basic_lock_profiler::instance() {
+        // no mutex_t guard here, the mutex_t self is profiled
+        static basic_lock_profiler _instance;
+        return _instance;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::get_bucket
+    //-----------------------------------
+    size_t basic_lock_profiler::get_bucket(uint32_t us) {
+        size_t _bucket = (us == 0) ? 0 : (size_t)(32 - __builtin_clz(us));
+        return (_bucket < buckets) ? _bucket : buckets - 1;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::attach
+    //-----------------------------------
+    int basic_lock_profiler::attach(const void* lock) {
+        int _index = -1;
+
+        portENTER_CRITICAL_SAFE(&m_muxSlots);
+        for(size_t i = 0; i < capacity; i++) {
+            if(m_aSlots[i].used) continue;
+
+            portENTER_CRITICAL_SAFE(&m_aSlots[i].mux);
+            m_aSlots[i].used = true;
+            m_aSlots[i].depth = 0;
+            memset(&m_aSlots[i].profile, 0, sizeof(lock_profile));
+            m_aSlots[i].profile.lock = lock;
+            portEXIT_CRITICAL_SAFE(&m_aSlots[i].mux);
+
+            _index = (int)i;
+            break;
+        }
+        portEXIT_CRITICAL_SAFE(&m_muxSlots);
+
+        return _index;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::detach
+    //-----------------------------------
+    void basic_lock_profiler::detach(int index) {
+        portENTER_CRITICAL_SAFE(&m_muxSlots);
+        portENTER_CRITICAL_SAFE(&m_aSlots[index].mux);
+        m_aSlots[index].used = false;
+        portEXIT_CRITICAL_SAFE(&m_aSlots[index].mux);
+        portEXIT_CRITICAL_SAFE(&m_muxSlots);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::set_name
+    //-----------------------------------
+    void basic_lock_profiler::set_name(int index, const char* name) {
+        lock_profile& _profile = m_aSlots[index].profile;
+
+        portENTER_CRITICAL_SAFE(&m_aSlots[index].mux);
+        strncpy(_profile.name, name, sizeof(_profile.name) - 1);
+        _profile.name[sizeof(_profile.name) - 1] = '\0';
+        portEXIT_CRITICAL_SAFE(&m_aSlots[index].mux);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::on_acquire
+    //-----------------------------------
+    void basic_lock_profiler::on_acquire(int index, uint32_t wait_us, bool contended) {
+        slot& _slot = m_aSlots[index];
+        lock_profile& _profile = _slot.profile;
+
+        TaskHandle_t _task = contended ? xTaskGetCurrentTaskHandle() : NULL;
+
+        portENTER_CRITICAL_SAFE(&_slot.mux);
+
+        if(_slot.depth++ == 0)
+            _slot.locked_at = basic_lock_probe::now();
+
+        _profile.acquisitions++;
+
+        if(contended) {
+            _profile.contended++;
+            _profile.wait_us += wait_us;
+            _profile.wait_histogram[get_bucket(wait_us)]++;
+
+            if(wait_us > _profile.wait_max_us)
+                _profile.wait_max_us = wait_us;
+
+            // the entry of the task, else a free entry or the entry with the shortest waits
+            lock_waiter* _waiter = NULL;
+            lock_waiter* _victim = &_profile.top_waiters[0];
+
+            for(size_t i = 0; i < top_waiters; i++) {
+                lock_waiter* _entry = &_profile.top_waiters[i];
+
+                if(_entry->task == _task) { _waiter = _entry; break; }
+
+                if(_victim->task != NULL && (_entry->task == NULL || _entry->wait_us < _victim->wait_us))
+                    _victim = _entry;
+            }
+
+            if(_waiter == NULL && (_victim->task == NULL || _victim->wait_us < wait_us)) {
+                _waiter = _victim;
+                _waiter->task = _task;
+                _waiter->count = 0;
+                _waiter->wait_us = 0;
+                strncpy(_waiter->name, pcTaskGetName(_task), sizeof(_waiter->name) - 1);
+                _waiter->name[sizeof(_waiter->name) - 1] = '\0';
+            }
+            if(_waiter != NULL) {
+                _waiter->count++;
+                _waiter->wait_us += wait_us;
+            }
+        } else {
+            _profile.wait_histogram[0]++;
+        }
+
+        portEXIT_CRITICAL_SAFE(&_slot.mux);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::on_timeout
+    //-----------------------------------
+    void basic_lock_profiler::on_timeout(int index, uint32_t wait_us) {
+        portENTER_CRITICAL_SAFE(&m_aSlots[index].mux);
+        m_aSlots[index].profile.timeouts++;
+        m_aSlots[index].profile.wait_us += wait_us;
+        portEXIT_CRITICAL_SAFE(&m_aSlots[index].mux);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::on_release
+    //-----------------------------------
+    void basic_lock_profiler::on_release(int index) {
+        slot& _slot = m_aSlots[index];
+        lock_profile& _profile = _slot.profile;
+
+        portENTER_CRITICAL_SAFE(&_slot.mux);
+
+        // a semaphore can given without a take
+        if(_slot.depth > 0 && --_slot.depth == 0) {
+            uint32_t _hold = basic_lock_probe::now() - _slot.locked_at;
+
+            _profile.hold_us += _hold;
+            _profile.hold_histogram[get_bucket(_hold)]++;
+
+            if(_hold > _profile.hold_max_us)
+                _profile.hold_max_us = _hold;
+        }
+        portEXIT_CRITICAL_SAFE(&_slot.mux);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::copy
+    //-----------------------------------
+    void basic_lock_profiler::copy(int index, lock_profile& profile) {
+        portENTER_CRITICAL_SAFE(&m_aSlots[index].mux);
+        memcpy(&profile, &m_aSlots[index].profile, sizeof(lock_profile));
+        portEXIT_CRITICAL_SAFE(&m_aSlots[index].mux);
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::sorted
+    //-----------------------------------
+    size_t basic_lock_profiler::sorted(int* pIndex, size_t maxIndex) {
+        uint64_t _keys[capacity];
+        int _index[capacity];
+        size_t _count = 0;
+
+        for(size_t i = 0; i < capacity; i++) {
+            if(!m_aSlots[i].used) continue;
+
+            portENTER_CRITICAL_SAFE(&m_aSlots[i].mux);
+            uint64_t _key = m_aSlots[i].profile.wait_us;
+            portEXIT_CRITICAL_SAFE(&m_aSlots[i].mux);
+
+            // insertion sort, the list is short
+            size_t _pos = _count++;
+            for(; _pos > 0 && _keys[_pos - 1] < _key; _pos--) {
+                _keys[_pos] = _keys[_pos - 1];
+                _index[_pos] = _index[_pos - 1];
+            }
+            _keys[_pos] = _key;
+            _index[_pos] = (int)i;
+        }
+        if(_count > maxIndex) _count = maxIndex;
+
+        memcpy(pIndex, _index, _count * sizeof(int));
+        return _count;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::get_num_locks
+    //-----------------------------------
+    size_t basic_lock_profiler::get_num_locks() {
+        size_t _count = 0;
+
+        portENTER_CRITICAL_SAFE(&m_muxSlots);
+        for(size_t i = 0; i < capacity; i++)
+            if(m_aSlots[i].used) _count++;
+        portEXIT_CRITICAL_SAFE(&m_muxSlots);
+
+        return _count;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::hottest
+    //-----------------------------------
+    size_t basic_lock_profiler::hottest(lock_profile* pProfiles, size_t maxProfiles) {
+        int _index[capacity];
+        size_t _count = sorted(_index, maxProfiles < capacity ? maxProfiles : capacity);
+
+        for(size_t i = 0; i < _count; i++)
+            copy(_index[i], pProfiles[i]);
+
+        return _count;
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::reset
+    //-----------------------------------
+    void basic_lock_profiler::reset() {
+        for(size_t i = 0; i < capacity; i++) {
+            lock_profile& _profile = m_aSlots[i].profile;
+
+            portENTER_CRITICAL_SAFE(&m_aSlots[i].mux);
+
+            const void* _lock = _profile.lock;
+            char _name[sizeof(_profile.name)];
+            memcpy(_name, _profile.name, sizeof(_name));
+
+            memset(&_profile, 0, sizeof(lock_profile));
+            _profile.lock = _lock;
+            memcpy(_profile.name, _name, sizeof(_name));
+
+            portEXIT_CRITICAL_SAFE(&m_aSlots[i].mux);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_lock_profiler::dump
+    //-----------------------------------
+    void basic_lock_profiler::dump(size_t maxLocks) {
+        int _index[capacity];
+        size_t _count = sorted(_index, maxLocks < capacity ? maxLocks : capacity);
+
+        lock_profile _profile;
+
+        printf("lock profile, %u hottest locks\n", (unsigned int)_count);
+
+        for(size_t i = 0; i < _count; i++) {
+            copy(_index[i], _profile);
+
+            printf("%p %-15s acq %" PRIu32 " cont %" PRIu32 " tmo %" PRIu32
+                   " wait %" PRIu64 "us (max %" PRIu32 ") hold %" PRIu64 "us (max %" PRIu32 ")\n",
+                _profile.lock, _profile.name, _profile.acquisitions, _profile.contended,
+                _profile.timeouts, _profile.wait_us, _profile.wait_max_us,
+                _profile.hold_us, _profile.hold_max_us);
+
+            printf("  wait log2(us):");
+            for(size_t b = 0; b < buckets; b++) printf(" %" PRIu32, _profile.wait_histogram[b]);
+            printf("\n  hold log2(us):");
+            for(size_t b = 0; b < buckets; b++) printf(" %" PRIu32, _profile.hold_histogram[b]);
+            printf("\n");
+
+            for(size_t w = 0; w < top_waiters; w++) {
+                const lock_waiter& _waiter = _profile.top_waiters[w];
+                if(_waiter.task == NULL) continue;
+
+                printf("  waiter %-15s %" PRIu32 "x %" PRIu32 "us\n",
+                    _waiter.name, _waiter.count, _waiter.wait_us);
+            }
+        }
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::~basic_lock_probe
+    //-----------------------------------
+    basic_lock_probe::~basic_lock_probe() {
+        if(m_iIndex >= 0)
+            basic_lock_profiler::instance().detach(m_iIndex);
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::now
+    //-----------------------------------
+    uint32_t basic_lock_probe::now() {
+        return (uint32_t)esp_timer_get_time();
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::get_index
+    //-----------------------------------
+    int basic_lock_probe::get_index(const void* lock) {
+        if(m_iIndex == -1) {
+            int _index = basic_lock_profiler::instance().attach(lock);
+            m_iIndex = (_index < 0) ? -2 : _index;
+        }
+        return m_iIndex;
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::acquired
+    //-----------------------------------
+    void basic_lock_probe::acquired(const void* lock, uint32_t wait_us, bool contended) {
+        int _index = get_index(lock);
+
+        if(_index >= 0)
+            basic_lock_profiler::instance().on_acquire(_index, wait_us, contended);
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::timed_out
+    //-----------------------------------
+    void basic_lock_probe::timed_out(const void* lock, uint32_t wait_us) {
+        int _index = get_index(lock);
+
+        if(_index >= 0)
+            basic_lock_profiler::instance().on_timeout(_index, wait_us);
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::released
+    //-----------------------------------
+    void basic_lock_probe::released() {
+        if(m_iIndex >= 0)
+            basic_lock_profiler::instance().on_release(m_iIndex);
+    }
+
+    //-----------------------------------
+    //  basic_lock_probe::set_name
+    //-----------------------------------
+    void basic_lock_probe::set_name(const void* lock, const char* name) {
+        int _index = get_index(lock);
+
+        if(_index >= 0)
+            basic_lock_profiler::instance().set_name(_index, name);
+    }
+}
+
+#endif // MN_THREAD_CONFIG_LOCK_PROFILING
@@ -67,8 +67,17 @@ namespace mofw {
         success = xSemaphoreTakeFromISR( m_pSpinlock, &xHigherPriorityTaskWoken );
         if(xHigherPriorityTaskWoken)
           _frxt_setup_switch();
+
+      #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+        if(success == pdTRUE) m_lockProbe.acquired(this);
+      #endif
     } else {
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+      success = m_lockProbe.take(this, timeout, [this](TickType_t ticks) {
+        return xSemaphoreTake((QueueHandle_t)m_pSpinlock, ticks); });
+    #else
       success = xSemaphoreTake((QueueHandle_t)m_pSpinlock, timeout);
+    #endif
     }
 
     if(success != pdTRUE ) {
@@ -96,6 +105,9 @@ namespace mofw {
     if(success != pdTRUE ) {
       return ERR_MUTEX_UNLOCK;
     }
+  #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+    m_lockProbe.released();
+  #endif
     m_isLocked = false;
     return ERR_MUTEX_OK;
   }
@@ -42,7 +42,7 @@ namespace mofw {
 			if(_iret > 0) {
 				if(ep != NULL) {
 					ep->set_host( basic_ip4_address( (uint32_t) addr.sin_addr.s_addr ) ) ;
-					ep->set_port(addr.sin_port);
+					ep->set_port(ntohs(addr.sin_port));
 				}
 			}
 			return _iret;
@@ -75,6 +75,121 @@ namespace mofw {
 							   addrlen );
 		}
 
+		//-----------------------------------
+		//  recvv_from
+		//-----------------------------------
+		int basic_dgram_ip_socket::recvv_from(basic_buffer_chain& chain,
+			typename basic_dgram_ip_socket::endpoint_type* ep, const socket_flags& socketFlags) {
+
+			if(m_iHandle == -1) return -1;
+
+			struct sockaddr_in addr;
+			memset((char *) &addr, 0, sizeof(addr));
+
+			struct msghdr msg;
+			memset((char *) &msg, 0, sizeof(msg));
+			msg.msg_name = &addr;
+			msg.msg_namelen = sizeof(addr);
+			msg.msg_iov = chain.data();
+			msg.msg_iovlen = chain.segments();
+
+			int _iret = lwip_recvmsg(m_iHandle, &msg, static_cast<int>(socketFlags));
+
+			if(_iret > 0) {
+				if(ep != NULL) {
+					ep->set_host( basic_ip4_address( (uint32_t) addr.sin_addr.s_addr ) ) ;
+					ep->set_port(ntohs(addr.sin_port));
+				}
+			}
+			return _iret;
+		}
+
+		//-----------------------------------
+		//  sendv_to
+		//-----------------------------------
+		int basic_dgram_ip_socket::sendv_to(basic_buffer_chain& chain,
+			typename basic_dgram_ip_socket::endpoint_type& ep, const socket_flags& socketFlags) {
+
+			if(m_iHandle == -1) return -1;
+
+			typename basic_dgram_ip_socket::ipaddress_type ip = ep.get_host();
+			unsigned int port = ep.get_port();
+
+			struct sockaddr_in addr;
+			memset((char *) &addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_port = htons(port);
+			addr.sin_addr.s_addr = (in_addr_t)ip;
+
+			struct msghdr msg;
+			memset((char *) &msg, 0, sizeof(msg));
+			msg.msg_name = &addr;
+			msg.msg_namelen = sizeof(addr);
+			msg.msg_iov = chain.data();
+			msg.msg_iovlen = chain.segments();
+
+			return lwip_sendmsg(m_iHandle, &msg, static_cast<int>(socketFlags));
+		}
+
+		//-----------------------------------
+		//  recive_batch
+		//-----------------------------------
+		int basic_dgram_ip_socket::recive_batch(basic_dgram_batch& batch, const socket_flags& socketFlags) {
+			if(m_iHandle == -1) return -1;
+
+			int _flags = static_cast<int>(socketFlags);
+			batch.prepare_receive();
+
+		#if MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG == MN_THREAD_CONFIG_YES
+			int _iret = ::recvmmsg(m_iHandle, batch.m_aMsgs, basic_dgram_batch::capacity,
+				_flags | MSG_WAITFORONE, NULL);
+
+			if(_iret > 0) batch.received(_iret);
+			return _iret;
+		#else
+			int _count = 0;
+
+			while(_count < (int)basic_dgram_batch::capacity) {
+				int _iret = lwip_recvmsg(m_iHandle, &batch.m_aMsgs[_count].msg_hdr, _flags);
+				if(_iret < 0) {
+					if(_count == 0) return -1;
+					break;
+				}
+				batch.m_aMsgs[_count].msg_len = _iret;
+				_count++;
+
+				// wait only for the first datagram
+				_flags |= MSG_DONTWAIT;
+			}
+			batch.received(_count);
+			return _count;
+		#endif
+		}
+
+		//-----------------------------------
+		//  send_batch
+		//-----------------------------------
+		int basic_dgram_ip_socket::send_batch(basic_dgram_batch& batch, const socket_flags& socketFlags) {
+			if(m_iHandle == -1) return -1;
+
+			int _flags = static_cast<int>(socketFlags);
+			int _sent = 0;
+
+			while(batch.m_szFirst < batch.m_szCount) {
+			#if MN_THREAD_CONFIG_NET_DGRAM_BATCH_MMSG == MN_THREAD_CONFIG_YES
+				int _iret = ::sendmmsg(m_iHandle, &batch.m_aMsgs[batch.m_szFirst],
+					batch.m_szCount - batch.m_szFirst, _flags);
+			#else
+				int _iret = lwip_sendmsg(m_iHandle, &batch.m_aMsgs[batch.m_szFirst].msg_hdr, _flags);
+				if(_iret >= 0) _iret = 1;
+			#endif
+				if(_iret < 0) return (_sent > 0) ? _sent : -1;
+
+				batch.m_szFirst += _iret;
+				_sent += _iret;
+			}
+			return _sent;
+		}
 
 
 		//======================== basic_dgram_ip6_socket ========================
@@ -102,11 +217,11 @@ namespace mofw {
 											addr.sin6_addr.un.u32_addr[2],  addr.sin6_addr.un.u32_addr[3]  );
 
 				#if MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID  == MN_THREAD_CONFIG_YES
-					_ipx->set_scopeid(addr.sin6_scope_id);
+					_ipx.set_scopeid(addr.sin6_scope_id);
 
 				#endif // MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID
 					ep->set_host(_ipx) ;
-					ep->set_port(addr.sin6_port);
+					ep->set_port(ntohs(addr.sin6_port));
 				}
 			}
 			return _iret;
@@ -139,6 +254,72 @@ namespace mofw {
 							   addrlen );
 
 		}
+
+		//-----------------------------------
+		//  recvv_from
+		//-----------------------------------
+		int basic_dgram_ip6_socket::recvv_from(basic_buffer_chain& chain,
+			typename basic_dgram_ip6_socket::endpoint_type* ep, socket_flags socketFlags) {
+
+			if(m_iHandle == -1) return -1;
+
+			struct sockaddr_in6 addr;
+			memset((char *) &addr, 0, sizeof(addr));
+
+			struct msghdr msg;
+			memset((char *) &msg, 0, sizeof(msg));
+			msg.msg_name = &addr;
+			msg.msg_namelen = sizeof(addr);
+			msg.msg_iov = chain.data();
+			msg.msg_iovlen = chain.segments();
+
+			int _iret = lwip_recvmsg(m_iHandle, &msg, static_cast<int>(socketFlags));
+
+			if(_iret > 0) {
+				if(ep != NULL) {
+					basic_ip6_address _ipx( addr.sin6_addr.un.u32_addr[0],  addr.sin6_addr.un.u32_addr[1],
+											addr.sin6_addr.un.u32_addr[2],  addr.sin6_addr.un.u32_addr[3]  );
+
+				#if MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID  == MN_THREAD_CONFIG_YES
+					_ipx.set_scopeid(addr.sin6_scope_id);
+
+				#endif // MN_THREAD_CONFIG_NET_IPADDRESS6_USE_SCOPEID
+					ep->set_host(_ipx) ;
+					ep->set_port(ntohs(addr.sin6_port));
+				}
+			}
+			return _iret;
+		}
+
+		//-----------------------------------
+		//  sendv_to
+		//-----------------------------------
+		int basic_dgram_ip6_socket::sendv_to(basic_buffer_chain& chain,
+			typename basic_dgram_ip6_socket::endpoint_type* ep, socket_flags socketFlags) {
+
+			if(m_iHandle == -1) return -1;
+
+			typename basic_dgram_ip6_socket::ipaddress_type ip = ep->get_host();
+			unsigned int port = ep->get_port();
+
+			struct sockaddr_in6 addr;
+			memset((char *) &addr, 0, sizeof(addr));
+			addr.sin6_family = AF_INET6;
+			addr.sin6_port = htons(port);
+			addr.sin6_addr.un.u32_addr[0] = ip.get_int(0);
+			addr.sin6_addr.un.u32_addr[1] = ip.get_int(1);
+			addr.sin6_addr.un.u32_addr[2] = ip.get_int(2);
+			addr.sin6_addr.un.u32_addr[3] = ip.get_int(3);
+
+			struct msghdr msg;
+			memset((char *) &msg, 0, sizeof(msg));
+			msg.msg_name = &addr;
+			msg.msg_namelen = sizeof(addr);
+			msg.msg_iov = chain.data();
+			msg.msg_iovlen = chain.segments();
+
+			return lwip_sendmsg(m_iHandle, &msg, static_cast<int>(socketFlags));
+		}
 	#endif // MN_THREAD_CONFIG_NET_IPADDRESS6_ENABLE
 	}
 }
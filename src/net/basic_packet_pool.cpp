@@ -0,0 +1,143 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+#include "net/basic_packet_pool.hpp"
+
+#include <new>
+#include <esp_log.h>
+
+namespace mofw {
+	namespace net {
+		//-----------------------------------
+		// intrusive_ptr_release
+		//-----------------------------------
+		void intrusive_ptr_release(basic_packet* p) noexcept {
+			if(p->m_uiRefs.fetch_sub(1, memory_order::Release) == 1) {
+				mofw::atomic_thread_fence(memory_order::Acquire);
+				p->m_pPool->release(p);
+			}
+		}
+
+		//-----------------------------------
+		// basic_packet_pool_base
+		//-----------------------------------
+		basic_packet_pool_base::basic_packet_pool_base(size_type uiPackets, size_type uiPacketSize) noexcept
+			: m_pMemory(NULL), m_pFree(NULL), m_szPackets(uiPackets), m_szPacketSize(uiPacketSize),
+			  m_uiUsed(0), m_uiHighWater(0), m_uiExhausted(0), m_uiAllocated(0) {
+
+			m_muxPool = portMUX_INITIALIZER_UNLOCKED;
+		}
+
+		//-----------------------------------
+		// allocate
+		//-----------------------------------
+		packet_ptr basic_packet_pool_base::allocate() noexcept {
+			basic_packet* _packet = NULL;
+
+			portENTER_CRITICAL_SAFE(&m_muxPool);
+			if(m_pFree != NULL) {
+				_packet = m_pFree;
+				m_pFree = _packet->m_pNext;
+
+				if(++m_uiUsed > m_uiHighWater) m_uiHighWater = m_uiUsed;
+				m_uiAllocated++;
+			} else {
+				m_uiExhausted++;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxPool);
+
+			if(_packet == NULL) return packet_ptr();
+
+			_packet->m_pNext = NULL;
+			_packet->m_szLength = 0;
+
+			return packet_ptr(_packet);
+		}
+
+		//-----------------------------------
+		// release
+		//-----------------------------------
+		void basic_packet_pool_base::release(basic_packet* packet) noexcept {
+			portENTER_CRITICAL_SAFE(&m_muxPool);
+			packet->m_pNext = m_pFree;
+			m_pFree = packet;
+			m_uiUsed--;
+			portEXIT_CRITICAL_SAFE(&m_muxPool);
+		}
+
+		//-----------------------------------
+		// reset_stats
+		//-----------------------------------
+		void basic_packet_pool_base::reset_stats() noexcept {
+			portENTER_CRITICAL_SAFE(&m_muxPool);
+			m_uiHighWater = m_uiUsed;
+			m_uiExhausted = 0;
+			m_uiAllocated = 0;
+			portEXIT_CRITICAL_SAFE(&m_muxPool);
+		}
+
+		//-----------------------------------
+		// init
+		//-----------------------------------
+		void basic_packet_pool_base::init(void* pMemory) noexcept {
+			char* _block = static_cast<char*>(pMemory);
+			size_type _size = get_block_size();
+			basic_packet* _free = NULL;
+
+			// build the list from the back, so the first packet is in front
+			for(size_type i = m_szPackets; i > 0; i--) {
+				basic_packet* _packet = ::new (_block + (i - 1) * _size) basic_packet(this);
+
+				_packet->m_pNext = _free;
+				_free = _packet;
+			}
+
+			portENTER_CRITICAL_SAFE(&m_muxPool);
+			m_pMemory = pMemory;
+			m_pFree = _free;
+			m_uiUsed = m_uiHighWater = m_uiExhausted = m_uiAllocated = 0;
+			portEXIT_CRITICAL_SAFE(&m_muxPool);
+		}
+
+		//-----------------------------------
+		// release_memory
+		//-----------------------------------
+		void* basic_packet_pool_base::release_memory() noexcept {
+			void* _mem = NULL;
+
+			portENTER_CRITICAL_SAFE(&m_muxPool);
+			if(m_uiUsed == 0) {
+				_mem = m_pMemory;
+
+				m_pMemory = NULL;
+				m_pFree = NULL;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxPool);
+
+			return _mem;
+		}
+
+		//-----------------------------------
+		// log_in_use
+		//-----------------------------------
+		void basic_packet_pool_base::log_in_use() const noexcept {
+			ESP_LOGE("packet pool", "destroyed with %u packets in use, the memory is not freed",
+				(unsigned int)m_uiUsed);
+		}
+	}
+}
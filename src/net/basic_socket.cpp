@@ -25,7 +25,7 @@ namespace mofw {
 		// basic_ip_socket::basic_ip_socket
 		//-----------------------------------
 		basic_ip_socket::basic_ip_socket(const handle_type& hndl) noexcept
-			: m_iHandle(hndl) { }
+			: m_iHandle(hndl), m_bBlocked(true) { }
 
 		//-----------------------------------
 		// basic_ip_socket::basic_ip_socket
@@ -35,6 +35,8 @@ namespace mofw {
 			 m_eFam = fam;
 			 m_eType = type;
 			 m_eProtocol = protocol;
+			 // a new socket is blocking
+			 m_bBlocked = true;
 
 			 m_iHandle = lwip_socket(static_cast<int>(fam), static_cast<int>(type), static_cast<int>(protocol) );
 		}
@@ -50,7 +52,7 @@ namespace mofw {
 		// basic_ip_socket::basic_ip_socket
 		//-----------------------------------
 		basic_ip_socket::basic_ip_socket(const basic_ip_socket& other) noexcept
-			: m_iHandle(other.m_iHandle) {
+			: m_iHandle(other.m_iHandle), m_bBlocked(other.m_bBlocked) {
 			m_eFam = other.m_eFam;
 			m_eType = other.m_eType;
 			m_eProtocol = other.m_eProtocol;
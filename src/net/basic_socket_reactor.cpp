@@ -0,0 +1,595 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/basic_socket_reactor.hpp"
+
+namespace mofw {
+	namespace net {
+		namespace internal {
+			/**
+			 * Convert ticks to millis for poll, -1 waits without timeout
+			 */
+			inline int to_millis(TickType_t uiTicks) {
+				if(uiTicks == portMAX_DELAY) return -1;
+				return (int)(uiTicks * portTICK_PERIOD_MS);
+			}
+		}
+
+		//-----------------------------------
+		// basic_reactor_handler::basic_reactor_handler
+		//-----------------------------------
+		basic_reactor_handler::basic_reactor_handler(basic_ip_socket& socket, uint32_t uiEvents,
+			trigger_mode mode)
+			: m_pReactor(NULL),
+			  m_pSocket(&socket),
+			  m_iHandle(MNTHREAD_NET_INVALID_SOCKET),
+			  m_iSlot(-1),
+			  m_uiEvents(uiEvents),
+			  m_uiArmed(uiEvents),
+			  m_eMode(mode),
+			  m_uiTimeout(0) { }
+
+		//-----------------------------------
+		// basic_reactor_handler::~basic_reactor_handler
+		//-----------------------------------
+		basic_reactor_handler::~basic_reactor_handler() {
+			// too late for remove, the reactor can call on_event of the destroyed derived class
+			configASSERT(m_pReactor == NULL);
+		}
+
+		//-----------------------------------
+		// basic_reactor_handler::remove
+		//-----------------------------------
+		bool basic_reactor_handler::remove() {
+			basic_socket_reactor* _reactor = m_pReactor;
+			return (_reactor == NULL) ? false : _reactor->remove(this);
+		}
+
+		//-----------------------------------
+		// basic_reactor_handler::set_events
+		//-----------------------------------
+		bool basic_reactor_handler::set_events(uint32_t uiEvents) {
+			basic_socket_reactor* _reactor = m_pReactor;
+
+			if(_reactor == NULL) {
+				m_uiEvents = m_uiArmed = uiEvents;
+				return false;
+			}
+			return _reactor->modify(this, uiEvents, true);
+		}
+
+		//-----------------------------------
+		// basic_reactor_handler::rearm
+		//-----------------------------------
+		bool basic_reactor_handler::rearm() {
+			basic_socket_reactor* _reactor = m_pReactor;
+			return (_reactor == NULL) ? false : _reactor->modify(this, m_uiEvents, true);
+		}
+
+		//-----------------------------------
+		// basic_reactor_handler::set_idle_timeout
+		//-----------------------------------
+		void basic_reactor_handler::set_idle_timeout(unsigned int uiTicks) {
+			basic_socket_reactor* _reactor = m_pReactor;
+
+			m_uiTimeout = uiTicks;
+			if(_reactor != NULL) _reactor->set_timeout(this, uiTicks);
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::basic_socket_reactor
+		//-----------------------------------
+		basic_socket_reactor::basic_socket_reactor()
+			: m_uiCount(0),
+			  m_tLastTick(0),
+			  m_uiExpired(0),
+			  m_pCurrent(NULL),
+			  m_hRunner(NULL),
+			  m_iWakeup(MNTHREAD_NET_INVALID_SOCKET),
+			  m_bWakeupPending(false),
+			  m_uiDispatched(0) {
+
+			m_muxTable = portMUX_INITIALIZER_UNLOCKED;
+
+			memset(m_pHandlers, 0, sizeof(m_pHandlers));
+			memset(m_pExpired, 0, sizeof(m_pExpired));
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::~basic_socket_reactor
+		//-----------------------------------
+		basic_socket_reactor::~basic_socket_reactor() {
+			for(size_t i = 0; i < capacity; i++) {
+				if(m_pHandlers[i] != NULL) remove(m_pHandlers[i]);
+			}
+			if(m_iWakeup != MNTHREAD_NET_INVALID_SOCKET) lwip_close(m_iWakeup);
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::create
+		//-----------------------------------
+		bool basic_socket_reactor::create() {
+			if(m_iWakeup != MNTHREAD_NET_INVALID_SOCKET) return true;
+
+			// a udp socket, that is connected to itself on the loopback interface
+			handle_type _hndl = lwip_socket(AF_INET, SOCK_DGRAM, 0);
+			if(_hndl < 0) return false;
+
+			struct sockaddr_in _addr;
+			socklen_t _len = sizeof(_addr);
+
+			memset(&_addr, 0, sizeof(_addr));
+			_addr.sin_family = AF_INET;
+			_addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			_addr.sin_port = 0;
+
+			if(lwip_bind(_hndl, (struct sockaddr*)&_addr, sizeof(_addr)) != 0 ||
+			   lwip_getsockname(_hndl, (struct sockaddr*)&_addr, &_len) != 0 ||
+			   lwip_connect(_hndl, (struct sockaddr*)&_addr, sizeof(_addr)) != 0) {
+
+				lwip_close(_hndl);
+				return false;
+			}
+			lwip_fcntl(_hndl, F_SETFL, O_NONBLOCK);
+
+			m_iWakeup = _hndl;
+			return true;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::add
+		//-----------------------------------
+		bool basic_socket_reactor::add(handler_type* handler) {
+			if(handler == NULL || handler->m_pReactor != NULL) return false;
+			if(!create()) return false;
+
+			handle_type _hndl = handler->m_pSocket->get_handle();
+			if(_hndl == MNTHREAD_NET_INVALID_SOCKET) return false;
+
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			if(m_uiCount >= capacity) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return false;
+			}
+			int _slot = 0;
+			while(m_pHandlers[_slot] != NULL) _slot++;
+
+			m_pHandlers[_slot] = handler;
+			m_uiCount++;
+
+			handler->m_pReactor = this;
+			handler->m_iSlot = _slot;
+			handler->m_iHandle = _hndl;
+			handler->m_uiArmed = handler->m_uiEvents;
+
+			if(handler->m_uiTimeout > 0) insert_timeout(handler, handler->m_uiTimeout);
+
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			if(!is_reactor_task()) wakeup();
+
+			return true;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::remove
+		//-----------------------------------
+		bool basic_socket_reactor::remove(handler_type* handler) {
+			if(handler == NULL) return false;
+
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			if(handler->m_pReactor != this) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return false;
+			}
+			m_pHandlers[handler->m_iSlot] = NULL;
+			m_uiCount--;
+			erase_timeout(handler);
+
+			handler->m_pReactor = NULL;
+			handler->m_iSlot = -1;
+			handler->m_iHandle = MNTHREAD_NET_INVALID_SOCKET;
+
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			if(is_reactor_task()) return true;
+
+			wakeup();
+			while(m_pCurrent == handler)
+				vTaskDelay(1);
+
+			return true;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::modify
+		//-----------------------------------
+		bool basic_socket_reactor::modify(handler_type* handler, uint32_t uiEvents, bool bRearm) {
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			if(handler->m_pReactor != this) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return false;
+			}
+			handler->m_uiEvents = uiEvents;
+			if(bRearm) handler->m_uiArmed = uiEvents;
+
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			// the select and poll sets are build on each run
+			if(!is_reactor_task()) wakeup();
+			return true;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::set_timeout
+		//-----------------------------------
+		void basic_socket_reactor::set_timeout(handler_type* handler, unsigned int uiTicks) {
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			if(handler->m_pReactor != this) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return;
+			}
+			erase_timeout(handler);
+			if(uiTicks > 0) insert_timeout(handler, uiTicks);
+
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			if(!is_reactor_task()) wakeup();
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::erase_timeout
+		//-----------------------------------
+		void basic_socket_reactor::erase_timeout(handler_type* handler) {
+			if(m_wheelTimeouts.erase(handler)) return;
+
+			// expired and not dispatched, move the last entry in the hole
+			for(unsigned int i = 0; i < m_uiExpired; i++) {
+				if(m_pExpired[i] != handler) continue;
+
+				m_pExpired[i] = m_pExpired[--m_uiExpired];
+				m_pExpired[m_uiExpired] = NULL;
+				break;
+			}
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::insert_timeout
+		//-----------------------------------
+		void basic_socket_reactor::insert_timeout(handler_type* handler, unsigned int uiTicks) {
+			TickType_t _now = xTaskGetTickCount();
+
+			// the wheel time is old after a sleep with a empty wheel
+			if(m_wheelTimeouts.empty())
+				m_tLastTick += m_wheelTimeouts.skip(_now - m_tLastTick);
+
+			// and can be behind while the reactor sleeps until the next expiry
+			m_wheelTimeouts.insert(handler, uiTicks + (_now - m_tLastTick));
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::sync_time
+		//-----------------------------------
+		void basic_socket_reactor::sync_time() {
+			// a handler is in the wheel or in m_pExpired, so the array can not overflow
+			auto _to_expired = [this](handler_type* handler) {
+				configASSERT(m_uiExpired < capacity);
+				m_pExpired[m_uiExpired++] = handler;
+			};
+			bool _done = false;
+
+			// each critical section handles one tick start or one handler
+			while(!_done) {
+				portENTER_CRITICAL_SAFE(&m_muxTable);
+
+				if(!m_wheelTimeouts.advance_one(_to_expired)) {
+					TickType_t _now = xTaskGetTickCount();
+
+					// jump over the ticks without work, then start the next tick
+					m_tLastTick += m_wheelTimeouts.skip(_now - m_tLastTick);
+
+					if(m_tLastTick != _now) {
+						m_wheelTimeouts.begin_advance();
+						m_tLastTick++;
+					}
+					_done = (m_tLastTick == _now) && !m_wheelTimeouts.is_advancing();
+				}
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+			}
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::wakeup
+		//-----------------------------------
+		void basic_socket_reactor::wakeup() {
+			if(m_iWakeup == MNTHREAD_NET_INVALID_SOCKET || m_bWakeupPending) return;
+
+			m_bWakeupPending = true;
+
+			char _byte = 0;
+			lwip_send(m_iWakeup, &_byte, 1, MSG_DONTWAIT);
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::drain_wakeup
+		//-----------------------------------
+		void basic_socket_reactor::drain_wakeup() {
+			char _buffer[16];
+
+			// first drain and then clear: a wakeup between them sees the flag and sends no
+			// byte, the reactor is awake and builds the sets new. Cleared before the drain,
+			// the byte of such a wakeup is eaten and the flag stays set for ever.
+			while(lwip_recv(m_iWakeup, _buffer, sizeof(_buffer), MSG_DONTWAIT) > 0) { }
+			m_bWakeupPending = false;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::run_once
+		//-----------------------------------
+		int basic_socket_reactor::run_once(TickType_t uiTimeout) {
+			if(!create()) return -1;
+
+			m_hRunner = xTaskGetCurrentTaskHandle();
+
+			sync_time();
+
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+			bool _expired = m_uiExpired > 0;
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			int _ret = 0;
+			if(_expired) {
+				_ret = dispatch_timeouts();
+				uiTimeout = 0;
+			}
+
+			// sleep until the next tick that can expire a idle timeout, a shorter
+			// timeout from a other task wakes the reactor
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			if(!m_wheelTimeouts.empty()) {
+				TickType_t _next = m_wheelTimeouts.next_expire();
+				TickType_t _passed = xTaskGetTickCount() - m_tLastTick;
+				TickType_t _delay = (_next > _passed) ? _next - _passed : 0;
+
+				if(uiTimeout > _delay) uiTimeout = _delay;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			int _events = wait(uiTimeout);
+			if(_events < 0) return (_ret > 0) ? _ret : -1;
+
+			return _ret + _events;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::dispatch
+		//-----------------------------------
+		int basic_socket_reactor::dispatch(int slot, handle_type hndl, uint32_t uiEvents) {
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			handler_type* _handler = m_pHandlers[slot];
+
+			// removed or replaced while the reactor waits
+			if(_handler == NULL || _handler->m_iHandle != hndl) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return 0;
+			}
+			uiEvents &= _handler->m_uiArmed | handler_type::event_error | handler_type::event_hangup;
+
+			if(uiEvents == handler_type::event_none) {
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+				return 0;
+			}
+			if(_handler->m_eMode == handler_type::trigger_mode::edge)
+				_handler->m_uiArmed &= ~uiEvents;
+
+			if(_handler->m_uiTimeout > 0) {
+				erase_timeout(_handler);
+				insert_timeout(_handler, _handler->m_uiTimeout);
+			}
+			m_pCurrent = _handler;
+			m_uiDispatched++;
+
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			_handler->on_event(uiEvents);
+			m_pCurrent = NULL;
+
+			return 1;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::dispatch_timeouts
+		//-----------------------------------
+		int basic_socket_reactor::dispatch_timeouts() {
+			int _ret = 0;
+
+			for(;;) {
+				handler_type* _handler = NULL;
+
+				portENTER_CRITICAL_SAFE(&m_muxTable);
+
+				if(m_uiExpired > 0) {
+					_handler = m_pExpired[--m_uiExpired];
+					m_pExpired[m_uiExpired] = NULL;
+				}
+
+				if(_handler != NULL) {
+					m_pCurrent = _handler;
+					m_uiDispatched++;
+				}
+				portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+				if(_handler == NULL) break;
+
+				_handler->on_timeout();
+				m_pCurrent = NULL;
+
+				_ret++;
+			}
+			return _ret;
+		}
+
+	#if MN_THREAD_CONFIG_NET_REACTOR_BACKEND == MN_THREAD_CONFIG_NET_REACTOR_POLL
+		//-----------------------------------
+		// basic_socket_reactor::wait
+		//-----------------------------------
+		int basic_socket_reactor::wait(TickType_t uiTimeout) {
+			nfds_t _count = 1;
+
+			m_aPoll[0].fd = m_iWakeup;
+			m_aPoll[0].events = POLLIN;
+			m_aPoll[0].revents = 0;
+
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			for(size_t i = 0; i < capacity; i++) {
+				handler_type* _handler = m_pHandlers[i];
+				if(_handler == NULL) continue;
+
+				m_aPoll[_count].fd = _handler->m_iHandle;
+				m_aPoll[_count].events = 0;
+				m_aPoll[_count].revents = 0;
+
+				if(_handler->m_uiArmed & handler_type::event_read) m_aPoll[_count].events |= POLLIN;
+				if(_handler->m_uiArmed & handler_type::event_write) m_aPoll[_count].events |= POLLOUT;
+
+				m_aPollSlot[_count++] = (int)i;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			int _ready = lwip_poll(m_aPoll, _count, internal::to_millis(uiTimeout));
+
+			if(_ready < 0) return (errno == EINTR) ? 0 : -1;
+			if(_ready == 0) return 0;
+
+			if(m_aPoll[0].revents & POLLIN) drain_wakeup();
+
+			int _ret = 0;
+
+			for(nfds_t i = 1; i < _count; i++) {
+				short _ev = m_aPoll[i].revents;
+				if(_ev == 0) continue;
+
+				uint32_t _events = handler_type::event_none;
+
+				if(_ev & POLLIN) _events |= handler_type::event_read;
+				if(_ev & POLLOUT) _events |= handler_type::event_write;
+				if(_ev & (POLLERR | POLLNVAL)) _events |= handler_type::event_error;
+				if(_ev & POLLHUP) _events |= handler_type::event_hangup;
+
+				_ret += dispatch(m_aPollSlot[i], m_aPoll[i].fd, _events);
+			}
+			return _ret;
+		}
+	#else
+		//-----------------------------------
+		// basic_socket_reactor::wait
+		//-----------------------------------
+		int basic_socket_reactor::wait(TickType_t uiTimeout) {
+			handle_type _handles[capacity];
+			handle_type _max = m_iWakeup;
+			fd_set _read, _write, _except;
+
+			FD_ZERO(&_read); FD_ZERO(&_write); FD_ZERO(&_except);
+			FD_SET(m_iWakeup, &_read);
+
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+
+			for(size_t i = 0; i < capacity; i++) {
+				handler_type* _handler = m_pHandlers[i];
+
+				_handles[i] = (_handler == NULL) ? MNTHREAD_NET_INVALID_SOCKET : _handler->m_iHandle;
+				if(_handler == NULL) continue;
+
+				if(_handler->m_uiArmed & handler_type::event_read) FD_SET(_handles[i], &_read);
+				if(_handler->m_uiArmed & handler_type::event_write) FD_SET(_handles[i], &_write);
+				FD_SET(_handles[i], &_except);
+
+				if(_handles[i] > _max) _max = _handles[i];
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			struct timeval _tv;
+			struct timeval* _ptv = NULL;
+
+			if(uiTimeout != portMAX_DELAY) {
+				int _ms = internal::to_millis(uiTimeout);
+
+				_tv.tv_sec = _ms / 1000;
+				_tv.tv_usec = (_ms % 1000) * 1000;
+				_ptv = &_tv;
+			}
+			int _ready = lwip_select(_max + 1, &_read, &_write, &_except, _ptv);
+
+			// EBADF: a socket was closed before it was removed, the set is build new on the next run
+			if(_ready < 0) return (errno == EINTR || errno == EBADF) ? 0 : -1;
+			if(_ready == 0) return 0;
+
+			if(FD_ISSET(m_iWakeup, &_read)) drain_wakeup();
+
+			int _ret = 0;
+
+			for(size_t i = 0; i < capacity; i++) {
+				if(_handles[i] == MNTHREAD_NET_INVALID_SOCKET) continue;
+
+				uint32_t _events = handler_type::event_none;
+
+				if(FD_ISSET(_handles[i], &_read)) _events |= handler_type::event_read;
+				if(FD_ISSET(_handles[i], &_write)) _events |= handler_type::event_write;
+				if(FD_ISSET(_handles[i], &_except)) _events |= handler_type::event_error;
+
+				if(_events != handler_type::event_none)
+					_ret += dispatch((int)i, _handles[i], _events);
+			}
+			return _ret;
+		}
+	#endif
+
+		//-----------------------------------
+		// basic_socket_reactor::get_num_handlers
+		//-----------------------------------
+		unsigned int basic_socket_reactor::get_num_handlers() {
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+			unsigned int _count = m_uiCount;
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			return _count;
+		}
+
+		//-----------------------------------
+		// basic_socket_reactor::get_num_dispatched
+		//-----------------------------------
+		uint32_t basic_socket_reactor::get_num_dispatched() {
+			portENTER_CRITICAL_SAFE(&m_muxTable);
+			uint32_t _count = m_uiDispatched;
+			portEXIT_CRITICAL_SAFE(&m_muxTable);
+
+			return _count;
+		}
+	}
+}
@@ -0,0 +1,184 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+#include "net/basic_stream_acceptor.hpp"
+
+#include <new>
+
+namespace mofw {
+	namespace net {
+		//-----------------------------------
+		// basic_stream_acceptor
+		//-----------------------------------
+		basic_stream_acceptor::basic_stream_acceptor(socket_type& listener)
+			: m_pListener(&listener), m_iFree(0), m_iUsed(0), m_uiAccepted(0), m_uiOverflow(0),
+			  m_uiRateCount(0), m_uiRate(0) {
+
+			m_muxSlab = portMUX_INITIALIZER_UNLOCKED;
+			m_tRateStart = xTaskGetTickCount();
+
+			for(int i = 0; i < capacity; i++) {
+				handle_type _hndl = MNTHREAD_NET_INVALID_SOCKET;
+
+				::new (static_cast<void*>(m_aStorage[i])) socket_type(_hndl, nullptr);
+				m_aNext[i] = (i + 1 < capacity) ? i + 1 : -1;
+			}
+		}
+
+		//-----------------------------------
+		// ~basic_stream_acceptor
+		//-----------------------------------
+		basic_stream_acceptor::~basic_stream_acceptor() {
+			for(int i = 0; i < capacity; i++) {
+				socket_type* _slot = get_slot(i);
+
+				if(_slot->get_handle() != MNTHREAD_NET_INVALID_SOCKET)
+					_slot->reset(MNTHREAD_NET_INVALID_SOCKET, true);
+				_slot->~socket_type();
+			}
+		}
+
+		//-----------------------------------
+		// accept
+		//-----------------------------------
+		typename basic_stream_acceptor::socket_type* basic_stream_acceptor::accept() {
+			bool _pending = false;
+			return accept_one(_pending);
+		}
+
+		//-----------------------------------
+		// accept_all
+		//-----------------------------------
+		int basic_stream_acceptor::accept_all(socket_type** ppClients, int iMax) {
+			int _count = 0;
+			bool _pending = true;
+			bool _blocking = m_pListener->get_blocking();
+
+			while(_count < iMax && _pending) {
+				socket_type* _client = accept_one(_pending);
+
+				// no client but pending: the connection was closed, the slab is full
+				if(_client != NULL) ppClients[_count++] = _client;
+
+				// a blocking listener would wait in the next accept for a new connection
+				if(_blocking) _pending = false;
+			}
+			return _count;
+		}
+
+		//-----------------------------------
+		// accept_one
+		//-----------------------------------
+		typename basic_stream_acceptor::socket_type* basic_stream_acceptor::accept_one(bool& bPending) {
+			int _index;
+
+			portENTER_CRITICAL_SAFE(&m_muxSlab);
+			_index = m_iFree;
+			if(_index != -1) {
+				m_iFree = m_aNext[_index];
+				m_iUsed++;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxSlab);
+
+			if(_index == -1) {
+				// the slab is full, take the connection from the backlog and close it,
+				// on a blocking listener the accept would wait when nothing is pending
+				int _clientfd = m_pListener->get_blocking() ? -1 :
+					lwip_accept(m_pListener->get_handle(), NULL, NULL);
+				bPending = (_clientfd >= 0);
+
+				if(bPending) {
+					lwip_close(_clientfd);
+
+					portENTER_CRITICAL_SAFE(&m_muxSlab);
+					m_uiOverflow++;
+					portEXIT_CRITICAL_SAFE(&m_muxSlab);
+				}
+				return NULL;
+			}
+
+			socket_type* _slot = get_slot(_index);
+			bPending = m_pListener->accept(*_slot);
+
+			portENTER_CRITICAL_SAFE(&m_muxSlab);
+			if(bPending) {
+				update_rate(xTaskGetTickCount());
+				m_uiAccepted++;
+				m_uiRateCount++;
+			} else {
+				m_aNext[_index] = m_iFree;
+				m_iFree = _index;
+				m_iUsed--;
+			}
+			portEXIT_CRITICAL_SAFE(&m_muxSlab);
+
+			return bPending ? _slot : NULL;
+		}
+
+		//-----------------------------------
+		// release
+		//-----------------------------------
+		bool basic_stream_acceptor::release(socket_type* client) {
+			unsigned char* _begin = m_aStorage[0];
+			unsigned char* _ptr = reinterpret_cast<unsigned char*>(client);
+
+			if(_ptr < _begin || _ptr >= _begin + sizeof(m_aStorage)) return false;
+			if((_ptr - _begin) % sizeof(socket_type) != 0) return false;
+
+			int _index = (_ptr - _begin) / sizeof(socket_type);
+			if(client->get_handle() == MNTHREAD_NET_INVALID_SOCKET) return false;
+
+			client->reset(MNTHREAD_NET_INVALID_SOCKET, true);
+
+			portENTER_CRITICAL_SAFE(&m_muxSlab);
+			m_aNext[_index] = m_iFree;
+			m_iFree = _index;
+			m_iUsed--;
+			portEXIT_CRITICAL_SAFE(&m_muxSlab);
+
+			return true;
+		}
+
+		//-----------------------------------
+		// get_accept_rate
+		//-----------------------------------
+		uint32_t basic_stream_acceptor::get_accept_rate() {
+			uint32_t _rate;
+
+			portENTER_CRITICAL_SAFE(&m_muxSlab);
+			update_rate(xTaskGetTickCount());
+			_rate = m_uiRate;
+			portEXIT_CRITICAL_SAFE(&m_muxSlab);
+
+			return _rate;
+		}
+
+		//-----------------------------------
+		// update_rate
+		//-----------------------------------
+		void basic_stream_acceptor::update_rate(TickType_t tNow) {
+			TickType_t _elapsed = tNow - m_tRateStart;
+			if(_elapsed < configTICK_RATE_HZ) return;
+
+			// when a whole second without a call is gone, the last second had no accepts
+			m_uiRate = (_elapsed < 2 * configTICK_RATE_HZ) ? m_uiRateCount : 0;
+			m_uiRateCount = 0;
+			m_tRateStart = tNow;
+		}
+	}
+}
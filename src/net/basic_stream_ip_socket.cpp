@@ -23,6 +23,52 @@
 
 namespace mofw {
 	namespace net {
+		namespace internal {
+			//-----------------------------------
+			// sendv_chain
+			//-----------------------------------
+			static int sendv_chain(int handle, basic_buffer_chain& chain, int flags, bool blocking) {
+				struct msghdr _msg;
+				int _sended = 0;
+				int _sent = 0;
+
+				while (!chain.empty()) {
+					memset((char *) &_msg, 0, sizeof(_msg));
+					_msg.msg_iov = chain.data();
+					_msg.msg_iovlen = chain.segments();
+
+					_sended = lwip_sendmsg(handle, &_msg, flags);
+					if(_sended < 0) return (_sent > 0) ? _sent : -1;
+
+					// a partial send resume in the middle of the chain
+					chain.consume(_sended);
+					_sent += _sended;
+
+					if (blocking && !chain.empty())
+						mofw::basic_task::yield();
+					else
+						break;
+				}
+				return _sent;
+			}
+
+			//-----------------------------------
+			// recvv_chain
+			//-----------------------------------
+			static int recvv_chain(int handle, basic_buffer_chain& chain, int flags) {
+				if(chain.empty()) return 0;
+
+				struct msghdr _msg;
+				memset((char *) &_msg, 0, sizeof(_msg));
+				_msg.msg_iov = chain.data();
+				_msg.msg_iovlen = chain.segments();
+
+				int _iret = lwip_recvmsg(handle, &_msg, flags);
+				if(_iret > 0) chain.consume(_iret);
+
+				return _iret;
+			}
+		}
 
 		//-----------------------------------
 		// basic_stream_ip_socket::send_bytes
@@ -67,6 +113,22 @@ namespace mofw {
 
 		}
 
+		//-----------------------------------
+		// basic_stream_ip_socket::sendv
+		//-----------------------------------
+		int basic_stream_ip_socket::sendv(basic_buffer_chain& chain, socket_flags socketFlags) {
+			if(m_iHandle == -1) return -1;
+			return internal::sendv_chain(m_iHandle, chain, static_cast<int>(socketFlags), get_blocking());
+		}
+
+		//-----------------------------------
+		// basic_stream_ip_socket::recvv
+		//-----------------------------------
+		int basic_stream_ip_socket::recvv(basic_buffer_chain& chain, socket_flags socketFlags) {
+			if(m_iHandle == -1) return -1;
+			return internal::recvv_chain(m_iHandle, chain, static_cast<int>(socketFlags));
+		}
+
 		//-----------------------------------
 		// basic_stream_ip_socket::connect
 		//-----------------------------------
@@ -117,6 +179,31 @@ namespace mofw {
 			return socket_return;
 		}
 
+		//-----------------------------------
+		// basic_stream_ip_socket::accept
+		//-----------------------------------
+		bool basic_stream_ip_socket::accept(self_type& client) {
+			if(m_iHandle == -1) return false;
+
+			int clientfd = lwip_accept(m_iHandle, NULL, NULL);
+			if(clientfd < 0) return false;
+
+			client.reset(clientfd, true);
+
+			client.m_eFam = m_eFam;
+			client.m_eType = m_eType;
+			client.m_eProtocol = m_eProtocol;
+			// a accepted socket is blocking, O_NONBLOCK is not inherited
+			client.m_bBlocked = true;
+
+			if(client.m_pEndPoint != nullptr) {
+				delete client.m_pEndPoint;
+				client.m_pEndPoint = nullptr;
+			}
+
+			return true;
+		}
+
 	#if MN_THREAD_CONFIG_NET_IPADDRESS6_ENABLE == MN_THREAD_CONFIG_YES
 
 		//-----------------------------------
@@ -159,6 +246,22 @@ namespace mofw {
 
 		}
 
+		//-----------------------------------
+		// basic_stream_ip6_socket::sendv
+		//-----------------------------------
+		int basic_stream_ip6_socket::sendv(basic_buffer_chain& chain, socket_flags socketFlags) {
+			if(m_iHandle == -1) return -1;
+			return internal::sendv_chain(m_iHandle, chain, static_cast<int>(socketFlags), get_blocking());
+		}
+
+		//-----------------------------------
+		// basic_stream_ip6_socket::recvv
+		//-----------------------------------
+		int basic_stream_ip6_socket::recvv(basic_buffer_chain& chain, socket_flags socketFlags) {
+			if(m_iHandle == -1) return -1;
+			return internal::recvv_chain(m_iHandle, chain, static_cast<int>(socketFlags));
+		}
+
 		//-----------------------------------
 		// basic_stream_ip6_socket::connect
 		//-----------------------------------
@@ -139,5 +139,19 @@ namespace mofw {
 
             return (ready == m_uiMaxWorkItems) && m_pWorkItemQueue->is_empty();
         }
+
+        //-----------------------------------
+        //  get_num_worker
+        //-----------------------------------
+        uint8_t basic_work_queue::get_num_worker() const {
+            return 1;
+        }
+
+        //-----------------------------------
+        //  is_worker
+        //-----------------------------------
+        bool basic_work_queue::is_worker() {
+            return false;
+        }
     }
 }
@@ -97,6 +97,18 @@ namespace mofw {
         return m_Workers.size();
         }
 
+        //-----------------------------------
+        //  is_worker
+        //-----------------------------------
+        bool basic_work_queue_multi::is_worker() {
+            TaskHandle_t _current = xTaskGetCurrentTaskHandle();
+
+            for(uint8_t i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->get_handle() == _current) return true;
+            }
+            return false;
+        }
+
         //-----------------------------------
         //  get_num_max_worker
         //-----------------------------------
@@ -52,6 +52,13 @@ namespace mofw {
         void basic_work_queue_single::destroy_engine() {
             m_pWorker->kill();
         }
+
+        //-----------------------------------
+        //  is_worker
+        //-----------------------------------
+        bool basic_work_queue_single::is_worker() {
+            return m_pWorker->get_handle() == xTaskGetCurrentTaskHandle();
+        }
     }
 }
 
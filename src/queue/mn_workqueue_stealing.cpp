@@ -0,0 +1,409 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify  
+*it under the terms of the GNU Lesser General Public License as published by  
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but 
+*WITHOUT ANY WARRANTY; without even the implied warranty of 
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU 
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.  
+*/
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "task.hpp"
+#include "queue/workqueue_stealing.hpp"
+
+namespace mofw {
+    namespace queue {
+        //-----------------------------------
+        //  work_queue_stealing_task::constructor
+        //-----------------------------------
+        work_queue_stealing_task::work_queue_stealing_task(char const* strName,
+                                            basic_task::priority uiPriority,
+                                            unsigned short  usStackDepth,
+                                            basic_work_queue_stealing* parent,
+                                            uint8_t uiIndex)
+
+            : basic_task(strName, uiPriority, usStackDepth), m_parentWorkQueue(parent),
+              m_uiIndex(uiIndex), m_uiExecuted(0), m_uiErrors(0), m_uiStolen(0), m_bIdle(false) {
+
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::push_local
+        //-----------------------------------
+        bool work_queue_stealing_task::push_local(work_queue_item* item) {
+            return m_dqLocal.push(item);
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::post
+        //-----------------------------------
+        bool work_queue_stealing_task::post(work_queue_item* item) {
+            return m_qInbox.try_push(item);
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::post_bulk
+        //-----------------------------------
+        size_t work_queue_stealing_task::post_bulk(work_queue_item** items, size_t count) {
+            return m_qInbox.push_bulk(items, count);
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::steal
+        //-----------------------------------
+        bool work_queue_stealing_task::steal(work_queue_item*& item) {
+            if(m_dqLocal.steal(item)) return true;
+
+            return m_qInbox.try_pop(item);
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::wakeup
+        //-----------------------------------
+        void work_queue_stealing_task::wakeup() {
+            TaskHandle_t _handle = get_handle();
+
+            if(_handle != NULL)
+                xTaskNotifyGive(_handle);
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::is_idle
+        //-----------------------------------
+        bool work_queue_stealing_task::is_idle() const {
+            return m_bIdle.load();
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::get_stats
+        //-----------------------------------
+        work_queue_stealing_task::stats work_queue_stealing_task::get_stats() const {
+            stats _stats;
+
+            _stats.executed = m_uiExecuted.load(memory_order::Relaxed);
+            _stats.errors = m_uiErrors.load(memory_order::Relaxed);
+            _stats.stolen = m_uiStolen.load(memory_order::Relaxed);
+
+            return _stats;
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::get_next_item
+        //-----------------------------------
+        work_queue_item* work_queue_stealing_task::get_next_item() {
+            work_queue_item* _item = NULL;
+
+            if(m_dqLocal.pop(_item)) return _item;
+
+            // move a batch from the inbox to the local deque, the rest can be stolen
+            for(int i = 0; i < MN_THREAD_CONFIG_WORKQUEUE_STEALING_BATCH; i++) {
+                if(_item != NULL && m_dqLocal.size() >= m_dqLocal.length()) break;
+
+                work_queue_item* _next = NULL;
+
+                if(!m_qInbox.try_pop(_next)) break;
+
+                if(_item == NULL)
+                    _item = _next;
+                else
+                    m_dqLocal.push(_next);
+            }
+            if(_item != NULL) return _item;
+
+            if(m_parentWorkQueue->steal_for(m_uiIndex, _item)) {
+                m_uiStolen.fetch_add(1, memory_order::Relaxed);
+                return _item;
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::execute
+        //-----------------------------------
+        void work_queue_stealing_task::execute(work_queue_item* item) {
+            // a item that is not deleted by us can be gone after on_work
+            bool _delete = item->can_delete();
+
+            if(item->on_work())
+                m_uiExecuted.fetch_add(1, memory_order::Relaxed);
+            else
+                m_uiErrors.fetch_add(1, memory_order::Relaxed);
+
+            if (_delete) {
+                delete item;
+            }
+        }
+
+        //-----------------------------------
+        //  work_queue_stealing_task::on_task
+        //-----------------------------------
+        int work_queue_stealing_task::on_task() {
+            basic_task::on_task();
+
+            work_queue_item *work_item = NULL;
+
+            while ( m_parentWorkQueue->running() ) {
+                work_item = get_next_item();
+
+                if (work_item == NULL) {
+                    // set idle before the last look, a push_local that misses the flag is seen here
+                    m_bIdle.store(true);
+                    work_item = get_next_item();
+
+                    if(work_item == NULL)
+                        ulTaskNotifyTake(pdTRUE, MN_THREAD_CONFIG_WORKQUEUE_GETNEXTITEM_TIMEOUT);
+
+                    m_bIdle.store(false);
+
+                    if(work_item == NULL) continue;
+                }
+                execute(work_item);
+            }
+
+            return ERR_TASK_OK;
+        }
+
+
+        //-----------------------------------
+        //  constructor
+        //-----------------------------------
+        basic_work_queue_stealing::basic_work_queue_stealing( basic_task::priority uiPriority,
+                        uint16_t usStackDepth, uint8_t uiMaxWorkers)
+
+            : basic_work_queue(uiPriority, usStackDepth, 1), m_uiNextWorker(0) {
+
+            char name[32];
+
+            for (int i = 0; i < uiMaxWorkers; i++) {
+                sprintf(name, "work_steal_%d", i);
+
+                work_queue_stealing_task *pWorker = new work_queue_stealing_task(name,
+                                                                m_uiPriority,
+                                                                m_usStackDepth,
+                                                                this, i);
+
+                if(pWorker)
+                    m_Workers.push_back(pWorker);
+            }
+        }
+
+        //-----------------------------------
+        //  deconstructor
+        //-----------------------------------
+        basic_work_queue_stealing::~basic_work_queue_stealing() {
+            destroy();
+        }
+
+        //-----------------------------------
+        //  queue
+        //-----------------------------------
+        int basic_work_queue_stealing::queue(work_queue_item_t *work, unsigned int timeout) {
+            MN_UNUSED_VARIABLE(timeout);
+
+            uint8_t _num = get_num_worker();
+
+            if(work == NULL || _num == 0) return ERR_WORKQUEUE_ADD;
+
+            work_queue_stealing_task* _self = get_current_worker();
+
+            // a item from a worker, push to his own deque and let a idle sibling steal it
+            if(_self != NULL && _self->push_local(work)) {
+                mofw::atomic_thread_fence(memory_order::SeqCst);
+                wakeup_idle(_self);
+
+                return ERR_WORKQUEUE_OK;
+            }
+
+            uint32_t _start = m_uiNextWorker.fetch_add(1, memory_order::Relaxed);
+
+            for(uint8_t i = 0; i < _num; i++) {
+                work_queue_stealing_task* _worker = m_Workers[(_start + i) % _num];
+
+                if(_worker->post(work)) {
+                    _worker->wakeup();
+                    return ERR_WORKQUEUE_OK;
+                }
+            }
+            return ERR_WORKQUEUE_ADD;
+        }
+
+        //-----------------------------------
+        //  queue_bulk
+        //-----------------------------------
+        size_t basic_work_queue_stealing::queue_bulk(work_queue_item_t **works, size_t count) {
+            uint8_t _num = get_num_worker();
+            size_t _added = 0;
+
+            if(works == NULL || _num == 0) return 0;
+
+            size_t _chunk = (count + _num - 1) / _num;
+            uint32_t _start = m_uiNextWorker.fetch_add(1, memory_order::Relaxed);
+
+            // first pass: one chunk per worker, second pass: the rest to who has space
+            for(uint8_t _pass = 0; _pass < 2 && _added < count; _pass++) {
+                for(uint8_t i = 0; i < _num && _added < count; i++) {
+                    work_queue_stealing_task* _worker = m_Workers[(_start + i) % _num];
+
+                    size_t _want = (_pass == 0) ? mofw::min(_chunk, count - _added) : count - _added;
+                    size_t _posted = _worker->post_bulk(works + _added, _want);
+
+                    if(_posted > 0) {
+                        _added += _posted;
+                        _worker->wakeup();
+                    }
+                }
+            }
+            return _added;
+        }
+
+        //-----------------------------------
+        //  get_next_item
+        //-----------------------------------
+        work_queue_item* basic_work_queue_stealing::get_next_item(unsigned int timeout) {
+            MN_UNUSED_VARIABLE(timeout);
+
+            work_queue_item* _item = NULL;
+
+            for(uint8_t i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->steal(_item)) return _item;
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  steal_for
+        //-----------------------------------
+        bool basic_work_queue_stealing::steal_for(uint8_t uiThief, work_queue_item*& item) {
+            uint8_t _num = get_num_worker();
+
+            for(uint8_t i = 1; i < _num; i++) {
+                if(m_Workers[(uiThief + i) % _num]->steal(item)) return true;
+            }
+            return false;
+        }
+
+        //-----------------------------------
+        //  get_current_worker
+        //-----------------------------------
+        work_queue_stealing_task* basic_work_queue_stealing::get_current_worker() {
+            TaskHandle_t _current = xTaskGetCurrentTaskHandle();
+
+            for(uint8_t i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->get_handle() == _current) return m_Workers[i];
+            }
+            return NULL;
+        }
+
+        //-----------------------------------
+        //  wakeup_idle
+        //-----------------------------------
+        void basic_work_queue_stealing::wakeup_idle(work_queue_stealing_task* self) {
+            for(uint8_t i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i] != self && m_Workers[i]->is_idle()) {
+                    m_Workers[i]->wakeup();
+                    break;
+                }
+            }
+        }
+
+        //-----------------------------------
+        //  create_engine
+        //-----------------------------------
+        int basic_work_queue_stealing::create_engine(int iCore) {
+            automutx_t lock(m_ThreadStatus);
+
+            bool _errorOnCreate = false;
+            bool _oneNoError = false;
+
+            if(m_bRunning) {
+                return ERR_WORKQUEUE_ALREADYINIT;
+            }
+
+            m_bRunning = true;
+
+            int _first = (iCore >= 0 && iCore < portNUM_PROCESSORS) ? iCore : 0;
+
+            for(int i = 0; i < get_num_worker(); i++) {
+                if(m_Workers[i]->start( (_first + i) % portNUM_PROCESSORS ) != ERR_TASK_OK) {
+                    _errorOnCreate = true;
+                } else {
+                    _oneNoError = true;
+                }
+            }
+            if(!_oneNoError) {
+                return ERR_WORKQUEUE_CANTCREATE;
+            }
+            return _errorOnCreate ? ERR_WORKQUEUE_WARNING : ERR_WORKQUEUE_OK;
+        }
+
+        //-----------------------------------
+        //  destroy_engine
+        //-----------------------------------
+        void basic_work_queue_stealing::destroy_engine() {
+            for(int i = 0; i < get_num_worker(); i++) {
+                m_Workers[i]->wakeup();
+                m_Workers[i]->kill();
+            }
+            // the workers are gone, no one else use the deques and inboxes
+            for(int i = 0; i < get_num_worker(); i++) {
+                work_queue_item* _item = NULL;
+
+                while(m_Workers[i]->steal(_item)) {
+                    if(_item->can_delete()) delete _item;
+                }
+                delete m_Workers[i];
+            }
+            m_Workers.clear();
+        }
+
+        //-----------------------------------
+        //  get_num_worker
+        //-----------------------------------
+        uint8_t basic_work_queue_stealing::get_num_worker() const  {
+            return m_Workers.size();
+        }
+
+        //-----------------------------------
+        //  is_worker
+        //-----------------------------------
+        bool basic_work_queue_stealing::is_worker() {
+            return get_current_worker() != NULL;
+        }
+
+        //-----------------------------------
+        //  get_worker_stats
+        //-----------------------------------
+        work_queue_stealing_task::stats basic_work_queue_stealing::get_worker_stats(uint8_t uiIndex) const {
+            work_queue_stealing_task::stats _stats = { 0, 0, 0 };
+
+            if(uiIndex < get_num_worker())
+                _stats = m_Workers[uiIndex]->get_stats();
+
+            return _stats;
+        }
+
+        //-----------------------------------
+        //  get_num_executed
+        //-----------------------------------
+        uint32_t basic_work_queue_stealing::get_num_executed() const {
+            uint32_t _executed = 0;
+
+            for(uint8_t i = 0; i < get_num_worker(); i++)
+                _executed += m_Workers[i]->get_stats().executed;
+
+            return _executed;
+        }
+    }
+}
@@ -56,6 +56,9 @@ namespace mofw {
                     break;
                 }
 
+                // a item that is not deleted by us can be gone after on_work
+                bool _delete = work_item->can_delete();
+
                 m_parentWorkQueue->m_ThreadStatus.lock();
 
                     if(work_item->on_work())
@@ -65,7 +68,7 @@ namespace mofw {
 
                 m_parentWorkQueue->m_ThreadStatus.unlock();
 
-                if (work_item->can_delete()) {
+                if (_delete) {
                     delete work_item; work_item = NULL;
                 }
             }
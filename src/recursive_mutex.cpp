@@ -52,7 +52,14 @@ namespace mofw {
     //-----------------------------------
     int basic_recursive_mutex::lock(unsigned int timeout) {
 
-        if(xSemaphoreTakeRecursive((QueueHandle_t)m_pSpinlock, timeout) != pdTRUE) {
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+        BaseType_t success = m_lockProbe.take(this, timeout, [this](TickType_t ticks) {
+            return xSemaphoreTakeRecursive((QueueHandle_t)m_pSpinlock, ticks); });
+    #else
+        BaseType_t success = xSemaphoreTakeRecursive((QueueHandle_t)m_pSpinlock, timeout);
+    #endif
+
+        if(success != pdTRUE) {
             return ERR_MUTEX_LOCK;
         }
         m_isLocked = true;
@@ -63,10 +70,12 @@ namespace mofw {
     //  unlock
     //-----------------------------------
     int basic_recursive_mutex::unlock() {
-
         if(xSemaphoreGiveRecursive((QueueHandle_t)m_pSpinlock) != pdTRUE) {
             return ERR_MUTEX_UNLOCK;
         }
+    #if MN_THREAD_CONFIG_LOCK_PROFILING == MN_THREAD_CONFIG_YES
+        m_lockProbe.released();
+    #endif
         m_isLocked = false;
         return ERR_MUTEX_OK;
     }
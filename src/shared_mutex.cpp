@@ -0,0 +1,202 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/semphr.h>
+#include <freertos/task.h>
+#include <time.h>
+
+#include "shared_mutex.hpp"
+
+namespace mofw {
+    //-----------------------------------
+    //  construtor
+    //-----------------------------------
+    basic_shared_mutex::basic_shared_mutex()
+        : m_uiState(0), m_pGuard(NULL), m_pReadGate(NULL), m_pWriteGate(NULL),
+          m_uiReadWaiters(0), m_uiWriteWaiters(0), m_iCreateErrorCode(ERR_MUTEX_OK) {
+
+    #if( configSUPPORT_STATIC_ALLOCATION == 1 )
+        m_pGuard = xSemaphoreCreateMutexStatic(&m_GuardBuffer);
+        m_pReadGate = xSemaphoreCreateCountingStatic(MN_THREAD_CONFIG_CSEMAPHORE_MAX_COUNT, 0,
+                                                     &m_ReadGateBuffer);
+        m_pWriteGate = xSemaphoreCreateCountingStatic(MN_THREAD_CONFIG_CSEMAPHORE_MAX_COUNT, 0,
+                                                      &m_WriteGateBuffer);
+    #else
+        m_pGuard = xSemaphoreCreateMutex();
+        m_pReadGate = xSemaphoreCreateCounting(MN_THREAD_CONFIG_CSEMAPHORE_MAX_COUNT, 0);
+        m_pWriteGate = xSemaphoreCreateCounting(MN_THREAD_CONFIG_CSEMAPHORE_MAX_COUNT, 0);
+    #endif
+
+        if (!is_initialized()) {
+            MN_THROW_LOCK_EXP(ERR_MUTEX_CANTCREATEMUTEX);
+        }
+    }
+
+    //-----------------------------------
+    //  deconstrutor
+    //-----------------------------------
+    basic_shared_mutex::~basic_shared_mutex() {
+        if (m_pGuard != NULL) vSemaphoreDelete(m_pGuard);
+        if (m_pReadGate != NULL) vSemaphoreDelete(m_pReadGate);
+        if (m_pWriteGate != NULL) vSemaphoreDelete(m_pWriteGate);
+    }
+
+    //-----------------------------------
+    //  time_lock
+    //-----------------------------------
+    int basic_shared_mutex::time_lock(const struct timespec *timeout) {
+        struct timespec currtime;
+        clock_gettime(CLOCK_REALTIME, &currtime);
+
+        TickType_t _time = ((timeout->tv_sec - currtime.tv_sec)*1000 +
+                          (timeout->tv_nsec - currtime.tv_nsec)/1000000)/portTICK_PERIOD_MS;
+
+        return lock(_time);
+    }
+
+    //-----------------------------------
+    //  time_lock_shared
+    //-----------------------------------
+    int basic_shared_mutex::time_lock_shared(const struct timespec *timeout) {
+        struct timespec currtime;
+        clock_gettime(CLOCK_REALTIME, &currtime);
+
+        TickType_t _time = ((timeout->tv_sec - currtime.tv_sec)*1000 +
+                          (timeout->tv_nsec - currtime.tv_nsec)/1000000)/portTICK_PERIOD_MS;
+
+        return lock_shared(_time);
+    }
+
+    //-----------------------------------
+    //  try_acquire
+    //-----------------------------------
+    bool basic_shared_mutex::try_acquire(lock_mode mode) {
+        switch(mode) {
+            case mode_read:     return try_acquire_read();
+            case mode_write:    return try_acquire_write();
+            case mode_upgrade:  return try_acquire_upgrade();
+            case mode_convert:  return try_convert_upgrade();
+        }
+        return false;
+    }
+
+    //-----------------------------------
+    //  lock_slow
+    //-----------------------------------
+    int basic_shared_mutex::lock_slow(lock_mode mode, unsigned int timeout) {
+        if (xPortInIsrContext()) return ERR_MUTEX_LOCK;
+
+        // Readers and upgraders wait on the read gate, writers and converting upgraders
+        // on the write gate
+        bool _reader = (mode == mode_read) || (mode == mode_upgrade);
+        void* _gate = _reader ? m_pReadGate : m_pWriteGate;
+
+        TickType_t _start = xTaskGetTickCount();
+        TickType_t _wait = timeout;
+        int _ret = ERR_MUTEX_LOCK;
+
+        if(xSemaphoreTake(m_pGuard, portMAX_DELAY) != pdTRUE)
+            return ERR_MUTEX_LOCK;
+
+        // Register first, then try: a unlock after the try sees the waiting flag
+        if(_reader) m_uiReadWaiters++; else m_uiWriteWaiters++;
+        update_waiting();
+
+        for(;;) {
+            if(try_acquire(mode)) { _ret = ERR_MUTEX_OK; break; }
+            if(_wait == 0) break;
+
+            xSemaphoreGive(m_pGuard);
+            xSemaphoreTake(_gate, _wait);
+            xSemaphoreTake(m_pGuard, portMAX_DELAY);
+
+            if(timeout != portMAX_DELAY) {
+                TickType_t _elapsed = xTaskGetTickCount() - _start;
+                _wait = (_elapsed >= timeout) ? 0 : timeout - _elapsed;
+            }
+        }
+
+        if(_reader) m_uiReadWaiters--; else m_uiWriteWaiters--;
+        update_waiting();
+
+        // A writer that gives up can unblock the readers
+        if(_ret != ERR_MUTEX_OK) notify();
+
+        xSemaphoreGive(m_pGuard);
+        return _ret;
+    }
+
+    //-----------------------------------
+    //  update_waiting
+    //-----------------------------------
+    void basic_shared_mutex::update_waiting() {
+        if(m_uiWriteWaiters > 0) m_uiState.fetch_or(state_writer_waiting);
+        else m_uiState.fetch_and(~state_writer_waiting);
+
+        if(m_uiReadWaiters > 0) m_uiState.fetch_or(state_readers_waiting);
+        else m_uiState.fetch_and(~state_readers_waiting);
+    }
+
+    //-----------------------------------
+    //  notify
+    //-----------------------------------
+    void basic_shared_mutex::notify() {
+        void* _gate = m_pWriteGate;
+        uint32_t _waiters = m_uiWriteWaiters;
+
+        // Writer preference: the readers only, when no writer waits
+        if(_waiters == 0) {
+            _gate = m_pReadGate;
+            _waiters = m_uiReadWaiters;
+        }
+        // The waiters retry after each wake up, so a not taken give from the last notify
+        // counts for one of them
+        for(uint32_t i = uxSemaphoreGetCount(_gate); i < _waiters; i++) {
+            if(xSemaphoreGive(_gate) != pdTRUE) break;
+        }
+    }
+
+    //-----------------------------------
+    //  wake
+    //-----------------------------------
+    void basic_shared_mutex::wake() {
+        if (xPortInIsrContext()) return;
+
+        xSemaphoreTake(m_pGuard, portMAX_DELAY);
+        notify();
+        xSemaphoreGive(m_pGuard);
+    }
+
+    //-----------------------------------
+    //  downgrade
+    //-----------------------------------
+    int basic_shared_mutex::downgrade(uint32_t from, uint32_t to) {
+        uint32_t _state = m_uiState.load(memory_order::Relaxed);
+
+        do {
+            if( (_state & from) == 0) return ERR_MUTEX_UNLOCK;
+        } while(!m_uiState.compare_exchange_weak(_state, (_state & ~from) + to,
+                                                 memory_order::Release));
+
+        if(_state & (state_writer_waiting | state_readers_waiting)) wake();
+
+        return ERR_MUTEX_OK;
+    }
+}
@@ -22,12 +22,15 @@
 
 
 #include <stdio.h>
+#include <string.h>
 #include <esp_log.h>
+#include <esp_timer.h>
 
 #include "task_utils.hpp"
 #include "task.hpp"
 #include "task_list.hpp"
 #include "atomic_counter.hpp"
+#include "atomic.hpp"
 
 #define EVENTGROUP_BIT_JOINABLE (1 << 0)
 #define EVENTGROUP_BIT_STARTED	(1 << 2)
@@ -43,7 +46,7 @@ namespace mofw {
   //-----------------------------------
   //  construtor
   //-----------------------------------
-  basic_task::basic_task(std::string strName, basic_task::priority uiPriority,
+  basic_task::basic_task(string_view strName, basic_task::priority uiPriority,
       unsigned short  usStackDepth) noexcept
         : m_runningMutex(),
           m_contextMutext(),
@@ -56,7 +59,11 @@ namespace mofw {
           m_iID(0),
           m_iCore(-1),
           m_pHandle(NULL),
-          m_eventGroup(strName.c_str()),
+          m_iListSlot(-1),
+        #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+          m_uiListPins(0),
+        #endif
+          m_eventGroup(m_strName.c_str()),
           m_waitSem(),
           m_ltMessageQueueLock(),
           m_qeMessageQueue(MN_THREAD_CONFIG_MSGTASK_MAX_MESSAGES, sizeof(task_message*)),
@@ -66,12 +73,13 @@ namespace mofw {
   //  deconstrutor
   //-----------------------------------
   basic_task::~basic_task() {
-    if(m_pHandle != NULL)
-      vTaskDelete(m_pHandle);
-
   #if MN_THREAD_CONFIG_ADD_TASK_TO_TASK_LIST == MN_THREAD_CONFIG_YES
+    // first remove, a reader of the list can use the handle until then
     basic_task_list::instance().remove_task(this);
   #endif
+
+    if(m_pHandle != NULL)
+      vTaskDelete(m_pHandle);
   }
 
 
@@ -244,7 +252,7 @@ namespace mofw {
   //-----------------------------------
   //  get_name
   //-----------------------------------
-  std::string basic_task::get_name() {
+  string_view basic_task::get_name() {
     autolock_t autolock(m_runningMutex);
 
     return m_strName;
@@ -377,6 +385,13 @@ namespace mofw {
     	// set the started bit
 		esp_task->m_eventGroup.set(EVENTGROUP_BIT_STARTED);
 
+	#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+		// from now the trace hooks count this task, the task is running
+		esp_task->m_profCounters.switch_in_us = (uint32_t)esp_timer_get_time();
+		vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TASK_PROFILING_TLS_INDEX,
+			&esp_task->m_profCounters);
+	#endif
+
 		// set running
 		esp_task->m_runningMutex.lock();
 		esp_task->m_continuemutex.lock();
@@ -393,6 +408,9 @@ namespace mofw {
 		esp_task->m_runningMutex.lock();
 		esp_task->m_bRunning = false;
 		esp_task->m_retval = ret;
+	#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+		vTaskSetThreadLocalStoragePointer(NULL, MN_THREAD_CONFIG_TASK_PROFILING_TLS_INDEX, NULL);
+	#endif
 		vTaskDelete(esp_task->m_pHandle);
 		esp_task->m_pHandle = 0;
 		esp_task->m_runningMutex.unlock();
@@ -438,6 +456,11 @@ namespace mofw {
   void basic_task::post_msg(task_message* msg, unsigned int timeout) {
       automutx_t lock(m_ltMessageQueueLock);
       m_qeMessageQueue.enqueue(msg, timeout);
+
+  #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+      unsigned int _depth = m_qeMessageQueue.get_num_items();
+      if(_depth > m_profCounters.queue_max) m_profCounters.queue_max = _depth;
+  #endif
       m_cvMessage.signal();
   }
 
@@ -456,4 +479,41 @@ namespace mofw {
     return !m_qeMessageQueue.is_empty();
   }
 
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+  //-----------------------------------
+  //  get_profile
+  //-----------------------------------
+  bool basic_task::get_profile(task_profile& profile) {
+    // the fields direct and not with the accessors, that lock m_runningMutex:
+    // the profiler must not block on the mutex of a profiled task
+    native_handle_type _handle = m_pHandle;
+    if(_handle == NULL) return false;
+
+    uint32_t _seq;
+    do {
+      while( (_seq = m_profCounters.seq) & 1 ) { }
+      mofw::atomic_thread_fence(memory_order::Acquire);
+
+      profile.cpu_us = m_profCounters.cpu_us;
+      profile.switches = m_profCounters.switches;
+      profile.latency_max_us = m_profCounters.latency_max_us;
+      profile.latency_avg_us = (m_profCounters.wakeups == 0) ? 0 :
+        m_profCounters.latency_sum_us / m_profCounters.wakeups;
+
+      mofw::atomic_thread_fence(memory_order::Acquire);
+    } while(_seq != m_profCounters.seq);
+
+    profile.id = m_iID;
+    profile.core = m_iCore;
+    profile.stack_free = uxTaskGetStackHighWaterMark(_handle);
+    profile.queue_depth = m_qeMessageQueue.get_num_items();
+    profile.queue_max = m_profCounters.queue_max;
+
+    strncpy(profile.name, m_strName.c_str(), sizeof(profile.name) - 1);
+    profile.name[sizeof(profile.name) - 1] = '\0';
+
+    return true;
+  }
+#endif
+
 }
@@ -17,8 +17,13 @@
 */
 #include "config.hpp"
 
+#include <string.h>
+
 #include "task.hpp"
 #include "task_list.hpp"
+#include "hash.hpp"
+
+#define TASK_LIST_INDEX_MASK (basic_task_list::index_size - 1)
 
 namespace mofw {
     basic_task_list* basic_task_list::m_pInstance = NULL;
@@ -28,38 +33,111 @@ namespace mofw {
     //  construtor
     //-----------------------------------
     basic_task_list::basic_task_list()
-        : m_pLock(), m_mapTaskOnCore() {  }
+        : m_uiSequence(0), m_szCount(0), m_szFree(capacity) {
+
+        m_muxWriter = portMUX_INITIALIZER_UNLOCKED;
+        memset(m_aEntrys, 0, sizeof(m_aEntrys));
+
+        // the lowest entry on top
+        for(size_t i = 0; i < capacity; i++)
+            m_aFree[i] = (int16_t)(capacity - 1 - i);
+
+        for(size_t i = 0; i < index_size; i++)
+            m_aIdIndex[i] = m_aNameIndex[i] = -1;
+    }
 
     //-----------------------------------
     //  add_task
     //-----------------------------------
-    void basic_task_list::add_task(basic_task* task) {
-        autolock_t lock(m_pLock);
+    bool basic_task_list::add_task(basic_task* task) {
+        if(task == NULL) return false;
 
-        if(task == NULL) return;
+        int32_t _id = task->get_id();
+        int32_t _core = task->get_on_core();
+        const char* _name = task->m_strName.c_str();
+        uint32_t _hash = (uint32_t)task->m_strName.hash();
+
+        portENTER_CRITICAL_SAFE(&m_muxWriter);
+
+        int _old = task->m_iListSlot;
+        int _other = find_index(_id);
+
+        if( (_other >= 0 && _other != _old) || (_old < 0 && m_szCount >= capacity) ) {
+            portEXIT_CRITICAL_SAFE(&m_muxWriter);
+            return false;
+        }
+        begin_write();
+
+        // restarted with a new id, the old entry is replaced
+        if(_old >= 0) erase_entry(_old);
+
+        int _idx = m_aFree[--m_szFree];
 
-        int core = task->get_on_core();
-        m_mapTaskOnCore[core].push_front(task);
+        entry& _entry = m_aEntrys[_idx];
+        _entry.task = task;
+        _entry.id = _id;
+        _entry.core = _core;
+        _entry.name_hash = _hash;
+
+        strncpy(_entry.name, _name, MN_THREAD_CONFIG_TASK_LIST_NAMELEN - 1);
+        _entry.name[MN_THREAD_CONFIG_TASK_LIST_NAMELEN - 1] = '\0';
+
+        index_insert(m_aIdIndex, (uint32_t)_id, _idx);
+        index_insert(m_aNameIndex, _hash, _idx);
+
+        task->m_iListSlot = (int16_t)_idx;
+        m_szCount++;
+
+        end_write();
+        portEXIT_CRITICAL_SAFE(&m_muxWriter);
+
+        return true;
     }
 
     //-----------------------------------
     //  remove_task
     //-----------------------------------
     void basic_task_list::remove_task(basic_task* task) {
-        autolock_t lock(m_pLock);
-
         if(task == NULL) return;
 
-        int core = task->get_on_core();
-        m_mapTaskOnCore[core].remove(task);
+        portENTER_CRITICAL_SAFE(&m_muxWriter);
+
+        // by the entry of the task, the id of the task can be changed
+        int _idx = task->m_iListSlot;
+
+        if(_idx >= 0) {
+            begin_write();
+            erase_entry(_idx);
+            end_write();
+        }
+        portEXIT_CRITICAL_SAFE(&m_muxWriter);
+
+    #if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+        // a get_profile can read the task, the task is deleted after this
+        for(;;) {
+            portENTER_CRITICAL_SAFE(&m_muxWriter);
+            uint16_t _pins = task->m_uiListPins;
+            portEXIT_CRITICAL_SAFE(&m_muxWriter);
+
+            if(_pins == 0) break;
+            vTaskDelay(1);
+        }
+    #endif
     }
 
     //-----------------------------------
     //  get_task
     //-----------------------------------
     basic_task* basic_task_list::get_task(int id) {
-        basic_task* _ret = get_task(0);
-        if(_ret == NULL) _ret = get_task(1);
+        basic_task* _ret = NULL;
+        uint32_t _seq;
+
+        do {
+            _seq = begin_read();
+
+            int _idx = find_index(id);
+            _ret = (_idx < 0) ? NULL : m_aEntrys[_idx].task;
+        } while(!end_read(_seq));
 
         return _ret;
     }
@@ -67,47 +145,212 @@ namespace mofw {
     //-----------------------------------
     //  get_task
     //-----------------------------------
-    basic_task* basic_task_list::get_task(std::string name) {
-        basic_task* _ret = get_task(name);
+    basic_task* basic_task_list::get_task(string_view name) {
+        uint32_t _hash = (uint32_t)name.hash();
+        basic_task* _ret = NULL;
+        uint32_t _seq;
+
+        do {
+            _seq = begin_read();
+
+            int _idx = find_index(name, _hash);
+            _ret = (_idx < 0) ? NULL : m_aEntrys[_idx].task;
+        } while(!end_read(_seq));
 
         return _ret;
     }
 
     //-----------------------------------
-    //  get_task
+    //  get_num_tasks
     //-----------------------------------
-    basic_task* basic_task_list::get_task(int core, int id) {
-        autolock_t lock(m_pLock);
+    size_t basic_task_list::get_num_tasks() {
+        size_t _ret;
+        uint32_t _seq;
 
-        basic_task* _retTask = NULL;
+        do {
+            _seq = begin_read();
+            _ret = m_szCount;
+        } while(!end_read(_seq));
 
-        for(std::list<basic_task*>::iterator i = m_mapTaskOnCore[core].begin();
-            i != m_mapTaskOnCore[core].end(); i++) {
+        return _ret;
+    }
 
-            if( (*i)->get_id() == id ) {
-                _retTask = (*i);
-                break;
+    //-----------------------------------
+    //  snapshot
+    //-----------------------------------
+    size_t basic_task_list::snapshot(entry* pEntrys, size_t maxEntrys, int core) {
+        if(pEntrys == NULL) return 0;
+
+        size_t _count;
+        uint32_t _seq;
+
+        do {
+            _seq = begin_read();
+            _count = 0;
+
+            for(size_t i = 0; i < capacity && _count < maxEntrys; i++) {
+                if(m_aEntrys[i].task == NULL) continue;
+                if(core != -1 && m_aEntrys[i].core != core) continue;
+
+                pEntrys[_count++] = m_aEntrys[i];
             }
+        } while(!end_read(_seq));
+
+        return _count;
+    }
+
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+    //-----------------------------------
+    //  get_profile
+    //-----------------------------------
+    bool basic_task_list::get_profile(int32_t id, task_profile& profile) {
+        portENTER_CRITICAL_SAFE(&m_muxWriter);
+
+        // only pin the task, the read can take time and must not disable the interrupts
+        int _idx = find_index(id);
+        basic_task* _task = (_idx < 0) ? NULL : m_aEntrys[_idx].task;
+
+        if(_task != NULL) _task->m_uiListPins++;
+
+        portEXIT_CRITICAL_SAFE(&m_muxWriter);
+
+        if(_task == NULL) return false;
+
+        bool _ret = _task->get_profile(profile);
+
+        portENTER_CRITICAL_SAFE(&m_muxWriter);
+        _task->m_uiListPins--;
+        portEXIT_CRITICAL_SAFE(&m_muxWriter);
+
+        return _ret;
+    }
+#endif
+
+    //-----------------------------------
+    //  find_index
+    //-----------------------------------
+    int basic_task_list::find_index(int32_t id) const {
+        size_t _pos = (uint32_t)id & TASK_LIST_INDEX_MASK;
+
+        for(size_t i = 0; i < index_size; i++) {
+            int _idx = m_aIdIndex[_pos];
+
+            if(_idx < 0) break;
+            if(m_aEntrys[_idx].id == id) return _idx;
+
+            _pos = (_pos + 1) & TASK_LIST_INDEX_MASK;
         }
-        return _retTask;
+        return -1;
     }
 
     //-----------------------------------
-    //  get_task
+    //  find_index
+    //-----------------------------------
+    int basic_task_list::find_index(string_view name, uint32_t hash) const {
+        name = name.substr(0, MN_THREAD_CONFIG_TASK_LIST_NAMELEN - 1);
+        size_t _pos = hash & TASK_LIST_INDEX_MASK;
+
+        for(size_t i = 0; i < index_size; i++) {
+            int _idx = m_aNameIndex[_pos];
+
+            if(_idx < 0) break;
+            if(m_aEntrys[_idx].name_hash == hash && name == m_aEntrys[_idx].name) return _idx;
+
+            _pos = (_pos + 1) & TASK_LIST_INDEX_MASK;
+        }
+        return -1;
+    }
+
+    //-----------------------------------
+    //  erase_entry
+    //-----------------------------------
+    void basic_task_list::erase_entry(int slot) {
+        entry& _entry = m_aEntrys[slot];
+
+        index_erase(m_aIdIndex, (uint32_t)_entry.id, slot);
+        index_erase(m_aNameIndex, _entry.name_hash, slot);
+
+        _entry.task->m_iListSlot = -1;
+        _entry.task = NULL;
+
+        m_aFree[m_szFree++] = (int16_t)slot;
+        m_szCount--;
+    }
+
+    //-----------------------------------
+    //  index_insert
+    //-----------------------------------
+    void basic_task_list::index_insert(int16_t* pIndex, uint32_t key, int slot) {
+        size_t _pos = key & TASK_LIST_INDEX_MASK;
+
+        // never full, the index has twice the entrys
+        while(pIndex[_pos] >= 0) _pos = (_pos + 1) & TASK_LIST_INDEX_MASK;
+
+        pIndex[_pos] = (int16_t)slot;
+    }
+
+    //-----------------------------------
+    //  index_erase
     //-----------------------------------
-    basic_task* basic_task_list::get_task(int core, std::string name) {
-        autolock_t lock(m_pLock);
+    void basic_task_list::index_erase(int16_t* pIndex, uint32_t key, int slot) {
+        size_t _free = key & TASK_LIST_INDEX_MASK;
 
-        basic_task* _retTask = NULL;
+        while(pIndex[_free] != slot) {
+            if(pIndex[_free] < 0) return;
+            _free = (_free + 1) & TASK_LIST_INDEX_MASK;
+        }
+
+        // backward shift for linear probing, no tombstones
+        size_t _next = _free;
 
-        for(std::list<basic_task*>::iterator i = m_mapTaskOnCore[core].begin();
-            i != m_mapTaskOnCore[core].end(); i++) {
+        for(;;) {
+            _next = (_next + 1) & TASK_LIST_INDEX_MASK;
+            if(pIndex[_next] < 0) break;
 
-            if( (*i)->get_name() == name ) {
-                _retTask = (*i);
-                break;
+            size_t _home = index_key(pIndex, pIndex[_next]) & TASK_LIST_INDEX_MASK;
+            bool _move = (_free <= _next) ? (_home <= _free || _home > _next)
+                                          : (_home <= _free && _home > _next);
+            if(_move) {
+                pIndex[_free] = pIndex[_next];
+                _free = _next;
             }
         }
-        return _retTask;
+        pIndex[_free] = -1;
+    }
+
+    //-----------------------------------
+    //  begin_write
+    //-----------------------------------
+    void basic_task_list::begin_write() {
+        m_uiSequence.store(m_uiSequence.load(memory_order::Relaxed) + 1, memory_order::Relaxed);
+        mofw::atomic_thread_fence(memory_order::Release);
+    }
+
+    //-----------------------------------
+    //  end_write
+    //-----------------------------------
+    void basic_task_list::end_write() {
+        m_uiSequence.store(m_uiSequence.load(memory_order::Relaxed) + 1, memory_order::Release);
+    }
+
+    //-----------------------------------
+    //  begin_read
+    //-----------------------------------
+    uint32_t basic_task_list::begin_read() const {
+        uint32_t _seq;
+
+        // odd: a writer is active on the other core, the write section is short
+        while( (_seq = m_uiSequence.load(memory_order::Acquire)) & 1 ) { }
+
+        return _seq;
+    }
+
+    //-----------------------------------
+    //  end_read
+    //-----------------------------------
+    bool basic_task_list::end_read(uint32_t seq) const {
+        mofw::atomic_thread_fence(memory_order::Acquire);
+
+        return m_uiSequence.load(memory_order::Relaxed) == seq;
     }
 }
@@ -0,0 +1,111 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
+
+#include "task_profile.hpp"
+#include "atomic.hpp"
+
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+
+#if configNUM_THREAD_LOCAL_STORAGE_POINTERS < 1
+    #error "the task profiling needs a thread local storage pointer (configNUM_THREAD_LOCAL_STORAGE_POINTERS)"
+#endif
+
+namespace mofw {
+    namespace internal {
+        /**
+         * Get the profile counters of the task, NULL for a task that is not a basic_task.
+         * Call only from the trace hooks, NULL is the current task.
+         */
+        inline task_profile_counters* get_profile_counters(TaskHandle_t handle) {
+            return static_cast<task_profile_counters*>(
+                pvTaskGetThreadLocalStoragePointer(handle, MN_THREAD_CONFIG_TASK_PROFILING_TLS_INDEX) );
+        }
+
+        inline void profile_begin_write(task_profile_counters* counters) {
+            counters->seq = counters->seq + 1;
+            mofw::atomic_thread_fence(memory_order::Release);
+        }
+
+        inline void profile_end_write(task_profile_counters* counters) {
+            mofw::atomic_thread_fence(memory_order::Release);
+            counters->seq = counters->seq + 1;
+        }
+    }
+}
+
+//-----------------------------------
+//  mn_profile_task_switched_in
+//-----------------------------------
+void mn_profile_task_switched_in(void) {
+    mofw::task_profile_counters* _counters = mofw::internal::get_profile_counters(NULL);
+    if(_counters == NULL) return;
+
+    uint32_t _now = (uint32_t)esp_timer_get_time();
+
+    mofw::internal::profile_begin_write(_counters);
+
+    _counters->switch_in_us = _now;
+    _counters->switches = _counters->switches + 1;
+
+    uint32_t _ready = _counters->ready_us;
+
+    if(_ready != 0) {
+        uint32_t _latency = _now - _ready;
+
+        _counters->ready_us = 0;
+        _counters->latency_sum_us = _counters->latency_sum_us + _latency;
+        _counters->wakeups = _counters->wakeups + 1;
+
+        if(_latency > _counters->latency_max_us)
+            _counters->latency_max_us = _latency;
+    }
+    mofw::internal::profile_end_write(_counters);
+}
+
+//-----------------------------------
+//  mn_profile_task_switched_out
+//-----------------------------------
+void mn_profile_task_switched_out(void) {
+    mofw::task_profile_counters* _counters = mofw::internal::get_profile_counters(NULL);
+    if(_counters == NULL) return;
+
+    uint32_t _now = (uint32_t)esp_timer_get_time();
+
+    mofw::internal::profile_begin_write(_counters);
+    _counters->cpu_us = _counters->cpu_us + (uint32_t)(_now - _counters->switch_in_us);
+    mofw::internal::profile_end_write(_counters);
+}
+
+//-----------------------------------
+//  mn_profile_task_ready
+//-----------------------------------
+void mn_profile_task_ready(void* pxTCB) {
+    mofw::task_profile_counters* _counters =
+        mofw::internal::get_profile_counters(static_cast<TaskHandle_t>(pxTCB));
+
+    // 0 is no pending wake up
+    if(_counters != NULL && _counters->ready_us == 0)
+        _counters->ready_us = (uint32_t)esp_timer_get_time() | 1;
+}
+
+#endif // MN_THREAD_CONFIG_TASK_PROFILING
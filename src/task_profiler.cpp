@@ -0,0 +1,166 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#if MN_THREAD_CONFIG_TASK_PROFILING == MN_THREAD_CONFIG_YES
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "task_profiler.hpp"
+#include "micros.hpp"
+
+namespace mofw {
+    //-----------------------------------
+    //  basic_task_profiler::basic_task_profiler
+    //-----------------------------------
+    basic_task_profiler::basic_task_profiler(unsigned int uiPeriod, format eFormat,
+        output_fn fnOutput, void* pUser)
+
+        : basic_task("task_profiler", MN_THREAD_CONFIG_TASK_PROFILER_PRIORITY,
+                     MN_THREAD_CONFIG_TASK_PROFILER_STACKSIZE),
+          m_uiPeriod(uiPeriod == 0 ? 1 : uiPeriod),
+          m_eFormat(eFormat),
+          m_fnOutput(fnOutput),
+          m_pUser(pUser),
+          m_mtxSnapshot() { }
+
+    //-----------------------------------
+    //  basic_task_profiler::snapshot
+    //-----------------------------------
+    size_t basic_task_profiler::snapshot(task_profile* pProfiles, size_t maxProfiles, int core) {
+        automutx_t lock(m_mtxSnapshot);
+        return take_snapshot(pProfiles, maxProfiles, core);
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::take_snapshot
+    //-----------------------------------
+    size_t basic_task_profiler::take_snapshot(task_profile* pProfiles, size_t maxProfiles, int core) {
+        basic_task_list& _list = basic_task_list::instance();
+
+        size_t _count = _list.snapshot(m_aEntrys, basic_task_list::capacity, core);
+        size_t _profiles = 0;
+
+        // by id and not by the task pointer of the snapshot, the task can be deleted since
+        for(size_t i = 0; i < _count && _profiles < maxProfiles; i++) {
+            if(_list.get_profile(m_aEntrys[i].id, pProfiles[_profiles]))
+                _profiles++;
+        }
+        return _profiles;
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::report
+    //-----------------------------------
+    void basic_task_profiler::report() {
+        automutx_t lock(m_mtxSnapshot);
+
+        uint32_t _time = (uint32_t)mofw::millis();
+        size_t _count = take_snapshot(m_aProfiles, basic_task_list::capacity, -1);
+
+        if(m_eFormat == format::Binary)
+            write_binary(_count, _time);
+        else
+            write_csv(_count, _time);
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::write
+    //-----------------------------------
+    void basic_task_profiler::write(const void* data, size_t size) {
+        if(m_fnOutput != NULL) {
+            m_fnOutput(data, size, m_pUser);
+        } else {
+            fwrite(data, 1, size, stdout);
+            fflush(stdout);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::write_csv_header
+    //-----------------------------------
+    void basic_task_profiler::write_csv_header() {
+        static const char _header[] = "time_ms,id,name,core,cpu_us,switches,stack_free,"
+                                      "latency_avg_us,latency_max_us,queue_depth,queue_max\n";
+        write(_header, sizeof(_header) - 1);
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::write_csv
+    //-----------------------------------
+    void basic_task_profiler::write_csv(size_t count, uint32_t time_ms) {
+        char _line[128];
+
+        for(size_t i = 0; i < count; i++) {
+            const task_profile& _p = m_aProfiles[i];
+
+            int _len = snprintf(_line, sizeof(_line),
+                "%" PRIu32 ",%" PRId32 ",%s,%" PRId32 ",%" PRIu64 ",%" PRIu32 ",%" PRIu32
+                ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 ",%" PRIu32 "\n",
+                time_ms, _p.id, _p.name, _p.core, _p.cpu_us, _p.switches, _p.stack_free,
+                _p.latency_avg_us, _p.latency_max_us, _p.queue_depth, _p.queue_max);
+
+            if(_len <= 0) continue;
+            if(_len >= (int)sizeof(_line)) _len = sizeof(_line) - 1;
+
+            write(_line, (size_t)_len);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::write_binary
+    //-----------------------------------
+    void basic_task_profiler::write_binary(size_t count, uint32_t time_ms) {
+        frame_header _header;
+
+        _header.magic = frame_magic;
+        _header.version = 1;
+        _header.count = (uint8_t)count;
+        _header.record_size = (uint16_t)sizeof(task_profile);
+        _header.time_ms = time_ms;
+
+        write(&_header, sizeof(_header));
+
+        if(count > 0)
+            write(m_aProfiles, count * sizeof(task_profile));
+    }
+
+    //-----------------------------------
+    //  basic_task_profiler::on_task
+    //-----------------------------------
+    int basic_task_profiler::on_task() {
+        basic_task::on_task();
+
+        if(m_eFormat == format::CSV)
+            write_csv_header();
+
+        TickType_t _lastWake = xTaskGetTickCount();
+
+        while ( is_running() ) {
+            vTaskDelayUntil(&_lastWake, m_uiPeriod);
+            report();
+        }
+        return ERR_TASK_OK;
+    }
+}
+
+#endif // MN_THREAD_CONFIG_TASK_PROFILING
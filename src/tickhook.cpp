@@ -25,55 +25,62 @@
 
 #include "autolock.hpp"
 #include "tickhook.hpp"
-#include "micros.hpp"
+
+void vApplicationTickHook(void) {
+    // no instance() here, the ISR can not lock the instance mutex
+    if(mofw::base_tickhook::m_pInstance != NULL)
+        mofw::base_tickhook::m_pInstance->onApplicationTickHook();
+}
 
 namespace mofw {
     base_tickhook* base_tickhook::m_pInstance = NULL;
     mutex_t  base_tickhook::m_staticInstanceMux;
 
-
-    void vApplicationTickHook(void) {
-        base_tickhook::instance().onApplicationTickHook();
-    }
-
     base_tickhook::base_tickhook()
-        : m_listHooks((unsigned int)MN_THREAD_CONFIG_TICKHOOK_MAXENTRYS, (unsigned int)sizeof(base_tickhook_entry*) ),
-          m_listToAdd( (unsigned int)MN_THREAD_CONFIG_TICKHOOK_MAXENTRYS, (unsigned int)sizeof(base_tickhook_entry*) ) {
-
-        m_listHooks.create();
-        m_listToAdd.create();
+        : m_iCurrent(0), m_pCurrent(NULL), m_bCurrentRemoved(false) {
 
-        reset();
+        m_muxWheel = portMUX_INITIALIZER_UNLOCKED;
     }
 
     /*--------------------------------------
     * onApplicationTickHook()
     * -------------------------------------*/
     void base_tickhook::onApplicationTickHook() {
-        base_tickhook_entry *entry = 0;
-        unsigned int time = 0;
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
 
-        m_iCurrent++;
+        unsigned int _tick = ++m_iCurrent;
+        // only the entrys in the current slot are touched
+        m_wheelHooks.begin_advance();
 
-        if(m_listHooks.is_empty()) return;
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
 
-        while( (dequeue(entry) == ERR_QUEUE_OK) ) {
+        auto _to_current = [this](base_tickhook_entry* entry) {
+            m_pCurrent = entry;
+            m_bCurrentRemoved = false;
+        };
+        bool _more = true;
 
-            time = entry->get_ticks();
+        // each critical section moves down or takes one entry, the hooks run outside
+        while(_more) {
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
+            _more = m_wheelHooks.advance_one(_to_current);
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
 
-            if(entry->is_ready()) {
+            base_tickhook_entry* _entry = m_pCurrent;
+            if(_entry == NULL) continue;
 
-                if( (time == 0) || ((m_iCurrent % time) == 0) )  {
-                    entry->onTick(m_iCurrent);
+            bool _ready = _entry->m_bReady;
+            if(_ready) _entry->onTick(_tick);
 
-                    if(!entry->is_oneshoted())
-                        m_listToAdd.enqueue(entry);
-                }
-            }
-        }
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
 
+            // a not ready entry stays registered, a oneshot entry runs one time
+            if(!m_bCurrentRemoved && (!_ready || !_entry->m_bOneShoted))
+                m_wheelHooks.insert(_entry, _entry->m_iTicksToCall);
 
-        swap();
+            m_pCurrent = NULL;
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
+        }
     }
 
     /*--------------------------------------
@@ -81,7 +88,7 @@ namespace mofw {
     * -------------------------------------*/
     base_tickhook& base_tickhook::instance() {
         automutx_t lock(m_staticInstanceMux);
-        if(m_pInstance != NULL)
+        if(m_pInstance == NULL)
             m_pInstance = new base_tickhook();
         return *m_pInstance;
     }
@@ -89,114 +96,70 @@ namespace mofw {
     * enqueue()
     * -------------------------------------*/
     int base_tickhook::enqueue(base_tickhook_entry* entry, unsigned int timeout) {
-        if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
-
-        TickType_t xTicksEnd = xTaskGetTickCount() + timeout;
-        TickType_t xTicksRemaining = timeout;
-        int _ret = ERR_MNTHREAD_TIMEOUT;
-
-        while(xTicksRemaining <= timeout) {
-        if(m_mutexAdd.lock(xTicksRemaining) != NO_ERROR){
-                    break;
-            }
-
-            _ret = m_listHooks.enqueue(entry, xTicksRemaining);
-
-            if(_ret == ERR_QUEUE_OK) {
-                m_mutexAdd.unlock();
-                break;
-            }
+        ((void)timeout);
 
+        if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
 
-            if (timeout != portMAX_DELAY) {
-                xTicksRemaining = xTicksEnd - xTaskGetTickCount();
-            }
-            m_mutexAdd.unlock();
-        }
+        // get_ticks locks the mutex of the entry, not in the critical section
+        unsigned int _ticks = entry->get_ticks();
 
-        // Old with out RTOS timeout support
-        /*m_mutexAdd.lock();
-        m_listHooks.enqueue(entry, timeout);
-        m_mutexAdd.unlock();*/
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        bool _ret = m_wheelHooks.insert(entry, _ticks);
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
 
-        return _ret;
+        return _ret ? ERR_TICKHOOK_OK : ERR_TICKHOOK_ADD;
     }
 
     /*--------------------------------------
     * dequeue()
     * -------------------------------------*/
     int base_tickhook::dequeue(base_tickhook_entry* entry, unsigned int timeout) {
-        if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
-
-        TickType_t xTicksEnd = xTaskGetTickCount() + timeout;
-        TickType_t xTicksRemaining = timeout;
-        int _ret = ERR_MNTHREAD_TIMEOUT;
-
-        while(xTicksRemaining <= timeout) {
-        if(m_mutexAdd.lock(xTicksRemaining) != NO_ERROR){
-                    break;
-            }
-
-            _ret = m_listHooks.dequeue(entry, xTicksRemaining);
+        ((void)timeout);
 
-            if(_ret == ERR_QUEUE_OK) {
-                m_mutexAdd.unlock();
-                break;
-            }
+        if(entry == NULL) return ERR_TICKHOOK_ENTRY_NULL;
 
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        bool _ret = m_wheelHooks.erase(entry);
 
-            if (timeout != portMAX_DELAY) {
-                xTicksRemaining = xTicksEnd - xTaskGetTickCount();
-            }
-            m_mutexAdd.unlock();
+        // the hook runs now, it is not added again
+        if(!_ret && entry == m_pCurrent && !m_bCurrentRemoved) {
+            m_bCurrentRemoved = true;
+            _ret = true;
         }
-        return _ret;
-
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
 
-        //automutx_t lock(m_mutexAdd);
-        //m_listHooks.dequeue(entry, timeout);
+        return _ret ? ERR_TICKHOOK_OK : ERR_TICKHOOK_REMOVE;
     }
 
     /*--------------------------------------
     * clear()
     * -------------------------------------*/
     void base_tickhook::clear() {
-        automutx_t lock(m_mutexAdd);
-        m_listHooks.clear();
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        m_wheelHooks.clear();
+        if(m_pCurrent != NULL) m_bCurrentRemoved = true;
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
     }
     /*--------------------------------------
     * reset()
     * -------------------------------------*/
     void base_tickhook::reset() {
-        automutx_t lock(m_mutexAdd);
-
-        if(!m_listHooks.is_empty())
-            m_listHooks.clear();
-
-        if(!m_listToAdd.is_empty())
-            m_listToAdd.clear();
-
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        m_wheelHooks.reset();
+        if(m_pCurrent != NULL) m_bCurrentRemoved = true;
         m_iCurrent = 0;
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
     }
 
     /*--------------------------------------
     * count()
     * -------------------------------------*/
     unsigned int base_tickhook::count() {
-        return m_listHooks.get_num_items();
-    }
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        unsigned int _count = (unsigned int)m_wheelHooks.size();
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
 
-    /*--------------------------------------
-    * swap()
-    * -------------------------------------*/
-    void base_tickhook::swap() {
-        automutx_t lock(m_mutexAdd);
-
-        base_tickhook_entry *entry = 0;
-
-        while( (m_listToAdd.dequeue(entry) == ERR_QUEUE_OK) ) {
-            enqueue(entry);
-        }
+        return _count;
     }
 }
 
@@ -0,0 +1,283 @@
+/*
+*This file is part of the Mini Thread Library (https://github.com/RoseLeBlood/MiniThread ).
+*Copyright (c) 2021 Amber-Sophia Schroeck
+*
+*The Mini Thread Library is free software; you can redistribute it and/or modify
+*it under the terms of the GNU Lesser General Public License as published by
+*the Free Software Foundation, version 3, or (at your option) any later version.
+
+*The Mini Thread Library is distributed in the hope that it will be useful, but
+*WITHOUT ANY WARRANTY; without even the implied warranty of
+*MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+*General Public License for more details.
+*
+*You should have received a copy of the GNU Lesser General Public
+*License along with the Mini Thread  Library; if not, see
+*<https://www.gnu.org/licenses/>.
+*/
+#include "config.hpp"
+
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+#include "timer_service.hpp"
+
+namespace mofw {
+    //-----------------------------------
+    //  basic_service_timer::basic_service_timer
+    //-----------------------------------
+    basic_service_timer::basic_service_timer(basic_timer_service& service,
+        unsigned int uiPeriod, bool bIsOneShot)
+
+        : m_pService(&service),
+          m_pBatchNext(NULL),
+          m_ppBatchPrev(NULL),
+          m_uiPeriod(uiPeriod),
+          m_bIsOneShot(bIsOneShot),
+          m_bActive(false) { }
+
+    //-----------------------------------
+    //  basic_service_timer::~basic_service_timer
+    //-----------------------------------
+    basic_service_timer::~basic_service_timer() {
+        m_pService->cancel(this, true);
+    }
+
+    //-----------------------------------
+    //  basic_service_timer::active
+    //-----------------------------------
+    int basic_service_timer::active() {
+        m_pService->schedule(this, m_uiPeriod);
+        return ERR_TIMER_OK;
+    }
+
+    //-----------------------------------
+    //  basic_service_timer::inactive
+    //-----------------------------------
+    int basic_service_timer::inactive() {
+        m_pService->cancel(this, false);
+        return ERR_TIMER_OK;
+    }
+
+    //-----------------------------------
+    //  basic_service_timer::reset
+    //-----------------------------------
+    int basic_service_timer::reset() {
+        return active();
+    }
+
+    //-----------------------------------
+    //  basic_service_timer::set_period
+    //-----------------------------------
+    bool basic_service_timer::set_period(unsigned int uiNewPeriod) {
+        m_uiPeriod = uiNewPeriod;
+
+        if(m_bActive)
+            m_pService->schedule(this, m_uiPeriod);
+
+        return true;
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::basic_timer_service
+    //-----------------------------------
+    basic_timer_service::basic_timer_service(const char* strName,
+        basic_task::priority uiPriority, unsigned short usStackDepth)
+
+        : basic_task(strName, uiPriority, usStackDepth),
+          m_tLastTick(0),
+          m_tWakeup(0),
+          m_pBatch(NULL),
+          m_pCurrent(NULL),
+          m_uiFired(0) {
+
+        m_muxWheel = portMUX_INITIALIZER_UNLOCKED;
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::get_num_timers
+    //-----------------------------------
+    unsigned int basic_timer_service::get_num_timers() {
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        unsigned int _count = (unsigned int)m_wheelTimers.size();
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+        return _count;
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::get_num_fired
+    //-----------------------------------
+    uint32_t basic_timer_service::get_num_fired() {
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+        uint32_t _fired = m_uiFired;
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+        return _fired;
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::schedule
+    //-----------------------------------
+    void basic_timer_service::schedule(basic_service_timer* timer, unsigned int uiTicks) {
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+        m_wheelTimers.erase(timer);
+        unlink_batch(timer);
+
+        TickType_t _now = xTaskGetTickCount();
+
+        // the service sleeps when the wheel is empty, so the wheel time is old
+        bool _empty = m_wheelTimers.empty();
+        if(_empty) m_tLastTick += m_wheelTimers.skip(_now - m_tLastTick);
+
+        // the wheel time can be behind, when the service sleeps until the next expiry
+        timer->m_bActive = true;
+        m_wheelTimers.insert(timer, uiTicks + (_now - m_tLastTick));
+
+        // wake the service, when the timer expires before the service wakes up
+        bool _wakeup = _empty || (TickType_t)(m_tWakeup - _now) > uiTicks;
+
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+        TaskHandle_t _handle = get_handle();
+
+        if(_wakeup && _handle != NULL)
+            xTaskNotifyGive(_handle);
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::cancel
+    //-----------------------------------
+    void basic_timer_service::cancel(basic_service_timer* timer, bool bWait) {
+        portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+        m_wheelTimers.erase(timer);
+        unlink_batch(timer);
+        timer->m_bActive = false;
+
+        portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+        if(!bWait || xTaskGetCurrentTaskHandle() == get_handle()) return;
+
+        while(m_pCurrent == timer)
+            vTaskDelay(1);
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::unlink_batch
+    //-----------------------------------
+    void basic_timer_service::unlink_batch(basic_service_timer* timer) {
+        if(timer->m_ppBatchPrev == NULL) return;
+
+        *timer->m_ppBatchPrev = timer->m_pBatchNext;
+        if(timer->m_pBatchNext != NULL)
+            timer->m_pBatchNext->m_ppBatchPrev = timer->m_ppBatchPrev;
+
+        timer->m_pBatchNext = NULL;
+        timer->m_ppBatchPrev = NULL;
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::sync_time
+    //-----------------------------------
+    void basic_timer_service::sync_time() {
+        auto _to_batch = [this](basic_service_timer* timer) {
+            timer->m_pBatchNext = m_pBatch;
+            if(m_pBatch != NULL) m_pBatch->m_ppBatchPrev = &timer->m_pBatchNext;
+
+            timer->m_ppBatchPrev = &m_pBatch;
+            m_pBatch = timer;
+        };
+        bool _done = false;
+
+        // each critical section handles one tick start or one element, so the interrupts
+        // are never disabled for a whole cascade or batch
+        while(!_done) {
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+            if(!m_wheelTimers.advance_one(_to_batch)) {
+                TickType_t _now = xTaskGetTickCount();
+
+                // jump over the ticks without work, then start the next tick
+                m_tLastTick += m_wheelTimers.skip(_now - m_tLastTick);
+
+                if(m_tLastTick != _now) {
+                    m_wheelTimers.begin_advance();
+                    m_tLastTick++;
+                }
+                _done = (m_tLastTick == _now) && !m_wheelTimers.is_advancing();
+            }
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::run_batch
+    //-----------------------------------
+    void basic_timer_service::run_batch() {
+        for(;;) {
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+            basic_service_timer* _timer = m_pBatch;
+
+            if(_timer != NULL) {
+                unlink_batch(_timer);
+                m_pCurrent = _timer;
+            }
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+            if(_timer == NULL) break;
+
+            _timer->on_enter();
+            _timer->on_timer();
+            _timer->on_exit();
+
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+            m_uiFired++;
+
+            // not stopped and not started again in on_timer
+            if(_timer->m_bActive && !_timer->is_linked()) {
+                if(_timer->m_bIsOneShot)
+                    _timer->m_bActive = false;
+                else
+                    m_wheelTimers.insert(_timer, _timer->m_uiPeriod);
+            }
+            m_pCurrent = NULL;
+
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
+        }
+    }
+
+    //-----------------------------------
+    //  basic_timer_service::on_task
+    //-----------------------------------
+    int basic_timer_service::on_task() {
+        basic_task::on_task();
+
+        while ( is_running() ) {
+            sync_time();
+            run_batch();
+
+            portENTER_CRITICAL_SAFE(&m_muxWheel);
+
+            TickType_t _now = xTaskGetTickCount();
+            TickType_t _delay = portMAX_DELAY;
+
+            // sleep until the next tick that can expire a timer
+            if(!m_wheelTimers.empty()) {
+                TickType_t _next = m_wheelTimers.next_expire();
+                TickType_t _passed = _now - m_tLastTick;
+
+                _delay = (_next > _passed) ? _next - _passed : 0;
+            }
+            m_tWakeup = _now + _delay;
+
+            portEXIT_CRITICAL_SAFE(&m_muxWheel);
+
+            ulTaskNotifyTake(pdTRUE, _delay);
+        }
+        return ERR_TASK_OK;
+    }
+}